@@ -0,0 +1,50 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "jpegls_error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// <summary>
+/// Sets the process-wide allocator, used by the decoders and encoders that have no allocator of their own.
+/// </summary>
+/// <remarks>
+/// The function is not thread safe: it should be called before the other threads of the application use CharLS.
+/// The allocator must remain valid until all memory blocks it allocated are released.
+/// </remarks>
+/// <param name="allocator">The allocator to use, NULL restores the default allocator (operators new and delete).</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_set_allocator(CHARLS_IN_OPT const charls_allocator* allocator) CHARLS_NOEXCEPT;
+
+#ifdef __cplusplus
+}
+
+namespace charls {
+
+/// <summary>
+/// Sets the process-wide allocator, used by the decoders and encoders that have no allocator of their own.
+/// The function is not thread safe: it should be called before the other threads of the application use CharLS.
+/// </summary>
+/// <param name="allocator">The allocator to use, nullptr restores the default allocator.</param>
+/// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+inline void set_allocator(allocator* allocator)
+{
+    if (allocator)
+    {
+        const charls_allocator c_allocator{allocator->c_allocator()};
+        check_jpegls_errc(charls_set_allocator(&c_allocator));
+    }
+    else
+    {
+        check_jpegls_errc(charls_set_allocator(nullptr));
+    }
+}
+
+} // namespace charls
+
+#endif
@@ -12,6 +12,7 @@
 #define CHARLS_IN_OPT _In_opt_
 #define CHARLS_IN_Z _In_z_
 #define CHARLS_IN_READS_BYTES(size) _In_reads_bytes_(size)
+#define CHARLS_IN_OUT_UPDATES_OPT(count) _Inout_updates_opt_(count)
 #define CHARLS_OUT _Out_
 #define CHARLS_OUT_OPT _Out_opt_
 #define CHARLS_OUT_WRITES_BYTES(size) _Out_writes_bytes_(size)
@@ -34,6 +35,7 @@
 #define CHARLS_IN_OPT
 #define CHARLS_IN_Z
 #define CHARLS_IN_READS_BYTES(size)
+#define CHARLS_IN_OUT_UPDATES_OPT(count)
 #define CHARLS_OUT
 #define CHARLS_OUT_OPT
 #define CHARLS_OUT_WRITES_BYTES(size)
@@ -4,6 +4,7 @@
 #pragma once
 
 
+#include "allocator.h"
 #include "charls_jpegls_decoder.h"
 #include "charls_jpegls_encoder.h"
 #include "version.h"
@@ -20,6 +21,7 @@
 #undef CHARLS_C_VOID
 #undef CHARLS_IN
 #undef CHARLS_IN_OPT
+#undef CHARLS_IN_OUT_UPDATES_OPT
 #undef CHARLS_IN_Z
 #undef CHARLS_IN_READS_BYTES
 #undef CHARLS_OUT
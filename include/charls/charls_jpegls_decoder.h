@@ -55,6 +55,16 @@ charls_jpegls_decoder_set_source_buffer(CHARLS_IN charls_jpegls_decoder* decoder
                                         CHARLS_IN_READS_BYTES(source_size_bytes) const void* source_buffer,
                                         size_t source_size_bytes) CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull));
 
+/// <summary>
+/// Resets the decoder to its initial state, after which a new source buffer can be set.
+/// The options and callbacks are kept. The internal buffers of the previous image are reused: decoding a sequence of
+/// images with the same frame info and coding parameters doesn't require new memory allocations.
+/// </summary>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_reset(CHARLS_IN charls_jpegls_decoder* decoder) CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull));
+
 /// <summary>
 /// Tries to read the SPIFF header from the source buffer.
 /// If a SPIFF header exists its content will be put into the spiff_header parameter and header_found will be set to 1.
@@ -183,6 +193,107 @@ charls_jpegls_decoder_decode_to_buffer(CHARLS_IN charls_jpegls_decoder* decoder,
                                        size_t destination_size_bytes, uint32_t stride) CHARLS_NOEXCEPT
     CHARLS_ATTRIBUTE((nonnull));
 
+/// <summary>
+/// Returns the size required for the destination buffer in bytes to hold the decoded pixel data of a region.
+/// </summary>
+/// <remarks>
+/// Function should be called after calling the function charls_jpegls_decoder_read_header.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="region">The region of the image, should be inside the image.</param>
+/// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+/// <param name="destination_size_bytes">Output argument, will hold the required size when the function returns.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_get_region_destination_size(CHARLS_IN const charls_jpegls_decoder* decoder,
+                                                  CHARLS_IN const charls_region* region, uint32_t stride,
+                                                  CHARLS_OUT size_t* destination_size_bytes) CHARLS_NOEXCEPT
+    CHARLS_ATTRIBUTE((nonnull));
+
+/// <summary>
+/// Will decode a region of the image from the JPEG-LS byte stream into the destination buffer.
+/// </summary>
+/// <remarks>
+/// Function should be called after calling the function charls_jpegls_decoder_read_header.
+/// Only the lines up to the last line of the region are decoded: decoding starts at the restart interval that contains
+/// the first line of the region (if the image has restart markers) and stops after the last line of the region.
+/// The encoded data after the last line of the region is not validated: the end of the scan and the end of image marker
+/// are only checked when the region includes the last line of the image.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="region">The region of the image to decode, should be inside the image.</param>
+/// <param name="destination_buffer">Byte array that holds the decoded pixels of the region when the function returns.</param>
+/// <param name="destination_size_bytes">
+/// Length of the array in bytes. If the array is too small the function will return an error.
+/// </param>
+/// <param name="stride">
+/// Number of bytes to the next line in the buffer, when zero, decoder will compute it.
+/// </param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_ATTRIBUTE_ACCESS((access(write_only, 3, 4)))
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_decode_region_to_buffer(CHARLS_IN charls_jpegls_decoder* decoder, CHARLS_IN const charls_region* region,
+                                              CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
+                                              size_t destination_size_bytes, uint32_t stride) CHARLS_NOEXCEPT
+    CHARLS_ATTRIBUTE((nonnull));
+
+/// <summary>
+/// Locates all the restart intervals in the JPEG-LS byte stream. Restart intervals are independent work units:
+/// after this function they can be decoded individually, in any order and from multiple threads at the same time.
+/// </summary>
+/// <remarks>
+/// Function should be called after calling the function charls_jpegls_decoder_read_header.
+/// An image without restart markers has 1 restart interval per scan.
+/// After this function the complete image cannot be decoded anymore with charls_jpegls_decoder_decode_to_buffer.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="restart_interval_count">Output argument, will hold the number of restart intervals.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_read_restart_intervals(CHARLS_IN charls_jpegls_decoder* decoder,
+                                             CHARLS_OUT size_t* restart_interval_count) CHARLS_NOEXCEPT
+    CHARLS_ATTRIBUTE((nonnull));
+
+/// <summary>
+/// Returns the location and the lines of a restart interval.
+/// </summary>
+/// <remarks>
+/// Function should be called after calling the function charls_jpegls_decoder_read_restart_intervals.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="index">Index of the restart interval, the restart intervals are ordered by scan and line.</param>
+/// <param name="restart_interval_info">Output argument, will hold the information about the restart interval.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_get_restart_interval_info(CHARLS_IN const charls_jpegls_decoder* decoder, size_t index,
+                                                CHARLS_OUT charls_restart_interval_info* restart_interval_info)
+    CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull));
+
+/// <summary>
+/// Will decode the lines of 1 restart interval into the destination buffer.
+/// </summary>
+/// <remarks>
+/// Function should be called after calling the function charls_jpegls_decoder_read_restart_intervals.
+/// The function doesn't modify the decoder: different restart intervals can be decoded at the same time on different
+/// threads. The destination buffer needs room for line_count lines of the restart interval.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="index">Index of the restart interval.</param>
+/// <param name="destination_buffer">Byte array that holds the decoded lines when the function returns.</param>
+/// <param name="destination_size_bytes">
+/// Length of the array in bytes. If the array is too small the function will return an error.
+/// </param>
+/// <param name="stride">
+/// Number of bytes to the next line in the buffer, when zero, decoder will compute it.
+/// </param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_ATTRIBUTE_ACCESS((access(write_only, 3, 4)))
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_decode_restart_interval(CHARLS_IN const charls_jpegls_decoder* decoder, size_t index,
+                                              CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
+                                              size_t destination_size_bytes, uint32_t stride) CHARLS_NOEXCEPT
+    CHARLS_ATTRIBUTE((nonnull));
+
 /// <summary>
 /// Will install a function that will be called when a comment (COM) segment is found.
 /// </summary>
@@ -215,6 +326,68 @@ charls_jpegls_decoder_at_application_data(CHARLS_IN charls_jpegls_decoder* decod
                                           charls_at_application_data_handler handler, void* user_context) CHARLS_NOEXCEPT
     CHARLS_ATTRIBUTE((nonnull(1)));
 
+/// <summary>
+/// Sets the maximum number of threads the decoder may use to decode the pixel data. The default is 1.
+/// </summary>
+/// <remarks>
+/// Images encoded with interleave mode none and multiple components store every component in its own scan.
+/// Images encoded with restart markers consist of restart intervals that can be decoded independently.
+/// These scans and restart intervals are decoded at the same time when more than 1 thread is allowed.
+/// A single interleaved scan is decoded as a pipeline: a second thread converts the decoded lines to the output format.
+/// The decoded pixel data is identical to the data decoded with a single thread.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_set_thread_count(CHARLS_IN charls_jpegls_decoder* decoder, int32_t thread_count) CHARLS_NOEXCEPT
+    CHARLS_ATTRIBUTE((nonnull));
+
+/// <summary>
+/// Configures the executor that provides the additional threads when more than 1 thread is allowed.
+/// The default is the built-in thread pool.
+/// </summary>
+/// <remarks>
+/// The executor is copied, its submit function and user context must remain valid while the decoder is used.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="executor">The executor to use, NULL selects the built-in thread pool.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_set_executor(CHARLS_IN charls_jpegls_decoder* decoder, CHARLS_IN_OPT const charls_executor* executor)
+    CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull(1)));
+
+/// <summary>
+/// Configures the allocator that is used for the memory the decoder needs while it reads and writes images.
+/// The default is the process-wide allocator, see charls_set_allocator.
+/// </summary>
+/// <remarks>
+/// The allocator is copied, its functions and user context must remain valid while the decoder is used and until
+/// all memory blocks it allocated are released.
+/// </remarks>
+/// <param name="decoder">Reference to the decoder instance.</param>
+/// <param name="allocator">The allocator to use, NULL selects the process-wide allocator.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decoder_set_allocator(CHARLS_IN charls_jpegls_decoder* decoder, CHARLS_IN_OPT const charls_allocator* allocator)
+    CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull(1)));
+
+/// <summary>
+/// Decodes a batch of JPEG-LS encoded images, the images are distributed over a pool of threads.
+/// </summary>
+/// <remarks>
+/// Every item is decoded independently: the result of every item is stored in its result field.
+/// The function itself only fails when its arguments are invalid.
+/// </remarks>
+/// <param name="items">Array with the items to decode.</param>
+/// <param name="item_count">Number of items in the array.</param>
+/// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+/// <param name="executor">The executor that provides the additional threads, NULL selects the built-in thread pool.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_decode_batch(CHARLS_IN_OUT_UPDATES_OPT(item_count) charls_decode_batch_item* items, size_t item_count,
+                           int32_t thread_count, CHARLS_IN_OPT const charls_executor* executor) CHARLS_NOEXCEPT;
+
 
 // Note: The 3 methods below are considered obsolete and will be removed in the next major update.
 
@@ -307,6 +480,35 @@ class jpegls_decoder final
         return std::make_pair(decoder.frame_info(), decoder.interleave_mode());
     }
 
+    /// <summary>
+    /// Decodes a batch of JPEG-LS encoded images, the images are distributed over a pool of threads.
+    /// </summary>
+    /// <remarks>
+    /// Every item is decoded independently: the result of every item is stored in its result field.
+    /// </remarks>
+    /// <param name="items">Container with the items to decode.</param>
+    /// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    template<typename Container, typename T = typename Container::value_type>
+    static void decode_batch(Container& items, const int32_t thread_count = 0)
+    {
+        check_jpegls_errc(charls_jpegls_decode_batch(items.data(), items.size(), thread_count, nullptr));
+    }
+
+    /// <summary>
+    /// Decodes a batch of images, the images are distributed over the threads provided by the executor.
+    /// </summary>
+    /// <param name="items">Container with the items to decode.</param>
+    /// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+    /// <param name="executor">The executor that provides the additional threads.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    template<typename Container, typename T = typename Container::value_type>
+    static void decode_batch(Container& items, const int32_t thread_count, charls::executor& executor)
+    {
+        const charls_executor c_executor{executor.c_executor()};
+        check_jpegls_errc(charls_jpegls_decode_batch(items.data(), items.size(), thread_count, &c_executor));
+    }
+
     jpegls_decoder() = default;
 
     /// <summary>
@@ -379,6 +581,21 @@ class jpegls_decoder final
         return source(source_container.data(), source_container.size() * sizeof(typename Container::value_type));
     }
 
+    /// <summary>
+    /// Resets the decoder to its initial state, after which a new source can be set.
+    /// The options and handlers are kept. The internal buffers of the previous image are reused: decoding a sequence of
+    /// images with the same frame info and coding parameters doesn't require new memory allocations.
+    /// </summary>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    jpegls_decoder& reset()
+    {
+        check_jpegls_errc(charls_jpegls_decoder_reset(decoder_.get()));
+        spiff_header_has_value_ = false;
+        spiff_header_ = {};
+        frame_info_ = {};
+        return *this;
+    }
+
     /// <summary>
     /// Tries to read the SPIFF header from the JPEG-LS stream.
     /// If a SPIFF header exists its will be returned otherwise the struct will be filled with default values.
@@ -602,6 +819,136 @@ class jpegls_decoder final
         return destination;
     }
 
+    /// <summary>
+    /// Returns the size required for the destination buffer in bytes to hold the decoded pixel data of a region.
+    /// Function can be called after read_header.
+    /// </summary>
+    /// <param name="region">The region of the image, should be inside the image.</param>
+    /// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    /// <returns>The required size in bytes of the destination buffer.</returns>
+    CHARLS_CHECK_RETURN size_t destination_size(const charls::region& image_region, const uint32_t stride = 0) const
+    {
+        size_t size_in_bytes;
+        check_jpegls_errc(charls_jpegls_decoder_get_region_destination_size(decoder_.get(), &image_region, stride, &size_in_bytes));
+        return size_in_bytes;
+    }
+
+    /// <summary>
+    /// Will decode a region of the image into the destination buffer.
+    /// Decoding stops after the last line of the region, the encoded data after it is not validated.
+    /// </summary>
+    /// <param name="region">The region of the image to decode, should be inside the image.</param>
+    /// <param name="destination_buffer">Byte array that holds the decoded pixels of the region when the function returns.</param>
+    /// <param name="destination_size_bytes">
+    /// Length of the array in bytes. If the array is too small the function will return an error.
+    /// </param>
+    /// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    CHARLS_ATTRIBUTE_ACCESS((access(write_only, 3, 4)))
+    void decode_region(const charls::region& image_region, CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
+                       const size_t destination_size_bytes, const uint32_t stride = 0) const
+    {
+        check_jpegls_errc(charls_jpegls_decoder_decode_region_to_buffer(decoder_.get(), &image_region, destination_buffer,
+                                                                        destination_size_bytes, stride));
+    }
+
+    /// <summary>
+    /// Will decode a region of the image into the destination container.
+    /// </summary>
+    /// <param name="region">The region of the image to decode, should be inside the image.</param>
+    /// <param name="destination_container">
+    /// A STL like container that provides the functions data() and size() and the type value_type.
+    /// </param>
+    /// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    template<typename Container, typename T = typename Container::value_type>
+    void decode_region(const charls::region& image_region, CHARLS_OUT Container& destination_container,
+                       const uint32_t stride = 0) const
+    {
+        decode_region(image_region, destination_container.data(),
+                      destination_container.size() * sizeof(typename Container::value_type), stride);
+    }
+
+    /// <summary>
+    /// Will decode a region of the image and return a container with the decoded data.
+    /// </summary>
+    /// <param name="region">The region of the image to decode, should be inside the image.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    /// <returns>Container with the decoded data.</returns>
+    template<typename Container, typename T = typename Container::value_type>
+    CHARLS_CHECK_RETURN Container decode_region(const charls::region& image_region) const
+    {
+        Container destination(destination_size(image_region) / sizeof(typename Container::value_type));
+
+        decode_region(image_region, destination.data(), destination.size() * sizeof(typename Container::value_type));
+        return destination;
+    }
+
+    /// <summary>
+    /// Locates all the restart intervals in the JPEG-LS byte stream. After this call the restart intervals can be
+    /// decoded individually, in any order and from multiple threads at the same time.
+    /// Function can be called after read_header, the complete image cannot be decoded anymore afterwards.
+    /// </summary>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    /// <returns>The number of restart intervals.</returns>
+    size_t read_restart_intervals()
+    {
+        size_t restart_interval_count;
+        check_jpegls_errc(charls_jpegls_decoder_read_restart_intervals(decoder_.get(), &restart_interval_count));
+        return restart_interval_count;
+    }
+
+    /// <summary>
+    /// Returns the location and the lines of a restart interval.
+    /// Function can be called after read_restart_intervals.
+    /// </summary>
+    /// <param name="index">Index of the restart interval, the restart intervals are ordered by scan and line.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    /// <returns>The information about the restart interval.</returns>
+    CHARLS_CHECK_RETURN charls::restart_interval_info restart_interval_info(const size_t index) const
+    {
+        charls::restart_interval_info info;
+        check_jpegls_errc(charls_jpegls_decoder_get_restart_interval_info(decoder_.get(), index, &info));
+        return info;
+    }
+
+    /// <summary>
+    /// Will decode the lines of 1 restart interval into the destination buffer.
+    /// Different restart intervals can be decoded at the same time on different threads.
+    /// </summary>
+    /// <param name="index">Index of the restart interval.</param>
+    /// <param name="destination_buffer">Byte array that holds the decoded lines when the function returns.</param>
+    /// <param name="destination_size_bytes">
+    /// Length of the array in bytes. If the array is too small the function will return an error.
+    /// </param>
+    /// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    CHARLS_ATTRIBUTE_ACCESS((access(write_only, 3, 4)))
+    void decode_restart_interval(const size_t index, CHARLS_OUT_WRITES_BYTES(destination_size_bytes) void* destination_buffer,
+                                 const size_t destination_size_bytes, const uint32_t stride = 0) const
+    {
+        check_jpegls_errc(charls_jpegls_decoder_decode_restart_interval(decoder_.get(), index, destination_buffer,
+                                                                        destination_size_bytes, stride));
+    }
+
+    /// <summary>
+    /// Will decode the lines of 1 restart interval into the destination container.
+    /// </summary>
+    /// <param name="index">Index of the restart interval.</param>
+    /// <param name="destination_container">
+    /// A STL like container that provides the functions data() and size() and the type value_type.
+    /// </param>
+    /// <param name="stride">Number of bytes to the next line in the buffer, when zero, decoder will compute it.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    template<typename Container, typename T = typename Container::value_type>
+    void decode_restart_interval(const size_t index, CHARLS_OUT Container& destination_container,
+                                 const uint32_t stride = 0) const
+    {
+        decode_restart_interval(index, destination_container.data(),
+                                destination_container.size() * sizeof(typename Container::value_type), stride);
+    }
+
     /// <summary>
     /// Will install a function that will be called when a comment (COM) segment is found.
     /// </summary>
@@ -639,6 +986,49 @@ class jpegls_decoder final
         return *this;
     }
 
+    /// <summary>
+    /// Sets the maximum number of threads the decoder may use to decode the pixel data. The default is 1.
+    /// </summary>
+    /// <remarks>
+    /// Images encoded with interleave mode none and multiple components store every component in its own scan.
+    /// Images encoded with restart markers consist of restart intervals that can be decoded independently.
+    /// These scans and restart intervals are decoded at the same time when more than 1 thread is allowed.
+    /// A single interleaved scan is decoded as a pipeline: a second thread converts the decoded lines to the output format.
+    /// </remarks>
+    /// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    jpegls_decoder& thread_count(const int32_t thread_count)
+    {
+        check_jpegls_errc(charls_jpegls_decoder_set_thread_count(decoder_.get(), thread_count));
+        return *this;
+    }
+
+    /// <summary>
+    /// Configures the executor that provides the additional threads when more than 1 thread is allowed.
+    /// The default is the built-in thread pool.
+    /// </summary>
+    /// <param name="executor">The executor to use, the instance must remain valid while the decoder is used.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    jpegls_decoder& executor(charls::executor& executor)
+    {
+        const charls_executor c_executor{executor.c_executor()};
+        check_jpegls_errc(charls_jpegls_decoder_set_executor(decoder_.get(), &c_executor));
+        return *this;
+    }
+
+    /// <summary>
+    /// Configures the allocator that is used for the memory the decoder needs while it reads and writes images.
+    /// The default is the process-wide allocator.
+    /// </summary>
+    /// <param name="allocator">The allocator to use, the instance must remain valid while the decoder is used.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    jpegls_decoder& allocator(charls::allocator& allocator)
+    {
+        const charls_allocator c_allocator{allocator.c_allocator()};
+        check_jpegls_errc(charls_jpegls_decoder_set_allocator(decoder_.get(), &c_allocator));
+        return *this;
+    }
+
 private:
     CHARLS_CHECK_RETURN static charls_jpegls_decoder* create_decoder()
     {
@@ -110,6 +110,65 @@ charls_jpegls_encoder_set_color_transformation(CHARLS_IN charls_jpegls_encoder*
                                                charls_color_transformation color_transformation) CHARLS_NOEXCEPT
     CHARLS_ATTRIBUTE((nonnull));
 
+/// <summary>
+/// Configures the number of lines in a restart interval. The default is 0 (no restart intervals).
+/// </summary>
+/// <remarks>
+/// Restart intervals are independently encoded parts of a scan, separated by restart (RSTm) markers.
+/// They make it possible to encode and decode a single scan with multiple threads and limit the effect of damaged data.
+/// </remarks>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="restart_interval">The number of lines in a restart interval, 0 means no restart intervals.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_restart_interval(CHARLS_IN charls_jpegls_encoder* encoder,
+                                           uint32_t restart_interval) CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull));
+
+/// <summary>
+/// Configures the maximum number of threads the encoder may use to encode the pixel data. The default is 1.
+/// </summary>
+/// <remarks>
+/// With interleave mode none every component is encoded in its own scan.
+/// These scans and the restart intervals in the scans are encoded at the same time when more than 1 thread is allowed.
+/// A single interleaved scan is encoded as a pipeline: a second thread converts the source lines to the internal format.
+/// The encoded bytes are identical to the bytes encoded with a single thread.
+/// </remarks>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_thread_count(CHARLS_IN charls_jpegls_encoder* encoder, int32_t thread_count) CHARLS_NOEXCEPT
+    CHARLS_ATTRIBUTE((nonnull));
+
+/// <summary>
+/// Configures the executor that provides the additional threads when more than 1 thread is allowed.
+/// The default is the built-in thread pool.
+/// </summary>
+/// <remarks>
+/// The executor is copied, its submit function and user context must remain valid while the encoder is used.
+/// </remarks>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="executor">The executor to use, NULL selects the built-in thread pool.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_executor(CHARLS_IN charls_jpegls_encoder* encoder, CHARLS_IN_OPT const charls_executor* executor)
+    CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull(1)));
+
+/// <summary>
+/// Configures the allocator that is used for the memory the encoder needs while it reads and writes images.
+/// The default is the process-wide allocator, see charls_set_allocator.
+/// </summary>
+/// <remarks>
+/// The allocator is copied, its functions and user context must remain valid while the encoder is used and until
+/// all memory blocks it allocated are released.
+/// </remarks>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <param name="allocator">The allocator to use, NULL selects the process-wide allocator.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_allocator(CHARLS_IN charls_jpegls_encoder* encoder, CHARLS_IN_OPT const charls_allocator* allocator)
+    CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull(1)));
+
 /// <summary>
 /// Returns the size in bytes, that the encoder expects are needed to hold the encoded image.
 /// </summary>
@@ -267,6 +326,32 @@ charls_jpegls_encoder_get_bytes_written(CHARLS_IN const charls_jpegls_encoder* e
 CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
 charls_jpegls_encoder_rewind(CHARLS_IN charls_jpegls_encoder* encoder) CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull));
 
+/// <summary>
+/// Resets the encoder to its initial state, after which a new destination buffer can be set.
+/// The frame info and the other options are kept. The internal buffers of the previous image are reused: encoding a
+/// sequence of images with the same frame info and options doesn't require new memory allocations.
+/// </summary>
+/// <param name="encoder">Reference to the encoder instance.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_reset(CHARLS_IN charls_jpegls_encoder* encoder) CHARLS_NOEXCEPT CHARLS_ATTRIBUTE((nonnull));
+
+/// <summary>
+/// Encodes a batch of images, the images are distributed over a pool of threads.
+/// </summary>
+/// <remarks>
+/// Every item is encoded independently: the result and the number of written bytes of every item are stored in the item.
+/// The function itself only fails when its arguments are invalid.
+/// </remarks>
+/// <param name="items">Array with the items to encode.</param>
+/// <param name="item_count">Number of items in the array.</param>
+/// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+/// <param name="executor">The executor that provides the additional threads, NULL selects the built-in thread pool.</param>
+/// <returns>The result of the operation: success or a failure code.</returns>
+CHARLS_CHECK_RETURN CHARLS_API_IMPORT_EXPORT charls_jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encode_batch(CHARLS_IN_OUT_UPDATES_OPT(item_count) charls_encode_batch_item* items, size_t item_count,
+                           int32_t thread_count, CHARLS_IN_OPT const charls_executor* executor) CHARLS_NOEXCEPT;
+
 // Note: The method below is considered obsolete and will be removed in the next major update.
 
 /// <summary>
@@ -333,6 +418,35 @@ class jpegls_encoder final
         return destination;
     }
 
+    /// <summary>
+    /// Encodes a batch of images, the images are distributed over a pool of threads.
+    /// </summary>
+    /// <remarks>
+    /// Every item is encoded independently: the result and the number of written bytes of every item are stored in the item.
+    /// </remarks>
+    /// <param name="items">Container with the items to encode.</param>
+    /// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    template<typename Container, typename T = typename Container::value_type>
+    static void encode_batch(Container& items, const int32_t thread_count = 0)
+    {
+        check_jpegls_errc(charls_jpegls_encode_batch(items.data(), items.size(), thread_count, nullptr));
+    }
+
+    /// <summary>
+    /// Encodes a batch of images, the images are distributed over the threads provided by the executor.
+    /// </summary>
+    /// <param name="items">Container with the items to encode.</param>
+    /// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+    /// <param name="executor">The executor that provides the additional threads.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    template<typename Container, typename T = typename Container::value_type>
+    static void encode_batch(Container& items, const int32_t thread_count, charls::executor& executor)
+    {
+        const charls_executor c_executor{executor.c_executor()};
+        check_jpegls_errc(charls_jpegls_encode_batch(items.data(), items.size(), thread_count, &c_executor));
+    }
+
     /// <summary>
     /// Configures the frame that needs to be encoded.
     /// This information will be written to the Start of Frame (SOF) segment during the encode phase.
@@ -405,6 +519,57 @@ class jpegls_encoder final
         return *this;
     }
 
+    /// <summary>
+    /// Configures the number of lines in a restart interval. The default is 0 (no restart intervals).
+    /// </summary>
+    /// <param name="restart_interval">The number of lines in a restart interval, 0 means no restart intervals.</param>
+    jpegls_encoder& restart_interval(const uint32_t restart_interval)
+    {
+        check_jpegls_errc(charls_jpegls_encoder_set_restart_interval(encoder_.get(), restart_interval));
+        return *this;
+    }
+
+    /// <summary>
+    /// Configures the maximum number of threads the encoder may use to encode the pixel data. The default is 1.
+    /// </summary>
+    /// <remarks>
+    /// With interleave mode none every component is encoded in its own scan.
+    /// These scans and the restart intervals in the scans are encoded at the same time when more than 1 thread is allowed.
+    /// A single interleaved scan is encoded as a pipeline: a second thread converts the source lines to the internal format.
+    /// </remarks>
+    /// <param name="thread_count">The maximum number of threads, 0 means the number of available hardware threads.</param>
+    jpegls_encoder& thread_count(const int32_t thread_count)
+    {
+        check_jpegls_errc(charls_jpegls_encoder_set_thread_count(encoder_.get(), thread_count));
+        return *this;
+    }
+
+    /// <summary>
+    /// Configures the executor that provides the additional threads when more than 1 thread is allowed.
+    /// The default is the built-in thread pool.
+    /// </summary>
+    /// <param name="executor">The executor to use, the instance must remain valid while the encoder is used.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    jpegls_encoder& executor(charls::executor& executor)
+    {
+        const charls_executor c_executor{executor.c_executor()};
+        check_jpegls_errc(charls_jpegls_encoder_set_executor(encoder_.get(), &c_executor));
+        return *this;
+    }
+
+    /// <summary>
+    /// Configures the allocator that is used for the memory the encoder needs while it reads and writes images.
+    /// The default is the process-wide allocator.
+    /// </summary>
+    /// <param name="allocator">The allocator to use, the instance must remain valid while the encoder is used.</param>
+    /// <exception cref="charls::jpegls_error">An error occurred during the operation.</exception>
+    jpegls_encoder& allocator(charls::allocator& allocator)
+    {
+        const charls_allocator c_allocator{allocator.c_allocator()};
+        check_jpegls_errc(charls_jpegls_encoder_set_allocator(encoder_.get(), &c_allocator));
+        return *this;
+    }
+
     /// <summary>
     /// Returns the size in bytes, that the encoder expects are needed to hold the encoded image.
     /// </summary>
@@ -604,6 +769,16 @@ class jpegls_encoder final
         check_jpegls_errc(charls_jpegls_encoder_rewind(encoder_.get()));
     }
 
+    /// <summary>
+    /// Resets the encoder to its initial state, after which a new destination can be set.
+    /// The frame info and the other options are kept. The internal buffers of the previous image are reused: encoding
+    /// a sequence of images with the same frame info and options doesn't require new memory allocations.
+    /// </summary>
+    void reset() const
+    {
+        check_jpegls_errc(charls_jpegls_encoder_reset(encoder_.get()));
+    }
+
 private:
     CHARLS_CHECK_RETURN static charls_jpegls_encoder* create_encoder()
     {
@@ -67,6 +67,7 @@ enum charls_jpegls_errc
     CHARLS_JPEGLS_ERRC_INVALID_ARGUMENT_COLOR_TRANSFORMATION = 111,
     CHARLS_JPEGLS_ERRC_INVALID_ARGUMENT_STRIDE = 112,
     CHARLS_JPEGLS_ERRC_INVALID_ARGUMENT_ENCODING_OPTIONS = 113,
+    CHARLS_JPEGLS_ERRC_INVALID_ARGUMENT_SAMPLE_VALUE = 114,
     CHARLS_JPEGLS_ERRC_INVALID_PARAMETER_WIDTH = 200,
     CHARLS_JPEGLS_ERRC_INVALID_PARAMETER_HEIGHT = 201,
     CHARLS_JPEGLS_ERRC_INVALID_PARAMETER_COMPONENT_COUNT = 202,
@@ -88,7 +89,9 @@ enum charls_encoding_options
     CHARLS_ENCODING_OPTIONS_NONE = 0,
     CHARLS_ENCODING_OPTIONS_EVEN_DESTINATION_SIZE = 1,
     CHARLS_ENCODING_OPTIONS_INCLUDE_VERSION_NUMBER = 2,
-    CHARLS_ENCODING_OPTIONS_INCLUDE_PC_PARAMETERS_JAI = 4
+    CHARLS_ENCODING_OPTIONS_INCLUDE_PC_PARAMETERS_JAI = 4,
+    CHARLS_ENCODING_OPTIONS_INCLUDE_RESTART_MARKER_INDEX = 8,
+    CHARLS_ENCODING_OPTIONS_VALIDATE_SAMPLE_VALUES = 16
 };
 
 enum charls_color_transformation
@@ -383,6 +386,12 @@ enum class CHARLS_NO_DISCARD jpegls_errc
     /// </summary>
     invalid_argument_encoding_options = impl::CHARLS_JPEGLS_ERRC_INVALID_ARGUMENT_ENCODING_OPTIONS,
 
+    /// <summary>
+    /// The source contains a sample value that cannot be stored in bits per sample bits.
+    /// Only returned when the encoding option validate_sample_values is set.
+    /// </summary>
+    invalid_argument_sample_value = impl::CHARLS_JPEGLS_ERRC_INVALID_ARGUMENT_SAMPLE_VALUE,
+
     /// <summary>
     /// This error is returned when the stream contains a width parameter defined more then once or in an incompatible way.
     /// </summary>
@@ -503,7 +512,23 @@ enum class encoding_options : unsigned
     /// Most users of this codec are aware of this problem and have implemented a work-around.
     /// This option is default enabled. Will not be default enabled in the next major version upgrade.
     /// </summary>
-    include_pc_parameters_jai = impl::CHARLS_ENCODING_OPTIONS_INCLUDE_PC_PARAMETERS_JAI
+    include_pc_parameters_jai = impl::CHARLS_ENCODING_OPTIONS_INCLUDE_PC_PARAMETERS_JAI,
+
+    /// <summary>
+    /// Writes before every scan an application data (APP9) segment with the byte offsets of the restart markers.
+    /// Decoders can use this index to start decoding at the restart interval that contains the first line of a region,
+    /// without scanning the preceding encoded data. Only used when a restart interval is defined.
+    /// This option is not default enabled.
+    /// </summary>
+    include_restart_marker_index = impl::CHARLS_ENCODING_OPTIONS_INCLUDE_RESTART_MARKER_INDEX,
+
+    /// <summary>
+    /// Checks that the sample values of the source can be stored in bits per sample bits. When a sample value uses
+    /// more bits, encoding fails with jpegls_errc::invalid_argument_sample_value.
+    /// Without this option the unused high bits of the samples are ignored.
+    /// This option is not default enabled.
+    /// </summary>
+    validate_sample_values = impl::CHARLS_ENCODING_OPTIONS_VALIDATE_SAMPLE_VALUES
 };
 
 constexpr encoding_options operator|(const encoding_options lhs, const encoding_options rhs) noexcept
@@ -977,6 +1002,168 @@ struct charls_jpegls_pc_parameters CHARLS_FINAL
 };
 
 
+/// <summary>
+/// Defines 1 JPEG-LS encoded image of a decode batch: the encoded source, the destination for the pixel data and
+/// the result of decoding the image.
+/// </summary>
+struct charls_decode_batch_item CHARLS_FINAL
+{
+    /// <summary>
+    /// Reference to the JPEG-LS encoded bytes.
+    /// </summary>
+    const void* source;
+
+    /// <summary>
+    /// Size of the encoded bytes.
+    /// </summary>
+    size_t source_size_bytes;
+
+    /// <summary>
+    /// Reference to the buffer that will hold the decoded pixel data.
+    /// </summary>
+    void* destination;
+
+    /// <summary>
+    /// Size of the destination buffer in bytes.
+    /// </summary>
+    size_t destination_size_bytes;
+
+    /// <summary>
+    /// Number of bytes to the next line in the destination buffer, when zero, the decoder will compute it.
+    /// </summary>
+    uint32_t stride;
+
+    /// <summary>
+    /// Output: the result of decoding this item: success or a failure code.
+    /// </summary>
+    charls_jpegls_errc result;
+};
+
+
+/// <summary>
+/// Defines 1 image of an encode batch: the pixel data, how it should be encoded, the destination for the encoded
+/// bytes and the result of encoding the image.
+/// </summary>
+struct charls_encode_batch_item CHARLS_FINAL
+{
+    /// <summary>
+    /// Reference to the pixel data that should be encoded.
+    /// </summary>
+    const void* source;
+
+    /// <summary>
+    /// Size of the pixel data in bytes.
+    /// </summary>
+    size_t source_size_bytes;
+
+    /// <summary>
+    /// Number of bytes to the next line in the source buffer, when zero, the encoder will compute it.
+    /// </summary>
+    uint32_t stride;
+
+    /// <summary>
+    /// Information about the frame of the image.
+    /// </summary>
+    struct charls_frame_info frame_info;
+
+    /// <summary>
+    /// The interleave mode of the pixel data and of the encoded JPEG-LS stream.
+    /// </summary>
+    charls_interleave_mode interleave_mode;
+
+    /// <summary>
+    /// The allowed lossy error. 0 means lossless.
+    /// </summary>
+    int32_t near_lossless;
+
+    /// <summary>
+    /// Reference to the buffer that will hold the encoded bytes.
+    /// </summary>
+    void* destination;
+
+    /// <summary>
+    /// Size of the destination buffer in bytes.
+    /// </summary>
+    size_t destination_size_bytes;
+
+    /// <summary>
+    /// Output: the number of bytes written to the destination buffer.
+    /// </summary>
+    size_t bytes_written;
+
+    /// <summary>
+    /// Output: the result of encoding this item: success or a failure code.
+    /// </summary>
+    charls_jpegls_errc result;
+};
+
+
+/// <summary>
+/// Describes 1 restart interval of an encoded JPEG-LS image: the location of its entropy coded data and the lines
+/// it contains. Restart intervals don't depend on each other and can be decoded independently.
+/// </summary>
+struct charls_restart_interval_info CHARLS_FINAL
+{
+    /// <summary>
+    /// Offset in bytes of the entropy coded data of the restart interval, relative to the start of the source buffer.
+    /// </summary>
+    size_t source_offset;
+
+    /// <summary>
+    /// Size in bytes of the entropy coded data of the restart interval, the terminating marker is not included.
+    /// </summary>
+    size_t source_size_bytes;
+
+    /// <summary>
+    /// Index of the scan that contains the restart interval. When the interleave mode is none, every component is
+    /// encoded in its own scan and the scan index is also the component index.
+    /// </summary>
+    uint32_t scan_index;
+
+    /// <summary>
+    /// Index of the first line of the image that is contained in the restart interval.
+    /// </summary>
+    uint32_t first_line;
+
+    /// <summary>
+    /// Number of lines that are contained in the restart interval.
+    /// </summary>
+    uint32_t line_count;
+
+    /// <summary>
+    /// Number of components that are contained in every line: 1 when the interleave mode is none.
+    /// </summary>
+    int32_t component_count;
+};
+
+
+/// <summary>
+/// Defines a rectangular region of an image, used to decode only a part of an image.
+/// </summary>
+struct charls_region CHARLS_FINAL
+{
+    /// <summary>
+    /// Index of the first column of the region.
+    /// </summary>
+    uint32_t x;
+
+    /// <summary>
+    /// Index of the first line of the region.
+    /// </summary>
+    uint32_t y;
+
+    /// <summary>
+    /// Number of columns of the region, range [1, width of the image - x].
+    /// </summary>
+    uint32_t width;
+
+    /// <summary>
+    /// Number of lines of the region, range [1, height of the image - y].
+    /// </summary>
+    uint32_t height;
+};
+
+
 /// <summary>
 /// Defines the JPEG-LS preset coding parameters as defined in ISO/IEC 14495-1, C.2.4.1.1.
 /// JPEG-LS defines a default set of parameters, but custom parameters can be used.
@@ -1174,6 +1361,10 @@ namespace charls {
 using spiff_header = charls_spiff_header;
 using frame_info = charls_frame_info;
 using jpegls_pc_parameters = charls_jpegls_pc_parameters;
+using decode_batch_item = charls_decode_batch_item;
+using encode_batch_item = charls_encode_batch_item;
+using restart_interval_info = charls_restart_interval_info;
+using region = charls_region;
 using at_comment_handler = charls_at_comment_handler;
 using at_application_data_handler = charls_at_application_data_handler;
 
@@ -1193,8 +1384,202 @@ typedef int32_t(CHARLS_API_CALLING_CONVENTION* charls_at_application_data_handle
 typedef struct charls_spiff_header charls_spiff_header;
 typedef struct charls_frame_info charls_frame_info;
 typedef struct charls_jpegls_pc_parameters charls_jpegls_pc_parameters;
+typedef struct charls_decode_batch_item charls_decode_batch_item;
+typedef struct charls_encode_batch_item charls_encode_batch_item;
+typedef struct charls_restart_interval_info charls_restart_interval_info;
+typedef struct charls_region charls_region;
 
 typedef struct JlsParameters JlsParameters;
 typedef struct JlsRect JlsRect;
 
 #endif
+
+
+/// <summary>
+/// Function definition for a task that is submitted to an executor.
+/// </summary>
+/// <param name="task_context">The context information that was passed together with the task.</param>
+typedef void(CHARLS_API_CALLING_CONVENTION* charls_executor_task)(void* task_context);
+
+/// <summary>
+/// Defines an executor: an object that can execute the tasks of CharLS on threads that are owned by the application.
+/// When no executor is configured, CharLS uses its own thread pool, which is started when it is needed for the first time.
+/// </summary>
+/// <remarks>
+/// CharLS will always execute a part of the work on the calling thread and only submits additional tasks when
+/// more than 1 thread is allowed. It doesn't depend on the submitted tasks being started soon: when they start late,
+/// they return directly.
+/// </remarks>
+struct charls_executor CHARLS_FINAL
+{
+    /// <summary>
+    /// Function that submits a task to the executor.
+    /// When the function returns 0, the task is accepted and the executor must call it exactly once, on any thread.
+    /// When the function returns a non-zero value the task is not accepted and CharLS will execute the work itself.
+    /// </summary>
+    int32_t(CHARLS_API_CALLING_CONVENTION* submit)(charls_executor_task task, void* task_context, void* user_context);
+
+    /// <summary>
+    /// Free to use context information that will be passed to the submit function.
+    /// </summary>
+    void* user_context;
+};
+
+#ifdef __cplusplus
+
+namespace charls {
+
+using executor_task = charls_executor_task;
+
+/// <summary>
+/// Base class for an executor implemented in C++. The instance must remain valid while it is used by CharLS.
+/// </summary>
+class executor
+{
+public:
+    executor() = default;
+    virtual ~executor() = default;
+
+    executor(const executor&) = delete;
+    executor(executor&&) = delete;
+    executor& operator=(const executor&) = delete;
+    executor& operator=(executor&&) = delete;
+
+    /// <summary>
+    /// Submits a task: the implementation must call task(task_context) exactly once, on any thread.
+    /// Throwing an exception means the task is not accepted.
+    /// </summary>
+    /// <param name="task">The task that needs to be executed.</param>
+    /// <param name="task_context">The context information that must be passed to the task.</param>
+    virtual void submit(executor_task task, void* task_context) = 0;
+
+    /// <summary>
+    /// Returns the C executor struct that forwards the tasks to this instance.
+    /// </summary>
+    charls_executor c_executor() noexcept
+    {
+        return {&submit_callback, this};
+    }
+
+private:
+    static int32_t CHARLS_API_CALLING_CONVENTION submit_callback(const executor_task task, void* task_context,
+                                                                 void* user_context) noexcept
+    {
+        try
+        {
+            static_cast<executor*>(user_context)->submit(task, task_context);
+            return 0;
+        }
+        catch (...)
+        {
+            return 1;
+        }
+    }
+};
+
+} // namespace charls
+
+#else
+
+typedef struct charls_executor charls_executor;
+
+#endif
+
+
+/// <summary>
+/// Defines an allocator: the functions that CharLS uses to allocate and release its internal memory.
+/// When no allocator is configured, CharLS uses the C++ operators new and delete.
+/// </summary>
+/// <remarks>
+/// The memory blocks remember the allocator that allocated them: a block is always released with the deallocate
+/// function of the allocator that allocated it, on any thread.
+/// The built-in thread pool and the lookup tables that are shared by all decoders and encoders of the process don't use
+/// the allocator. An executor can be used to control the allocations of the threads.
+/// </remarks>
+struct charls_allocator CHARLS_FINAL
+{
+    /// <summary>
+    /// Function that allocates a memory block of size bytes, aligned for any fundamental type (like malloc).
+    /// Returns a null pointer when the memory cannot be allocated.
+    /// </summary>
+    void*(CHARLS_API_CALLING_CONVENTION* allocate)(size_t size, void* user_context);
+
+    /// <summary>
+    /// Function that releases a memory block, size is the size that was passed to the allocate function.
+    /// </summary>
+    void(CHARLS_API_CALLING_CONVENTION* deallocate)(void* memory, size_t size, void* user_context);
+
+    /// <summary>
+    /// Free to use context information that will be passed to the allocate and deallocate functions.
+    /// </summary>
+    void* user_context;
+};
+
+#ifdef __cplusplus
+
+namespace charls {
+
+/// <summary>
+/// Base class for an allocator implemented in C++. The instance must remain valid until all memory blocks it allocated
+/// are released: until the encoders and decoders that use it are destroyed.
+/// </summary>
+class allocator
+{
+public:
+    allocator() = default;
+    virtual ~allocator() = default;
+
+    allocator(const allocator&) = delete;
+    allocator(allocator&&) = delete;
+    allocator& operator=(const allocator&) = delete;
+    allocator& operator=(allocator&&) = delete;
+
+    /// <summary>
+    /// Allocates a memory block, aligned for any fundamental type.
+    /// Throwing an exception or returning a null pointer means the memory cannot be allocated.
+    /// </summary>
+    /// <param name="size">The size of the memory block in bytes.</param>
+    virtual void* allocate(size_t size) = 0;
+
+    /// <summary>
+    /// Releases a memory block that was returned by allocate.
+    /// </summary>
+    /// <param name="memory">The memory block to release.</param>
+    /// <param name="size">The size that was passed to allocate.</param>
+    virtual void deallocate(void* memory, size_t size) noexcept = 0;
+
+    /// <summary>
+    /// Returns the C allocator struct that forwards the calls to this instance.
+    /// </summary>
+    charls_allocator c_allocator() noexcept
+    {
+        return {&allocate_callback, &deallocate_callback, this};
+    }
+
+private:
+    static void* CHARLS_API_CALLING_CONVENTION allocate_callback(const size_t size, void* user_context) noexcept
+    {
+        try
+        {
+            return static_cast<allocator*>(user_context)->allocate(size);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+
+    static void CHARLS_API_CALLING_CONVENTION deallocate_callback(void* memory, const size_t size,
+                                                                  void* user_context) noexcept
+    {
+        static_cast<allocator*>(user_context)->deallocate(memory, size);
+    }
+};
+
+} // namespace charls
+
+#else
+
+typedef struct charls_allocator charls_allocator;
+
+#endif
@@ -2,7 +2,9 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include "charls/charls_jpegls_decoder.h"
+#include "internal_allocator.h"
 #include "jpeg_stream_reader.h"
+#include "parallel_for.h"
 #include "util.h"
 
 #include <memory>
@@ -10,7 +12,7 @@
 
 using namespace charls;
 
-struct charls_jpegls_decoder final
+struct charls_jpegls_decoder final : internal_object
 {
     void source(const const_byte_span source)
     {
@@ -21,10 +23,17 @@ struct charls_jpegls_decoder final
         state_ = state::source_set;
     }
 
+    void reset() noexcept
+    {
+        reader_.reset();
+        state_ = state::initial;
+    }
+
     bool read_header(CHARLS_OUT spiff_header* spiff_header)
     {
         check_operation(state_ == state::source_set);
 
+        const allocator_scope scope{&allocator_};
         bool spiff_header_found{};
         reader_.read_header(spiff_header, &spiff_header_found);
         state_ = spiff_header_found ? state::spiff_header_read : state::spiff_header_not_found;
@@ -38,6 +47,7 @@ struct charls_jpegls_decoder final
 
         if (state_ != state::spiff_header_not_found)
         {
+            const allocator_scope scope{&allocator_};
             reader_.read_header();
         }
 
@@ -82,27 +92,34 @@ struct charls_jpegls_decoder final
     size_t destination_size(const size_t stride) const
     {
         const charls::frame_info info{frame_info()};
+        return destination_size({0, 0, info.width, info.height}, stride);
+    }
+
+    size_t destination_size(const charls::region& image_region, const size_t stride) const
+    {
+        const charls::frame_info info{frame_info()};
+        check_region(image_region);
 
         if (stride == auto_calculate_stride)
         {
-            return checked_mul(checked_mul(checked_mul(info.component_count, info.height), info.width),
+            return checked_mul(checked_mul(checked_mul(info.component_count, image_region.height), image_region.width),
                 bit_to_byte_count(info.bits_per_sample));
         }
 
         switch (interleave_mode())
         {
         case charls::interleave_mode::none: {
-            const size_t minimum_stride{static_cast<size_t>(info.width) * bit_to_byte_count(info.bits_per_sample)};
+            const size_t minimum_stride{static_cast<size_t>(image_region.width) * bit_to_byte_count(info.bits_per_sample)};
             check_argument(stride >= minimum_stride, jpegls_errc::invalid_argument_stride);
-            return checked_mul(checked_mul(stride, info.component_count), info.height) - (stride - minimum_stride);
+            return checked_mul(checked_mul(stride, info.component_count), image_region.height) - (stride - minimum_stride);
         }
 
         case charls::interleave_mode::line:
         case charls::interleave_mode::sample: {
-            const size_t minimum_stride{static_cast<size_t>(info.width) * info.component_count *
+            const size_t minimum_stride{static_cast<size_t>(image_region.width) * info.component_count *
                                         bit_to_byte_count(info.bits_per_sample)};
             check_argument(stride >= minimum_stride, jpegls_errc::invalid_argument_stride);
-            return checked_mul(stride, info.height) - (stride - minimum_stride);
+            return checked_mul(stride, image_region.height) - (stride - minimum_stride);
         }
         }
 
@@ -125,12 +142,58 @@ struct charls_jpegls_decoder final
         check_argument(destination.data || destination.size == 0);
         check_operation(state_ == state::header_read);
 
+        const allocator_scope scope{&allocator_};
         reader_.decode(destination, stride);
-        reader_.read_end_of_image();
+
+        // Decoding stops after the last line of a region: the remaining encoded data and the EOI marker are not read.
+        if (!reader_.stopped_after_region())
+        {
+            reader_.read_end_of_image();
+        }
 
         state_ = state::completed;
     }
 
+    void decode_region(const charls::region& image_region, const byte_span destination, const size_t stride)
+    {
+        check_operation(state_ == state::header_read);
+        check_region(image_region);
+
+        reader_.rect({static_cast<int32_t>(image_region.x), static_cast<int32_t>(image_region.y),
+                      static_cast<int32_t>(image_region.width), static_cast<int32_t>(image_region.height)});
+        decode(destination, stride);
+    }
+
+    size_t read_restart_intervals()
+    {
+        check_operation(state_ == state::header_read);
+
+        const allocator_scope scope{&allocator_};
+        reader_.read_restart_intervals();
+        reader_.read_end_of_image();
+
+        state_ = state::restart_intervals_read;
+        return reader_.restart_interval_count();
+    }
+
+    charls::restart_interval_info restart_interval_info(const size_t index) const
+    {
+        check_operation(state_ == state::restart_intervals_read);
+        check_argument(index < reader_.restart_interval_count());
+
+        return reader_.restart_interval_info(index);
+    }
+
+    void decode_restart_interval(const size_t index, const byte_span destination, const size_t stride) const
+    {
+        check_argument(destination.data || destination.size == 0);
+        check_operation(state_ == state::restart_intervals_read);
+        check_argument(index < reader_.restart_interval_count());
+
+        const allocator_scope scope{&allocator_};
+        reader_.decode_restart_interval(index, destination, stride);
+    }
+
     void output_bgr(const bool value) noexcept
     {
         reader_.output_bgr(value);
@@ -141,7 +204,33 @@ struct charls_jpegls_decoder final
         reader_.rect(rect);
     }
 
+    void thread_count(const int32_t thread_count)
+    {
+        check_argument(thread_count >= 0);
+
+        reader_.thread_count(static_cast<uint32_t>(thread_count));
+    }
+
+    void executor(const charls_executor* executor) noexcept
+    {
+        reader_.executor(executor ? *executor : charls_executor{});
+    }
+
+    void allocator(const charls_allocator* allocator)
+    {
+        check_argument(!allocator || (allocator->allocate && allocator->deallocate));
+        allocator_ = allocator ? *allocator : charls_allocator{};
+    }
+
 private:
+    void check_region(const charls::region& image_region) const
+    {
+        const charls::frame_info info{frame_info()};
+        check_argument(image_region.width > 0 && image_region.height > 0 && image_region.x < info.width &&
+                       image_region.width <= info.width - image_region.x && image_region.y < info.height &&
+                       image_region.height <= info.height - image_region.y);
+    }
+
     enum class state
     {
         initial,
@@ -149,13 +238,33 @@ struct charls_jpegls_decoder final
         spiff_header_read,
         spiff_header_not_found,
         header_read,
+        restart_intervals_read,
         completed
     };
 
     state state_{};
+    charls_allocator allocator_{};
     jpeg_stream_reader reader_;
 };
 
+namespace {
+
+jpegls_errc decode_item(const charls_decode_batch_item& item) noexcept
+try
+{
+    charls_jpegls_decoder decoder;
+    decoder.source({item.source, item.source_size_bytes});
+    decoder.read_header();
+    decoder.decode({item.destination, item.destination_size_bytes}, item.stride);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+} // namespace
+
 
 extern "C" {
 
@@ -187,6 +296,19 @@ extern "C" {
     }
 
 
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+        charls_jpegls_decoder_reset(charls_jpegls_decoder* decoder) noexcept
+        try
+    {
+        check_pointer(decoder)->reset();
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
     USE_DECL_ANNOTATIONS charls_jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_read_spiff_header(
         charls_jpegls_decoder* const decoder, charls_spiff_header* spiff_header, int32_t* header_found) noexcept
         try
@@ -306,6 +428,77 @@ extern "C" {
     }
 
 
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_get_region_destination_size(
+        const charls_jpegls_decoder* decoder, const charls_region* region, const uint32_t stride,
+        size_t* destination_size_bytes) noexcept
+        try
+    {
+        check_pointer(destination_size_bytes);
+        *destination_size_bytes = check_pointer(decoder)->destination_size(*check_pointer(region), stride);
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+        charls_jpegls_decoder_decode_region_to_buffer(charls_jpegls_decoder* decoder, const charls_region* region,
+            void* destination_buffer, const size_t destination_size_bytes, const uint32_t stride) noexcept
+        try
+    {
+        check_pointer(decoder)->decode_region(*check_pointer(region), {destination_buffer, destination_size_bytes}, stride);
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+        charls_jpegls_decoder_read_restart_intervals(charls_jpegls_decoder* decoder, size_t* restart_interval_count) noexcept
+        try
+    {
+        check_pointer(restart_interval_count);
+        *restart_interval_count = check_pointer(decoder)->read_restart_intervals();
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_get_restart_interval_info(
+        const charls_jpegls_decoder* decoder, const size_t index, charls_restart_interval_info* restart_interval_info) noexcept
+        try
+    {
+        check_pointer(restart_interval_info);
+        *restart_interval_info = check_pointer(decoder)->restart_interval_info(index);
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+        charls_jpegls_decoder_decode_restart_interval(const charls_jpegls_decoder* decoder, const size_t index,
+            void* destination_buffer, const size_t destination_size_bytes, const uint32_t stride) noexcept
+        try
+    {
+        check_pointer(decoder)->decode_restart_interval(index, {destination_buffer, destination_size_bytes}, stride);
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
     USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION charls_jpegls_decoder_at_comment(
         charls_jpegls_decoder* decoder, const charls_at_comment_handler handler, void* user_context) noexcept
         try
@@ -332,6 +525,63 @@ extern "C" {
     }
 
 
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+        charls_jpegls_decoder_set_thread_count(charls_jpegls_decoder* decoder, const int32_t thread_count) noexcept
+        try
+    {
+        check_pointer(decoder)->thread_count(thread_count);
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+        charls_jpegls_decoder_set_executor(charls_jpegls_decoder* decoder, const charls_executor* executor) noexcept
+        try
+    {
+        check_pointer(decoder)->executor(executor);
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+        charls_jpegls_decoder_set_allocator(charls_jpegls_decoder* decoder, const charls_allocator* allocator) noexcept
+        try
+    {
+        check_pointer(decoder)->allocator(allocator);
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
+    USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+        charls_jpegls_decode_batch(charls_decode_batch_item* items, const size_t item_count, const int32_t thread_count,
+            const charls_executor* executor) noexcept
+        try
+    {
+        check_argument(items || item_count == 0);
+        check_argument(thread_count >= 0);
+
+        parallel_for(item_count, static_cast<uint32_t>(thread_count), executor ? *executor : charls_executor{},
+                     [items](const size_t index) noexcept { items[index].result = decode_item(items[index]); });
+        return jpegls_errc::success;
+    }
+    catch (...)
+    {
+        return to_jpegls_errc();
+    }
+
+
     USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION JpegLsReadHeader(const void* source,
         const size_t source_length,
         JlsParameters* params,
@@ -4,12 +4,17 @@
 #include "charls/charls_jpegls_encoder.h"
 #include "charls/version.h"
 #include "encoder_strategy.h"
+#include "internal_allocator.h"
 #include "jls_codec_factory.h"
 #include "jpeg_stream_writer.h"
 #include "jpegls_preset_coding_parameters.h"
+#include "parallel_for.h"
+#include "pipelined_process_line.h"
 #include "util.h"
 
+#include <algorithm>
 #include <new>
+#include <vector>
 
 using namespace charls;
 using impl::throw_jpegls_error;
@@ -24,7 +29,7 @@ constexpr bool has_option(encoding_options options, encoding_options option_to_t
 
 }}
 
-struct charls_jpegls_encoder final
+struct charls_jpegls_encoder final : internal_object
 {
     void destination(const byte_span destination)
     {
@@ -67,7 +72,9 @@ struct charls_jpegls_encoder final
     {
         constexpr charls::encoding_options all_options = encoding_options::even_destination_size |
                                                          encoding_options::include_version_number |
-                                                         encoding_options::include_pc_parameters_jai;
+                                                         encoding_options::include_pc_parameters_jai |
+                                                         encoding_options::include_restart_marker_index |
+                                                         encoding_options::validate_sample_values;
         check_argument(encoding_options >= encoding_options::none && encoding_options <= all_options,
                        jpegls_errc::invalid_argument_encoding_options);
 
@@ -89,12 +96,37 @@ struct charls_jpegls_encoder final
         color_transformation_ = color_transformation;
     }
 
+    void restart_interval(const uint32_t restart_interval) noexcept
+    {
+        restart_interval_ = restart_interval;
+    }
+
+    void thread_count(const int32_t thread_count)
+    {
+        check_argument(thread_count >= 0);
+        thread_count_ = static_cast<uint32_t>(thread_count);
+    }
+
+    void executor(const charls_executor* executor) noexcept
+    {
+        executor_ = executor ? *executor : charls_executor{};
+    }
+
+    void allocator(const charls_allocator* allocator)
+    {
+        check_argument(!allocator || (allocator->allocate && allocator->deallocate));
+        allocator_ = allocator ? *allocator : charls_allocator{};
+    }
+
     size_t estimated_destination_size() const
     {
         check_operation(is_frame_info_configured());
-        return checked_mul(checked_mul(checked_mul(frame_info_.width, frame_info_.height), frame_info_.component_count),
-                           bit_to_byte_count(frame_info_.bits_per_sample)) +
-               1024 + spiff_header_size_in_bytes;
+        const size_t entropy_coded_data_size{
+            restart_interval_ == 0
+                ? checked_mul(checked_mul(checked_mul(frame_info_.width, frame_info_.height), frame_info_.component_count),
+                              bit_to_byte_count(frame_info_.bits_per_sample))
+                : restart_intervals_size()};
+        return entropy_coded_data_size + 1024 + spiff_header_size_in_bytes + restart_marker_index_size();
     }
 
     void write_spiff_header(const spiff_header& spiff_header)
@@ -162,6 +194,8 @@ struct charls_jpegls_encoder final
         check_operation(is_frame_info_configured() && state_ != state::initial);
         check_interleave_mode_against_component_count();
 
+        const allocator_scope scope{&allocator_};
+
         const int32_t maximum_sample_value{calculate_maximum_sample_value(frame_info_.bits_per_sample)};
         if (UNLIKELY(
                 !is_valid(user_preset_coding_parameters_, maximum_sample_value, near_lossless_, &preset_coding_parameters_)))
@@ -200,13 +234,22 @@ struct charls_jpegls_encoder final
             writer_.write_jpegls_preset_parameters_segment(preset_coding_parameters_);
         }
 
-        if (interleave_mode_ == charls::interleave_mode::none)
+        if (restart_interval_ != 0)
+        {
+            writer_.write_define_restart_interval_segment(restart_interval_);
+        }
+
+        if (thread_count_ != 1 && scan_count() * restart_interval_count() > 1)
+        {
+            encode_in_parallel(source, stride);
+        }
+        else if (interleave_mode_ == charls::interleave_mode::none)
         {
             const size_t byte_count_component{stride * frame_info_.height};
             const int32_t last_component{frame_info_.component_count - 1};
             for (int32_t component{}; component != frame_info_.component_count; ++component)
             {
-                writer_.write_start_of_scan_segment(1, near_lossless_, interleave_mode_);
+                write_start_of_scan_segment(1);
                 encode_scan(source, stride, 1);
 
                 // Synchronize the source stream (encode_scan works on a local copy)
@@ -218,10 +261,11 @@ struct charls_jpegls_encoder final
         }
         else
         {
-            writer_.write_start_of_scan_segment(frame_info_.component_count, near_lossless_, interleave_mode_);
+            write_start_of_scan_segment(frame_info_.component_count);
             encode_scan(source, stride, frame_info_.component_count);
         }
 
+        writer_.complete_restart_marker_index();
         writer_.write_end_of_image(has_option(encoding_options::even_destination_size));
         state_ = state::completed;
     }
@@ -240,6 +284,12 @@ struct charls_jpegls_encoder final
         state_ = state::destination_set;
     }
 
+    void reset() noexcept
+    {
+        writer_.rewind();
+        state_ = state::initial;
+    }
+
 private:
     enum class state
     {
@@ -256,17 +306,197 @@ struct charls_jpegls_encoder final
     }
 
     void encode_scan(const byte_span source, const size_t stride, const int32_t component_count)
+    {
+        const size_t bytes_written{encode_scan(source, stride, component_count, writer_.remaining_destination())};
+
+        // Synchronize the destination encapsulated in the writer (encode_scan works on a local copy)
+        writer_.seek(bytes_written);
+    }
+
+    size_t encode_scan(const byte_span source, const size_t stride, const int32_t component_count,
+                       const byte_span destination)
+    {
+        const charls::frame_info frame_info{frame_info_.width, frame_info_.height, frame_info_.bits_per_sample,
+                                            component_count};
+
+        // The scan cannot be split: use the additional thread to convert the source lines to the internal format.
+        // The codec of a pipelined scan is not kept, as its process_line references the additional thread.
+        const bool pipelined_scan{thread_count_ != 1 && interleave_mode_ != charls::interleave_mode::none};
+        std::unique_ptr<encoder_strategy> pipelined_codec;
+        if (pipelined_scan)
+        {
+            pipelined_codec = jls_codec_factory<encoder_strategy>().create_codec(frame_info, scan_coding_parameters(),
+                                                                                 preset_coding_parameters_);
+        }
+        encoder_strategy& codec{pipelined_scan ? *pipelined_codec
+                                               : codec_cache_.get_codec(frame_info, scan_coding_parameters(),
+                                                                        preset_coding_parameters_)};
+        std::unique_ptr<process_line> process_line(codec.create_process_line(source, stride));
+
+        pipelined_process_line* pipeline{};
+        if (pipelined_scan)
+        {
+            auto pipelined{
+                std::make_unique<pipelined_process_line>(std::move(process_line), frame_info, interleave_mode_, executor_)};
+            pipeline = pipelined.get();
+            process_line = std::move(pipelined);
+        }
+
+        const size_t bytes_written{codec.encode_scan(std::move(process_line), destination)};
+        if (pipeline)
+        {
+            pipeline->complete();
+        }
+        return bytes_written;
+    }
+
+    size_t encode_restart_interval(const byte_span source, const size_t stride, const int32_t component_count,
+                                   const uint32_t interval_index, const byte_span destination) const
     {
         const charls::frame_info frame_info{frame_info_.width, frame_info_.height, frame_info_.bits_per_sample,
                                             component_count};
 
         const auto codec{jls_codec_factory<encoder_strategy>().create_codec(
-            frame_info, {near_lossless_, 0, interleave_mode_, color_transformation_, false}, preset_coding_parameters_)};
+            frame_info, scan_coding_parameters(),
+            preset_coding_parameters_)};
         std::unique_ptr<process_line> process_line(codec->create_process_line(source, stride));
-        const size_t bytes_written{codec->encode_scan(std::move(process_line), writer_.remaining_destination())};
+        return codec->encode_restart_interval(std::move(process_line), destination, interval_index);
+    }
 
-        // Synchronize the destination encapsulated in the writer (encode_scan works on a local copy)
-        writer_.seek(bytes_written);
+    charls::coding_parameters scan_coding_parameters() const noexcept
+    {
+        return {near_lossless_, restart_interval_, interleave_mode_, color_transformation_, false,
+                has_option(encoding_options::validate_sample_values)};
+    }
+
+    size_t restart_intervals_size() const
+    {
+        // The coding contexts are reset at the start of every restart interval: on noisy data an interval can need more
+        // bytes than its pixel data. Use the worst case: every sample is coded with the escape code (LIMIT + qbpp bits).
+        // Every restart marker is 2 bytes, the end of the restart interval before it can add 1 padding byte.
+        const size_t scan_component_count{
+            interleave_mode_ == charls::interleave_mode::none ? 1 : static_cast<size_t>(frame_info_.component_count)};
+        const size_t interval_sample_count{checked_mul(
+            checked_mul(frame_info_.width, std::min(lines_per_restart_interval(), frame_info_.height)), scan_component_count)};
+        const auto bit_count_per_sample{
+            static_cast<size_t>(compute_limit_parameter(frame_info_.bits_per_sample) + frame_info_.bits_per_sample)};
+        const size_t interval_size{(checked_mul(interval_sample_count, bit_count_per_sample) + 7) / 8 + 3};
+        return checked_mul(checked_mul(scan_count(), restart_interval_count()), interval_size);
+    }
+
+    bool include_restart_marker_index() const noexcept
+    {
+        // The offsets of all restart markers of a scan need to fit in 1 segment, otherwise the index is not written.
+        return has_option(encoding_options::include_restart_marker_index) && restart_interval_count() > 1 &&
+               restart_interval_count() - 1 <= maximum_restart_marker_index_count;
+    }
+
+    size_t restart_marker_index_size() const noexcept
+    {
+        // Every index is a segment (marker, length and tag) with 4 bytes per restart marker.
+        return include_restart_marker_index() ? scan_count() * (2 + 2 + 4 + ((restart_interval_count() - 1) * 4)) : 0;
+    }
+
+    void write_start_of_scan_segment(const int32_t component_count)
+    {
+        writer_.complete_restart_marker_index();
+        if (include_restart_marker_index())
+        {
+            writer_.write_restart_marker_index_segment(restart_interval_count() - 1);
+        }
+
+        writer_.write_start_of_scan_segment(component_count, near_lossless_, interleave_mode_);
+    }
+
+    size_t scan_count() const noexcept
+    {
+        return interleave_mode_ == charls::interleave_mode::none ? static_cast<size_t>(frame_info_.component_count) : 1;
+    }
+
+    uint32_t lines_per_restart_interval() const noexcept
+    {
+        return restart_interval_ == 0 ? frame_info_.height : restart_interval_;
+    }
+
+    size_t restart_interval_count() const noexcept
+    {
+        const uint32_t lines{lines_per_restart_interval()};
+        return frame_info_.height / lines + (frame_info_.height % lines == 0 ? 0 : 1);
+    }
+
+    void encode_in_parallel(const byte_span source, const size_t stride)
+    {
+        // Every restart interval of every scan is an independent encoding task.
+        // The first task is encoded directly into the destination, the other tasks into scratch buffers.
+        // When all tasks are encoded, the scratch buffers are copied in stream order, separated by the
+        // scan headers and restart markers.
+        const size_t interval_count{restart_interval_count()};
+        const size_t task_count{scan_count() * interval_count};
+        const int32_t scan_component_count{interleave_mode_ == charls::interleave_mode::none ? 1
+                                                                                             : frame_info_.component_count};
+        const size_t byte_count_component{stride * frame_info_.height};
+        const uint32_t lines_per_interval{lines_per_restart_interval()};
+
+        write_start_of_scan_segment(scan_component_count);
+        const byte_span first_task_destination{writer_.remaining_destination()};
+
+        // Most restart intervals are smaller than their pixel data, only when that is not the case the maximum size is needed.
+        const size_t interval_byte_count{checked_mul(
+            checked_mul(checked_mul(frame_info_.width, lines_per_interval), bit_to_byte_count(frame_info_.bits_per_sample)),
+            static_cast<uint32_t>(scan_component_count))};
+        const size_t initial_scratch_size{std::min(interval_byte_count + 1024, first_task_destination.size)};
+        internal_vector<internal_vector<uint8_t>> scratch_buffers(task_count - 1);
+        internal_vector<size_t> bytes_written(task_count);
+
+        parallel_for(task_count, thread_count_, executor_, [&](const size_t task) {
+            const size_t scan_index{task / interval_count};
+            const auto interval_index{static_cast<uint32_t>(task % interval_count)};
+
+            byte_span task_source{source};
+            skip_bytes(task_source,
+                       scan_index * byte_count_component + static_cast<size_t>(interval_index) * lines_per_interval * stride);
+
+            if (task == 0)
+            {
+                bytes_written[task] =
+                    encode_restart_interval(task_source, stride, scan_component_count, interval_index, first_task_destination);
+                return;
+            }
+
+            auto& scratch_buffer{scratch_buffers[task - 1]};
+            scratch_buffer.resize(initial_scratch_size);
+            try
+            {
+                bytes_written[task] = encode_restart_interval(task_source, stride, scan_component_count, interval_index,
+                                                              {scratch_buffer.data(), scratch_buffer.size()});
+            }
+            catch (const jpegls_error& error)
+            {
+                if (error.code() != jpegls_errc::destination_buffer_too_small ||
+                    scratch_buffer.size() == first_task_destination.size)
+                    throw;
+
+                scratch_buffer.resize(first_task_destination.size);
+                bytes_written[task] = encode_restart_interval(task_source, stride, scan_component_count, interval_index,
+                                                              {scratch_buffer.data(), scratch_buffer.size()});
+            }
+        });
+
+        writer_.seek(bytes_written[0]);
+        for (size_t task{1}; task != task_count; ++task)
+        {
+            const size_t interval_index{task % interval_count};
+            if (interval_index == 0)
+            {
+                write_start_of_scan_segment(scan_component_count);
+            }
+            else
+            {
+                writer_.write_restart_marker(static_cast<uint32_t>((interval_index - 1) % jpeg_restart_marker_range));
+            }
+
+            writer_.write_entropy_coded_data({scratch_buffers[task - 1].data(), bytes_written[task]});
+        }
     }
 
     size_t calculate_stride() const noexcept
@@ -339,13 +569,42 @@ struct charls_jpegls_encoder final
     int32_t near_lossless_{};
     charls::interleave_mode interleave_mode_{};
     charls::color_transformation color_transformation_{};
+    uint32_t restart_interval_{};
+    uint32_t thread_count_{1};
+    charls_executor executor_{};
+    charls_allocator allocator_{};
     charls::encoding_options encoding_options_{encoding_options::include_pc_parameters_jai};
     state state_{};
+    jls_codec_cache<encoder_strategy> codec_cache_;
     jpeg_stream_writer writer_;
     jpegls_pc_parameters user_preset_coding_parameters_{};
     jpegls_pc_parameters preset_coding_parameters_{};
 };
 
+namespace {
+
+jpegls_errc encode_item(charls_encode_batch_item& item) noexcept
+try
+{
+    item.bytes_written = 0;
+
+    charls_jpegls_encoder encoder;
+    encoder.destination({item.destination, item.destination_size_bytes});
+    encoder.frame_info(item.frame_info);
+    encoder.interleave_mode(item.interleave_mode);
+    encoder.near_lossless(item.near_lossless);
+    encoder.encode({item.source, item.source_size_bytes}, item.stride);
+
+    item.bytes_written = encoder.bytes_written();
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+} // namespace
+
 extern "C" {
 
 USE_DECL_ANNOTATIONS charls_jpegls_encoder* CHARLS_API_CALLING_CONVENTION charls_jpegls_encoder_create() noexcept
@@ -454,6 +713,58 @@ catch (...)
 }
 
 
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_restart_interval(charls_jpegls_encoder* encoder, const uint32_t restart_interval) noexcept
+try
+{
+    check_pointer(encoder)->restart_interval(restart_interval);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_thread_count(charls_jpegls_encoder* encoder, const int32_t thread_count) noexcept
+try
+{
+    check_pointer(encoder)->thread_count(thread_count);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_executor(charls_jpegls_encoder* encoder, const charls_executor* executor) noexcept
+try
+{
+    check_pointer(encoder)->executor(executor);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_set_allocator(charls_jpegls_encoder* encoder, const charls_allocator* allocator) noexcept
+try
+{
+    check_pointer(encoder)->allocator(allocator);
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
 USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
 charls_jpegls_encoder_get_estimated_destination_size(const charls_jpegls_encoder* encoder, size_t* size_in_bytes) noexcept
 try
@@ -590,6 +901,37 @@ catch (...)
 }
 
 
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encoder_reset(charls_jpegls_encoder* encoder) noexcept
+try
+{
+    check_pointer(encoder)->reset();
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_jpegls_encode_batch(charls_encode_batch_item* items, const size_t item_count, const int32_t thread_count,
+                           const charls_executor* executor) noexcept
+try
+{
+    check_argument(items || item_count == 0);
+    check_argument(thread_count >= 0);
+
+    parallel_for(item_count, static_cast<uint32_t>(thread_count), executor ? *executor : charls_executor{},
+                 [items](const size_t index) noexcept { items[index].result = encode_item(items[index]); });
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+
 USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
 JpegLsEncode(void* destination, const size_t destination_length, size_t* bytes_written, const void* source,
              const size_t source_length, const JlsParameters* params, char* error_message) noexcept
@@ -14,6 +14,7 @@ struct coding_parameters final
     charls::interleave_mode interleave_mode;
     color_transformation transformation;
     bool output_bgr;
+    bool validate_sample_values;
 };
 
 } // namespace charls
@@ -17,6 +17,7 @@ struct transform_none_impl
     static_assert(std::is_integral<T>::value, "Integral required.");
 
     using size_type = T;
+    static constexpr color_transformation transformation{color_transformation::none};
 
     FORCE_INLINE triplet<T> operator()(const int v1, const int v2, const int v3) const noexcept
     {
@@ -40,6 +41,7 @@ struct transform_hp1 final
     static_assert(std::is_integral<T>::value, "Integral required.");
 
     using size_type = T;
+    static constexpr color_transformation transformation{color_transformation::hp1};
 
     struct inverse final
     {
@@ -73,6 +75,7 @@ struct transform_hp2 final
     static_assert(std::is_integral<T>::value, "Integral required.");
 
     using size_type = T;
+    static constexpr color_transformation transformation{color_transformation::hp2};
 
     struct inverse final
     {
@@ -106,6 +109,7 @@ struct transform_hp3 final
     static_assert(std::is_integral<T>::value, "Integral required.");
 
     using size_type = T;
+    static constexpr color_transformation transformation{color_transformation::hp3};
 
     struct inverse final
     {
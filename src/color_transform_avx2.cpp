@@ -0,0 +1,199 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "color_transform_simd.h"
+
+#include "cpu_features.h"
+
+// Note: MSVC can generate AVX2 instructions without additional compiler options, other compilers need -mavx2.
+#if defined(__AVX2__) || (defined(CHARLS_X86_SIMD) && defined(_MSC_VER) && !defined(__clang__))
+#define CHARLS_AVX2_KERNELS
+#endif
+
+#ifdef CHARLS_AVX2_KERNELS
+
+#include "color_transform_simd_kernels.h"
+
+#include <immintrin.h>
+
+namespace charls {
+
+namespace {
+
+struct avx2_operations
+{
+    using vector = __m256i;
+
+    // The low 128-bit lane contains the first half of a block, the high lane the second half.
+    static constexpr size_t lane_size{sizeof(__m128i)};
+
+    static vector load(const uint8_t* source) noexcept
+    {
+        return _mm256_loadu_si256(static_cast<const vector*>(static_cast<const void*>(source)));
+    }
+
+    static void store(uint8_t* destination, const vector value) noexcept
+    {
+        _mm256_storeu_si256(static_cast<vector*>(static_cast<void*>(destination)), value);
+    }
+
+    static vector load_shuffle_mask(const int8_t* mask) noexcept
+    {
+        return _mm256_broadcastsi128_si256(_mm_load_si128(static_cast<const __m128i*>(static_cast<const void*>(mask))));
+    }
+
+    template<int ComponentCount>
+    static void load_interleaved(const uint8_t* source, const vector (&masks)[4][4], vector (&samples)[4]) noexcept
+    {
+        // Load the 2 halves of a block in the 2 lanes: the byte shuffle instruction cannot cross lanes.
+        vector registers[ComponentCount];
+        for (int i{}; i != ComponentCount; ++i)
+        {
+            registers[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(load_lane(source + i * lane_size)),
+                                                   load_lane(source + (ComponentCount + i) * lane_size), 1);
+        }
+
+        for (int component{}; component != ComponentCount; ++component)
+        {
+            vector value{_mm256_shuffle_epi8(registers[0], masks[component][0])};
+            for (int i{1}; i != ComponentCount; ++i)
+            {
+                value = _mm256_or_si256(value, _mm256_shuffle_epi8(registers[i], masks[component][i]));
+            }
+            samples[component] = value;
+        }
+    }
+
+    template<int ComponentCount>
+    static void store_interleaved(uint8_t* destination, const vector (&masks)[4][4],
+                                  const vector (&samples)[4]) noexcept
+    {
+        for (int i{}; i != ComponentCount; ++i)
+        {
+            vector value{_mm256_shuffle_epi8(samples[0], masks[i][0])};
+            for (int component{1}; component != ComponentCount; ++component)
+            {
+                value = _mm256_or_si256(value, _mm256_shuffle_epi8(samples[component], masks[i][component]));
+            }
+            store_lane(destination + i * lane_size, _mm256_castsi256_si128(value));
+            store_lane(destination + (ComponentCount + i) * lane_size, _mm256_extracti128_si256(value, 1));
+        }
+    }
+
+    static vector bit_and(const vector a, const vector b) noexcept
+    {
+        return _mm256_and_si256(a, b);
+    }
+
+    static vector bit_xor(const vector a, const vector b) noexcept
+    {
+        return _mm256_xor_si256(a, b);
+    }
+
+    static void complete() noexcept
+    {
+        // Prevents the performance penalty of mixing AVX and legacy SSE instructions in the calling code.
+        _mm256_zeroupper();
+    }
+
+private:
+    static __m128i load_lane(const uint8_t* source) noexcept
+    {
+        return _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(source)));
+    }
+
+    static void store_lane(uint8_t* destination, const __m128i value) noexcept
+    {
+        _mm_storeu_si128(static_cast<__m128i*>(static_cast<void*>(destination)), value);
+    }
+};
+
+
+template<typename SampleType>
+struct vector_operations;
+
+template<>
+struct vector_operations<uint8_t> final : avx2_operations
+{
+    using sample_type = uint8_t;
+    static constexpr size_t pixels_per_block{32};
+
+    static vector set1(const uint32_t value) noexcept
+    {
+        return _mm256_set1_epi8(static_cast<char>(value));
+    }
+
+    static vector add(const vector a, const vector b) noexcept
+    {
+        return _mm256_add_epi8(a, b);
+    }
+
+    static vector sub(const vector a, const vector b) noexcept
+    {
+        return _mm256_sub_epi8(a, b);
+    }
+
+    static vector shift_right_1(const vector a) noexcept
+    {
+        // There is no 8-bit shift instruction: shift 16-bit values and clear the bit shifted in from the next byte.
+        return _mm256_and_si256(_mm256_srli_epi16(a, 1), _mm256_set1_epi8(0x7F));
+    }
+};
+
+template<>
+struct vector_operations<uint16_t> final : avx2_operations
+{
+    using sample_type = uint16_t;
+    static constexpr size_t pixels_per_block{16};
+
+    static vector set1(const uint32_t value) noexcept
+    {
+        return _mm256_set1_epi16(static_cast<short>(value));
+    }
+
+    static vector add(const vector a, const vector b) noexcept
+    {
+        return _mm256_add_epi16(a, b);
+    }
+
+    static vector sub(const vector a, const vector b) noexcept
+    {
+        return _mm256_sub_epi16(a, b);
+    }
+
+    static vector shift_right_1(const vector a) noexcept
+    {
+        return _mm256_srli_epi16(a, 1);
+    }
+};
+
+} // namespace
+
+
+color_transform_kernel select_color_transform_kernel_avx2(const color_transformation transformation, const bool inverse,
+                                                           const int32_t component_count, const size_t bytes_per_sample,
+                                                           const sample_layout source_layout,
+                                                           const sample_layout destination_layout) noexcept
+{
+    return simd::select_kernel<vector_operations>(transformation, inverse, component_count, bytes_per_sample,
+                                                  source_layout, destination_layout);
+}
+
+} // namespace charls
+
+#else
+
+namespace charls {
+
+color_transform_kernel select_color_transform_kernel_avx2(color_transformation /* transformation */,
+                                                           bool /* inverse */, int32_t /* component_count */,
+                                                           size_t /* bytes_per_sample */,
+                                                           sample_layout /* source_layout */,
+                                                           sample_layout /* destination_layout */) noexcept
+{
+    return nullptr;
+}
+
+} // namespace charls
+
+#endif
@@ -0,0 +1,29 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "color_transform_simd.h"
+
+#include "cpu_features.h"
+
+namespace charls {
+
+color_transform_kernel select_color_transform_kernel(const color_transformation transformation, const bool inverse,
+                                                     const int32_t component_count, const size_t bytes_per_sample,
+                                                     const sample_layout source_layout,
+                                                     const sample_layout destination_layout) noexcept
+{
+    if (cpu_supports_avx2())
+    {
+        if (const auto kernel{select_color_transform_kernel_avx2(transformation, inverse, component_count,
+                                                                 bytes_per_sample, source_layout, destination_layout)})
+            return kernel;
+    }
+
+    if (cpu_supports_sse41())
+        return select_color_transform_kernel_sse41(transformation, inverse, component_count, bytes_per_sample,
+                                                   source_layout, destination_layout);
+
+    return nullptr;
+}
+
+} // namespace charls
@@ -0,0 +1,64 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "charls/public_types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace charls {
+
+// This file defines the interface to the vectorized (SSE4.1 and AVX2) implementations of the color transforms.
+// The kernels also (de)interleave the samples and swap the red and blue samples, when needed. For images without a
+// color transformation (color_transformation::none) they only perform these steps.
+// The kernels process complete blocks of pixels, the remaining pixels are processed by the templates in
+// process_line.h.
+
+enum class sample_layout
+{
+    /// <summary>
+    /// The samples of a pixel are stored next to each other (triplets or quads).
+    /// </summary>
+    interleaved,
+
+    /// <summary>
+    /// The samples of every component are stored in a separate line, the lines are stride samples apart.
+    /// </summary>
+    planar
+};
+
+
+/// <summary>
+/// Transforms the pixels of complete blocks and returns the number of transformed pixels.
+/// The strides (in samples) are only used for a planar source or destination.
+/// The mask is applied to all source samples, before the color transform.
+/// When swap_red_blue is true, the pixels of the application buffer (the source of the forward transform and the
+/// destination of the inverse transform) are stored in BGR order.
+/// </summary>
+using color_transform_kernel = size_t (*)(const void* source, size_t source_stride, void* destination,
+                                          size_t destination_stride, size_t pixel_count, uint32_t mask,
+                                          bool swap_red_blue);
+
+/// <summary>
+/// Returns the fastest kernel the CPU supports or nullptr when no vectorized kernel is available.
+/// The forward transform is used by the encoder, the inverse transform by the decoder.
+/// </summary>
+color_transform_kernel select_color_transform_kernel(color_transformation transformation, bool inverse,
+                                                     int32_t component_count, size_t bytes_per_sample,
+                                                     sample_layout source_layout,
+                                                     sample_layout destination_layout) noexcept;
+
+// Instruction set specific selection functions, return nullptr when the compiler cannot generate the instructions.
+// Note: the caller needs to check that the CPU supports the instruction set.
+color_transform_kernel select_color_transform_kernel_sse41(color_transformation transformation, bool inverse,
+                                                           int32_t component_count, size_t bytes_per_sample,
+                                                           sample_layout source_layout,
+                                                           sample_layout destination_layout) noexcept;
+color_transform_kernel select_color_transform_kernel_avx2(color_transformation transformation, bool inverse,
+                                                          int32_t component_count, size_t bytes_per_sample,
+                                                          sample_layout source_layout,
+                                                          sample_layout destination_layout) noexcept;
+
+} // namespace charls
@@ -0,0 +1,425 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "color_transform_simd.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// This file defines the instruction set independent part of the vectorized color transforms.
+// It is only included by the instruction set specific source files, which are compiled with additional compiler
+// options. These files provide a vector_operations<SampleType> class template, defined in an anonymous namespace.
+// The templates below are also defined in an anonymous namespace, which is unique for every source file: the
+// instantiations of the SSE4.1 and AVX2 files have different names and the linker cannot select a function that uses
+// instructions the CPU may not support. (An anonymous class template as template template argument alone is not
+// sufficient: GCC emits these instantiations as weak symbols with the same name in both files.)
+//
+// The color transforms are computed modulo 2^(bits of the sample type), just like the scalar implementation in
+// color_transform.h. The sum of 2 samples doesn't fit in a sample, the average is therefore computed as
+// (a & b) + ((a ^ b) >> 1), which equals (a + b) >> 1 without overflow.
+
+namespace charls { namespace simd {
+
+namespace { // NOLINT(cert-dcl59-cpp, google-build-namespaces): local to every instruction set specific source file.
+
+// The interleaved samples of a block are loaded into 1 vector register per component (16 bytes per register and
+// per 128-bit lane). Byte shuffles move the samples between the interleaved and the planar layout.
+struct shuffle_masks final
+{
+    alignas(16) int8_t load[4][4][16];  // [component][source register]
+    alignas(16) int8_t store[4][4][16]; // [destination register][component]
+};
+
+
+constexpr shuffle_masks make_shuffle_masks(const int component_count, const int bytes_per_sample) noexcept
+{
+    constexpr int8_t zero{-128}; // A shuffle index with the high bit set selects 0.
+    constexpr int register_size{16};
+
+    shuffle_masks masks{};
+    for (int component{}; component != component_count; ++component)
+    {
+        for (int index{}; index != register_size; ++index)
+        {
+            const int pixel{index / bytes_per_sample};
+            const int interleaved_index{(pixel * component_count + component) * bytes_per_sample +
+                                        index % bytes_per_sample};
+            for (int source_register{}; source_register != component_count; ++source_register)
+            {
+                masks.load[component][source_register][index] =
+                    interleaved_index / register_size == source_register
+                        ? static_cast<int8_t>(interleaved_index % register_size)
+                        : zero;
+            }
+        }
+    }
+
+    for (int destination_register{}; destination_register != component_count; ++destination_register)
+    {
+        for (int index{}; index != register_size; ++index)
+        {
+            const int interleaved_index{destination_register * register_size + index};
+            const int pixel{interleaved_index / (component_count * bytes_per_sample)};
+            const int sample_component{interleaved_index / bytes_per_sample % component_count};
+            for (int component{}; component != component_count; ++component)
+            {
+                masks.store[destination_register][component][index] =
+                    component == sample_component
+                        ? static_cast<int8_t>(pixel * bytes_per_sample + interleaved_index % bytes_per_sample)
+                        : zero;
+            }
+        }
+    }
+
+    return masks;
+}
+
+
+template<int ComponentCount, typename SampleType>
+const shuffle_masks& get_shuffle_masks() noexcept
+{
+    static constexpr shuffle_masks masks{make_shuffle_masks(ComponentCount, sizeof(SampleType))};
+    return masks;
+}
+
+
+template<typename Operations>
+typename Operations::vector half_range() noexcept
+{
+    return Operations::set1(1U << (sizeof(typename Operations::sample_type) * 8 - 1));
+}
+
+
+template<typename Operations>
+typename Operations::vector quarter_range() noexcept
+{
+    return Operations::set1(1U << (sizeof(typename Operations::sample_type) * 8 - 2));
+}
+
+
+template<typename Operations>
+typename Operations::vector floor_average(const typename Operations::vector a, const typename Operations::vector b) noexcept
+{
+    return Operations::add(Operations::bit_and(a, b), Operations::shift_right_1(Operations::bit_xor(a, b)));
+}
+
+
+// Only (de)interleaves the samples, used for images without a color transformation.
+template<bool Inverse>
+struct transform_none final
+{
+    static constexpr bool inverse{Inverse};
+
+    template<typename Operations>
+    static void apply(typename Operations::vector (& /* samples */)[4]) noexcept
+    {
+    }
+};
+
+
+struct transform_hp1_forward final
+{
+    static constexpr bool inverse{};
+
+    template<typename Operations>
+    static void apply(typename Operations::vector (&samples)[4]) noexcept
+    {
+        using ops = Operations;
+        const auto half{half_range<ops>()};
+        samples[0] = ops::add(ops::sub(samples[0], samples[1]), half);
+        samples[2] = ops::add(ops::sub(samples[2], samples[1]), half);
+    }
+};
+
+
+struct transform_hp1_inverse final
+{
+    static constexpr bool inverse{true};
+
+    template<typename Operations>
+    static void apply(typename Operations::vector (&samples)[4]) noexcept
+    {
+        using ops = Operations;
+        const auto half{half_range<ops>()};
+        samples[0] = ops::sub(ops::add(samples[0], samples[1]), half);
+        samples[2] = ops::sub(ops::add(samples[2], samples[1]), half);
+    }
+};
+
+
+struct transform_hp2_forward final
+{
+    static constexpr bool inverse{};
+
+    template<typename Operations>
+    static void apply(typename Operations::vector (&samples)[4]) noexcept
+    {
+        using ops = Operations;
+        const auto half{half_range<ops>()};
+        const auto red{samples[0]};
+        samples[0] = ops::add(ops::sub(red, samples[1]), half);
+        samples[2] = ops::sub(ops::sub(samples[2], floor_average<ops>(red, samples[1])), half);
+    }
+};
+
+
+struct transform_hp2_inverse final
+{
+    static constexpr bool inverse{true};
+
+    template<typename Operations>
+    static void apply(typename Operations::vector (&samples)[4]) noexcept
+    {
+        using ops = Operations;
+        const auto half{half_range<ops>()};
+        samples[0] = ops::sub(ops::add(samples[0], samples[1]), half);
+        samples[2] = ops::sub(ops::add(samples[2], floor_average<ops>(samples[0], samples[1])), half);
+    }
+};
+
+
+struct transform_hp3_forward final
+{
+    static constexpr bool inverse{};
+
+    template<typename Operations>
+    static void apply(typename Operations::vector (&samples)[4]) noexcept
+    {
+        using ops = Operations;
+        const auto half{half_range<ops>()};
+        const auto green{samples[1]};
+        const auto v2{ops::add(ops::sub(samples[2], green), half)};
+        const auto v3{ops::add(ops::sub(samples[0], green), half)};
+        samples[0] = ops::sub(ops::add(green, ops::shift_right_1(floor_average<ops>(v2, v3))), quarter_range<ops>());
+        samples[1] = v2;
+        samples[2] = v3;
+    }
+};
+
+
+struct transform_hp3_inverse final
+{
+    static constexpr bool inverse{true};
+
+    template<typename Operations>
+    static void apply(typename Operations::vector (&samples)[4]) noexcept
+    {
+        using ops = Operations;
+        const auto half{half_range<ops>()};
+        const auto green{ops::add(ops::sub(samples[0], ops::shift_right_1(floor_average<ops>(samples[2], samples[1]))),
+                                  quarter_range<ops>())};
+        const auto red{ops::sub(ops::add(samples[2], green), half)};
+        samples[2] = ops::sub(ops::add(samples[1], green), half);
+        samples[1] = green;
+        samples[0] = red;
+    }
+};
+
+
+// Returns the index of the sample in the interleaved pixel, when the red and blue samples are swapped (BGR order).
+constexpr int red_blue_swapped_index(const int component, const bool swap_red_blue) noexcept
+{
+    return swap_red_blue && component != 1 && component < 3 ? 2 - component : component;
+}
+
+
+template<sample_layout Layout>
+struct sample_access;
+
+template<>
+struct sample_access<sample_layout::interleaved> final
+{
+    template<typename Operations, int ComponentCount>
+    static void load(const uint8_t* source, size_t /* stride */, const size_t pixel,
+                     const typename Operations::vector (&masks)[4][4], typename Operations::vector (&samples)[4]) noexcept
+    {
+        Operations::template load_interleaved<ComponentCount>(
+            source + pixel * ComponentCount * sizeof(typename Operations::sample_type), masks, samples);
+    }
+
+    template<typename Operations, int ComponentCount>
+    static void store(uint8_t* destination, size_t /* stride */, const size_t pixel,
+                      const typename Operations::vector (&masks)[4][4],
+                      const typename Operations::vector (&samples)[4]) noexcept
+    {
+        Operations::template store_interleaved<ComponentCount>(
+            destination + pixel * ComponentCount * sizeof(typename Operations::sample_type), masks, samples);
+    }
+};
+
+template<>
+struct sample_access<sample_layout::planar> final
+{
+    template<typename Operations, int ComponentCount>
+    static void load(const uint8_t* source, const size_t stride, const size_t pixel,
+                     const typename Operations::vector (& /* masks */)[4][4],
+                     typename Operations::vector (&samples)[4]) noexcept
+    {
+        for (int component{}; component != ComponentCount; ++component)
+        {
+            samples[component] =
+                Operations::load(source + (component * stride + pixel) * sizeof(typename Operations::sample_type));
+        }
+    }
+
+    template<typename Operations, int ComponentCount>
+    static void store(uint8_t* destination, const size_t stride, const size_t pixel,
+                      const typename Operations::vector (& /* masks */)[4][4],
+                      const typename Operations::vector (&samples)[4]) noexcept
+    {
+        for (int component{}; component != ComponentCount; ++component)
+        {
+            Operations::store(destination + (component * stride + pixel) * sizeof(typename Operations::sample_type),
+                              samples[component]);
+        }
+    }
+};
+
+
+template<template<typename> class VectorOperations, typename SampleType, int ComponentCount, typename Transform,
+         sample_layout SourceLayout, sample_layout DestinationLayout>
+size_t transform_pixels(const void* source, const size_t source_stride, void* destination,
+                        const size_t destination_stride, const size_t pixel_count, const uint32_t mask,
+                        const bool swap_red_blue)
+{
+    using ops = VectorOperations<SampleType>;
+    using vector = typename ops::vector;
+
+    // The red and blue samples of the application buffer are swapped by selecting the shuffle masks of the other
+    // component: the swap doesn't require additional instructions.
+    const bool swap_source{swap_red_blue && !Transform::inverse};
+    const bool swap_destination{swap_red_blue && Transform::inverse};
+    const shuffle_masks& shuffle{get_shuffle_masks<ComponentCount, SampleType>()};
+    vector load_masks[4][4]{};
+    vector store_masks[4][4]{};
+    for (int i{}; i != ComponentCount; ++i)
+    {
+        for (int j{}; j != ComponentCount; ++j)
+        {
+            load_masks[i][j] = ops::load_shuffle_mask(shuffle.load[red_blue_swapped_index(i, swap_source)][j]);
+            store_masks[i][j] =
+                ops::load_shuffle_mask(shuffle.store[i][red_blue_swapped_index(j, swap_destination)]);
+        }
+    }
+
+    const auto* source_bytes{static_cast<const uint8_t*>(source)};
+    auto* destination_bytes{static_cast<uint8_t*>(destination)};
+    const vector sample_mask{ops::set1(mask)};
+
+    size_t pixel{};
+    for (; pixel + ops::pixels_per_block <= pixel_count; pixel += ops::pixels_per_block)
+    {
+        vector samples[4]{};
+        sample_access<SourceLayout>::template load<ops, ComponentCount>(source_bytes, source_stride, pixel, load_masks,
+                                                                        samples);
+        for (int component{}; component != ComponentCount; ++component)
+        {
+            samples[component] = ops::bit_and(samples[component], sample_mask);
+        }
+
+        Transform::template apply<ops>(samples);
+
+        sample_access<DestinationLayout>::template store<ops, ComponentCount>(destination_bytes, destination_stride,
+                                                                              pixel, store_masks, samples);
+    }
+
+    ops::complete();
+    return pixel;
+}
+
+
+// The encoder reads the interleaved pixels of the source image, the decoder writes interleaved pixels.
+template<template<typename> class VectorOperations, typename SampleType, int ComponentCount, typename Transform>
+color_transform_kernel select_kernel(const sample_layout source_layout, const sample_layout destination_layout,
+                                     std::false_type /* inverse */) noexcept
+{
+    if (source_layout != sample_layout::interleaved)
+        return nullptr;
+
+    return destination_layout == sample_layout::interleaved
+               ? &transform_pixels<VectorOperations, SampleType, ComponentCount, Transform, sample_layout::interleaved,
+                                   sample_layout::interleaved>
+               : &transform_pixels<VectorOperations, SampleType, ComponentCount, Transform, sample_layout::interleaved,
+                                   sample_layout::planar>;
+}
+
+
+template<template<typename> class VectorOperations, typename SampleType, int ComponentCount, typename Transform>
+color_transform_kernel select_kernel(const sample_layout source_layout, const sample_layout destination_layout,
+                                     std::true_type /* inverse */) noexcept
+{
+    if (destination_layout != sample_layout::interleaved)
+        return nullptr;
+
+    return source_layout == sample_layout::interleaved
+               ? &transform_pixels<VectorOperations, SampleType, ComponentCount, Transform, sample_layout::interleaved,
+                                   sample_layout::interleaved>
+               : &transform_pixels<VectorOperations, SampleType, ComponentCount, Transform, sample_layout::planar,
+                                   sample_layout::interleaved>;
+}
+
+
+template<template<typename> class VectorOperations, typename SampleType, int ComponentCount>
+color_transform_kernel select_kernel(const color_transformation transformation, const bool inverse,
+                                     const sample_layout source_layout, const sample_layout destination_layout) noexcept
+{
+    switch (transformation)
+    {
+    case color_transformation::none:
+        return inverse ? select_kernel<VectorOperations, SampleType, ComponentCount, transform_none<true>>(
+                             source_layout, destination_layout, std::true_type{})
+                       : select_kernel<VectorOperations, SampleType, ComponentCount, transform_none<false>>(
+                             source_layout, destination_layout, std::false_type{});
+    case color_transformation::hp1:
+        return inverse ? select_kernel<VectorOperations, SampleType, ComponentCount, transform_hp1_inverse>(
+                             source_layout, destination_layout, std::true_type{})
+                       : select_kernel<VectorOperations, SampleType, ComponentCount, transform_hp1_forward>(
+                             source_layout, destination_layout, std::false_type{});
+    case color_transformation::hp2:
+        return inverse ? select_kernel<VectorOperations, SampleType, ComponentCount, transform_hp2_inverse>(
+                             source_layout, destination_layout, std::true_type{})
+                       : select_kernel<VectorOperations, SampleType, ComponentCount, transform_hp2_forward>(
+                             source_layout, destination_layout, std::false_type{});
+    case color_transformation::hp3:
+        return inverse ? select_kernel<VectorOperations, SampleType, ComponentCount, transform_hp3_inverse>(
+                             source_layout, destination_layout, std::true_type{})
+                       : select_kernel<VectorOperations, SampleType, ComponentCount, transform_hp3_forward>(
+                             source_layout, destination_layout, std::false_type{});
+    default:
+        return nullptr;
+    }
+}
+
+
+template<template<typename> class VectorOperations>
+color_transform_kernel select_kernel(const color_transformation transformation, const bool inverse,
+                                     const int32_t component_count, const size_t bytes_per_sample,
+                                     const sample_layout source_layout, const sample_layout destination_layout) noexcept
+{
+    if (component_count == 3)
+    {
+        return bytes_per_sample == sizeof(uint8_t)
+                   ? select_kernel<VectorOperations, uint8_t, 3>(transformation, inverse, source_layout,
+                                                                 destination_layout)
+                   : select_kernel<VectorOperations, uint16_t, 3>(transformation, inverse, source_layout,
+                                                                  destination_layout);
+    }
+
+    if (component_count == 4)
+    {
+        return bytes_per_sample == sizeof(uint8_t)
+                   ? select_kernel<VectorOperations, uint8_t, 4>(transformation, inverse, source_layout,
+                                                                 destination_layout)
+                   : select_kernel<VectorOperations, uint16_t, 4>(transformation, inverse, source_layout,
+                                                                  destination_layout);
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
+}} // namespace charls::simd
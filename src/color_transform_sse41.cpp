@@ -0,0 +1,180 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "color_transform_simd.h"
+
+#include "cpu_features.h"
+
+// Note: MSVC can generate SSE4.1 instructions without additional compiler options, other compilers need -msse4.1.
+#if defined(__SSE4_1__) || (defined(CHARLS_X86_SIMD) && defined(_MSC_VER) && !defined(__clang__))
+#define CHARLS_SSE41_KERNELS
+#endif
+
+#ifdef CHARLS_SSE41_KERNELS
+
+#include "color_transform_simd_kernels.h"
+
+#include <smmintrin.h>
+
+namespace charls {
+
+namespace {
+
+struct sse41_operations
+{
+    using vector = __m128i;
+
+    static vector load(const uint8_t* source) noexcept
+    {
+        return _mm_loadu_si128(static_cast<const vector*>(static_cast<const void*>(source)));
+    }
+
+    static void store(uint8_t* destination, const vector value) noexcept
+    {
+        _mm_storeu_si128(static_cast<vector*>(static_cast<void*>(destination)), value);
+    }
+
+    static vector load_shuffle_mask(const int8_t* mask) noexcept
+    {
+        return _mm_load_si128(static_cast<const vector*>(static_cast<const void*>(mask)));
+    }
+
+    template<int ComponentCount>
+    static void load_interleaved(const uint8_t* source, const vector (&masks)[4][4], vector (&samples)[4]) noexcept
+    {
+        vector registers[ComponentCount];
+        for (int i{}; i != ComponentCount; ++i)
+        {
+            registers[i] = load(source + i * sizeof(vector));
+        }
+
+        for (int component{}; component != ComponentCount; ++component)
+        {
+            vector value{_mm_shuffle_epi8(registers[0], masks[component][0])};
+            for (int i{1}; i != ComponentCount; ++i)
+            {
+                value = _mm_or_si128(value, _mm_shuffle_epi8(registers[i], masks[component][i]));
+            }
+            samples[component] = value;
+        }
+    }
+
+    template<int ComponentCount>
+    static void store_interleaved(uint8_t* destination, const vector (&masks)[4][4],
+                                  const vector (&samples)[4]) noexcept
+    {
+        for (int i{}; i != ComponentCount; ++i)
+        {
+            vector value{_mm_shuffle_epi8(samples[0], masks[i][0])};
+            for (int component{1}; component != ComponentCount; ++component)
+            {
+                value = _mm_or_si128(value, _mm_shuffle_epi8(samples[component], masks[i][component]));
+            }
+            store(destination + i * sizeof(vector), value);
+        }
+    }
+
+    static vector bit_and(const vector a, const vector b) noexcept
+    {
+        return _mm_and_si128(a, b);
+    }
+
+    static vector bit_xor(const vector a, const vector b) noexcept
+    {
+        return _mm_xor_si128(a, b);
+    }
+
+    static void complete() noexcept
+    {
+    }
+};
+
+
+template<typename SampleType>
+struct vector_operations;
+
+template<>
+struct vector_operations<uint8_t> final : sse41_operations
+{
+    using sample_type = uint8_t;
+    static constexpr size_t pixels_per_block{16};
+
+    static vector set1(const uint32_t value) noexcept
+    {
+        return _mm_set1_epi8(static_cast<char>(value));
+    }
+
+    static vector add(const vector a, const vector b) noexcept
+    {
+        return _mm_add_epi8(a, b);
+    }
+
+    static vector sub(const vector a, const vector b) noexcept
+    {
+        return _mm_sub_epi8(a, b);
+    }
+
+    static vector shift_right_1(const vector a) noexcept
+    {
+        // There is no 8-bit shift instruction: shift 16-bit values and clear the bit shifted in from the next byte.
+        return _mm_and_si128(_mm_srli_epi16(a, 1), _mm_set1_epi8(0x7F));
+    }
+};
+
+template<>
+struct vector_operations<uint16_t> final : sse41_operations
+{
+    using sample_type = uint16_t;
+    static constexpr size_t pixels_per_block{8};
+
+    static vector set1(const uint32_t value) noexcept
+    {
+        return _mm_set1_epi16(static_cast<short>(value));
+    }
+
+    static vector add(const vector a, const vector b) noexcept
+    {
+        return _mm_add_epi16(a, b);
+    }
+
+    static vector sub(const vector a, const vector b) noexcept
+    {
+        return _mm_sub_epi16(a, b);
+    }
+
+    static vector shift_right_1(const vector a) noexcept
+    {
+        return _mm_srli_epi16(a, 1);
+    }
+};
+
+} // namespace
+
+
+color_transform_kernel select_color_transform_kernel_sse41(const color_transformation transformation, const bool inverse,
+                                                           const int32_t component_count, const size_t bytes_per_sample,
+                                                           const sample_layout source_layout,
+                                                           const sample_layout destination_layout) noexcept
+{
+    return simd::select_kernel<vector_operations>(transformation, inverse, component_count, bytes_per_sample,
+                                                  source_layout, destination_layout);
+}
+
+} // namespace charls
+
+#else
+
+namespace charls {
+
+color_transform_kernel select_color_transform_kernel_sse41(color_transformation /* transformation */,
+                                                           bool /* inverse */, int32_t /* component_count */,
+                                                           size_t /* bytes_per_sample */,
+                                                           sample_layout /* source_layout */,
+                                                           sample_layout /* destination_layout */) noexcept
+{
+    return nullptr;
+}
+
+} // namespace charls
+
+#endif
@@ -57,6 +57,9 @@ constexpr size_t segment_length_size{sizeof(uint16_t)};
 // The maximum size of the data bytes that fit in a segment.
 constexpr size_t segment_max_data_size{std::numeric_limits<uint16_t>::max() - segment_length_size};
 
+// The maximum number of restart marker offsets that fit in a restart marker index (APP9 + 'rsti' tag) segment.
+constexpr size_t maximum_restart_marker_index_count{(segment_max_data_size - 4) / sizeof(uint32_t)};
+
 // Number of bits in an int32_t data type.
 constexpr size_t int32_t_bit_count{sizeof(int32_t) * 8};
 
@@ -0,0 +1,85 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu_features.h"
+
+#if defined(CHARLS_X86_SIMD) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace charls {
+
+namespace {
+
+#if defined(CHARLS_X86_SIMD) && defined(_MSC_VER)
+
+struct cpu_features final
+{
+    bool sse41;
+    bool avx2;
+};
+
+
+cpu_features detect_cpu_features() noexcept
+{
+    int info[4]{};
+    __cpuid(info, 0);
+    const int highest_function{info[0]};
+
+    __cpuid(info, 1);
+    constexpr int sse41_bit{1 << 19};
+    constexpr int os_xsave_bit{1 << 27};
+    constexpr int avx_bit{1 << 28};
+    const bool sse41{(info[2] & sse41_bit) != 0};
+
+    // AVX registers can only be used when the operating system saves the YMM state (XMM and YMM bits of XCR0).
+    const bool avx{(info[2] & os_xsave_bit) != 0 && (info[2] & avx_bit) != 0 && (_xgetbv(0) & 6) == 6};
+
+    bool avx2{};
+    if (avx && highest_function >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        constexpr int avx2_bit{1 << 5};
+        avx2 = (info[1] & avx2_bit) != 0;
+    }
+
+    return {sse41, avx2};
+}
+
+
+const cpu_features& get_cpu_features() noexcept
+{
+    static const cpu_features features{detect_cpu_features()};
+    return features;
+}
+
+#endif
+
+} // namespace
+
+
+bool cpu_supports_sse41() noexcept
+{
+#if defined(CHARLS_X86_SIMD) && defined(_MSC_VER)
+    return get_cpu_features().sse41;
+#elif defined(CHARLS_X86_SIMD) && defined(__GNUC__)
+    return __builtin_cpu_supports("sse4.1");
+#else
+    return false;
+#endif
+}
+
+
+bool cpu_supports_avx2() noexcept
+{
+#if defined(CHARLS_X86_SIMD) && defined(_MSC_VER)
+    return get_cpu_features().avx2;
+#elif defined(CHARLS_X86_SIMD) && defined(__GNUC__)
+    // Note: the GCC and Clang run-time libraries also check that the operating system supports the AVX registers.
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+} // namespace charls
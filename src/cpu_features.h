@@ -0,0 +1,29 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+namespace charls {
+
+// The vectorized code paths are only available on x86 and x64 CPUs. Other CPUs use the portable (scalar) code.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CHARLS_X86_SIMD
+#endif
+
+// SSE2 is part of the x64 instruction set and the common x86 compilers generate it by default: it can be used without a
+// runtime check.
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHARLS_SSE2
+#endif
+
+/// <summary>
+/// Returns true when the CPU (and the operating system) supports the SSE4.1 instruction set.
+/// </summary>
+bool cpu_supports_sse41() noexcept;
+
+/// <summary>
+/// Returns true when the CPU (and the operating system) supports the AVX2 instruction set.
+/// </summary>
+bool cpu_supports_avx2() noexcept;
+
+} // namespace charls
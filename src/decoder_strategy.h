@@ -8,13 +8,15 @@
 #include "process_line.h"
 #include "util.h"
 
+#include <array>
 #include <cassert>
+#include <cstring>
 #include <memory>
 
 namespace charls {
 
 // Purpose: Implements encoding to stream of bits. In encoding mode jls_codec inherits from decoder_strategy
-class decoder_strategy
+class decoder_strategy : public internal_object
 {
 public:
     decoder_strategy(const frame_info& frame, const coding_parameters& parameters) noexcept :
@@ -31,12 +33,17 @@ class decoder_strategy
 
     virtual std::unique_ptr<process_line> create_process_line(byte_span destination, size_t stride) = 0;
     virtual void set_presets(const jpegls_pc_parameters& preset_coding_parameters, uint32_t restart_interval) = 0;
-    virtual size_t decode_scan(std::unique_ptr<process_line> output_data, const JlsRect& size, const_byte_span encoded_source) = 0;
+    virtual size_t decode_scan(std::unique_ptr<process_line> output_data, const JlsRect& size, const_byte_span encoded_source,
+                               uint32_t first_interval_index, uint32_t end_line) = 0;
+    virtual size_t decode_restart_interval(std::unique_ptr<process_line> output_data, const JlsRect& size,
+                                           const_byte_span encoded_source, uint32_t interval_index) = 0;
 
     void initialize(const const_byte_span source)
     {
         position_ = source.data();
         end_position_ = source.end();
+        valid_bits_ = 0;
+        read_cache_ = 0;
 
         find_jpeg_marker_start_byte();
         fill_read_cache();
@@ -59,11 +66,6 @@ class decoder_strategy
         read_cache_ = read_cache_ << length;
     }
 
-    void on_line_end(const void* source, const size_t pixel_count, const size_t pixel_stride) const
-    {
-        process_line_->new_line_decoded(source, pixel_count, pixel_stride);
-    }
-
     void end_scan()
     {
         if (UNLIKELY(position_ >= end_position_))
@@ -81,6 +83,11 @@ class decoder_strategy
             impl::throw_jpegls_error(jpegls_errc::too_much_encoded_data);
     }
 
+    const uint8_t* position() const noexcept
+    {
+        return position_;
+    }
+
     const uint8_t* get_cur_byte_pos() const noexcept
     {
         int32_t valid_bits{valid_bits_};
@@ -116,12 +123,18 @@ class decoder_strategy
 
     FORCE_INLINE int32_t peek_byte()
     {
-        if (valid_bits_ < 8)
+        return peek_bits(8);
+    }
+
+    FORCE_INLINE int32_t peek_bits(const int32_t bit_count)
+    {
+        ASSERT(bit_count > 0 && bit_count <= 16);
+        if (valid_bits_ < bit_count)
         {
             fill_read_cache();
         }
 
-        return static_cast<int32_t>(read_cache_ >> max_readable_cache_bits);
+        return static_cast<int32_t>(read_cache_ >> (cache_t_bit_count - bit_count));
     }
 
     FORCE_INLINE bool read_bit()
@@ -136,45 +149,25 @@ class decoder_strategy
         return set;
     }
 
-    FORCE_INLINE int32_t peek_0_bits()
+    /// <summary>
+    /// Reads the unary coded high bits: the number of 0 bits before the next 1 bit.
+    /// </summary>
+    FORCE_INLINE int32_t read_high_bits()
     {
         if (valid_bits_ < 16)
         {
             fill_read_cache();
         }
 
-#if defined(_MSC_VER) || defined(__GNUC__)
-        const auto count{countl_zero(read_cache_)};
-        return count < 16 ? count : -1;
-#else
-        cache_t val_test = read_cache_;
-
-        for (int32_t count{}; count < 16; ++count)
-        {
-            if ((val_test & (static_cast<cache_t>(1) << (cache_t_bit_count - 1))) != 0)
-                return count;
-
-            val_test <<= 1;
-        }
-        return -1;
-#endif
-    }
-
-    FORCE_INLINE int32_t read_high_bits()
-    {
-        const int32_t count{peek_0_bits()};
-        if (count >= 0)
+        // The bits after the valid bits are 0 or the next bits of the stream, count the zero bits of the complete cache.
+        const int32_t count{countl_zero(read_cache_)};
+        if (count < valid_bits_)
         {
-            skip(count + 1);
+            skip_zero_bits_and_1_bit(count);
             return count;
         }
-        skip(15);
 
-        for (int32_t high_bits_count{15};; ++high_bits_count)
-        {
-            if (read_bit())
-                return high_bits_count;
-        }
+        return read_long_high_bits();
     }
 
     int32_t read_long_value(const int32_t length)
@@ -212,6 +205,12 @@ class decoder_strategy
 
         do
         {
+            if (position_ < position_ff_)
+            {
+                read_bytes_before_ff();
+                continue;
+            }
+
             if (position_ >= end_position_)
             {
                 if (UNLIKELY(valid_bits_ == 0))
@@ -223,11 +222,8 @@ class decoder_strategy
                 return;
             }
 
-            const cache_t new_byte_value{*position_};
-
             // JPEG-LS bit stream rule: if FF is followed by a 1 bit then it is a marker
-            if (new_byte_value == jpeg_marker_start_byte &&
-                (position_ == end_position_ - 1 || (position_[1] & 0x80) != 0))
+            if (position_ == end_position_ - 1 || (position_[1] & 0x80) != 0)
             {
                 if (UNLIKELY(valid_bits_ <= 0))
                 {
@@ -239,19 +235,13 @@ class decoder_strategy
                 return;
             }
 
-            read_cache_ |= new_byte_value << (max_readable_cache_bits - valid_bits_);
-            valid_bits_ += 8;
+            // The next bit after an 0xFF needs to be ignored (see ISO/IEC 14495-1,A.1): only 7 bits are added, the
+            // ignored bit of the next byte is 0 and will be placed on the last bit of the 0xFF.
+            read_cache_ |= static_cast<cache_t>(jpeg_marker_start_byte) << (max_readable_cache_bits - valid_bits_);
+            valid_bits_ += 7;
             ++position_;
-
-            if (new_byte_value == jpeg_marker_start_byte)
-            {
-                // The next bit after an 0xFF needs to be ignored, compensate for the next read (see ISO/IEC 14495-1,A.1)
-                --valid_bits_;
-            }
-
+            find_jpeg_marker_start_byte();
         } while (valid_bits_ < max_readable_cache_bits);
-
-        find_jpeg_marker_start_byte();
     }
 
     FORCE_INLINE bool fill_read_cache_optimistic() noexcept
@@ -269,6 +259,64 @@ class decoder_strategy
         return false;
     }
 
+    /// <summary>
+    /// Adds the bytes before the next 0xFF byte (or the end of the buffer) that fit in the cache with a single read.
+    /// </summary>
+    void read_bytes_before_ff() noexcept
+    {
+        ASSERT(valid_bits_ >= 0 && valid_bits_ < max_readable_cache_bits);
+
+        const auto byte_count{std::min(static_cast<size_t>((cache_t_bit_count - valid_bits_) / 8),
+                                       static_cast<size_t>(position_ff_ - position_))};
+        cache_t new_bytes;
+        if (static_cast<size_t>(end_position_ - position_) >= sizeof(cache_t))
+        {
+            new_bytes = read_big_endian_unaligned<cache_t>(position_);
+        }
+        else
+        {
+            std::array<uint8_t, sizeof(cache_t)> buffer{};
+            memcpy(buffer.data(), position_, byte_count);
+            new_bytes = read_big_endian_unaligned<cache_t>(buffer.data());
+        }
+
+        // Remove the bytes after the 0xFF: the bits of the 0xFF byte and the byte after it need special handling.
+        ASSERT(byte_count > 0);
+        const auto unused_bit_count{static_cast<int32_t>((sizeof(cache_t) - byte_count) * 8)};
+        new_bytes = new_bytes >> unused_bit_count << unused_bit_count;
+
+        read_cache_ |= new_bytes >> valid_bits_;
+        position_ += byte_count;
+        valid_bits_ += static_cast<int32_t>(byte_count) * 8;
+    }
+
+    FORCE_INLINE void skip_zero_bits_and_1_bit(const int32_t zero_bit_count) noexcept
+    {
+        // Note: shift in 2 steps, the number of skipped bits can be equal to the width of the cache.
+        valid_bits_ -= zero_bit_count + 1;
+        read_cache_ = read_cache_ << zero_bit_count << 1;
+    }
+
+    int32_t read_long_high_bits()
+    {
+        // All valid bits in the cache are 0: consume them and continue with the next bits.
+        int32_t high_bits_count{};
+        for (;;)
+        {
+            high_bits_count += valid_bits_;
+            read_cache_ = 0;
+            valid_bits_ = 0;
+            fill_read_cache();
+
+            const int32_t count{countl_zero(read_cache_)};
+            if (count < valid_bits_)
+            {
+                skip_zero_bits_and_1_bit(count);
+                return high_bits_count + count;
+            }
+        }
+    }
+
     void find_jpeg_marker_start_byte() noexcept
     {
         // Use memchr to find next start byte (0xFF). memchr is optimized on some platforms to search faster.
@@ -9,7 +9,7 @@
 namespace charls {
 
 // Purpose: Implements encoding to stream of bits. In encoding mode jls_codec inherits from encoder_strategy
-class encoder_strategy
+class encoder_strategy : public internal_object
 {
 public:
     encoder_strategy(const frame_info& info, const coding_parameters& parameters) noexcept :
@@ -27,20 +27,19 @@ class encoder_strategy
     virtual std::unique_ptr<process_line> create_process_line(byte_span stream_info, size_t stride) = 0;
     virtual void set_presets(const jpegls_pc_parameters& preset_coding_parameters, uint32_t restart_interval) = 0;
     virtual size_t encode_scan(std::unique_ptr<process_line> raw_data, byte_span destination) = 0;
-
-    void on_line_begin(void* destination, const size_t pixel_count, const size_t pixel_stride) const
-    {
-        process_line_->new_line_requested(destination, pixel_count, pixel_stride);
-    }
+    virtual size_t encode_restart_interval(std::unique_ptr<process_line> raw_data, byte_span destination,
+                                           uint32_t interval_index) = 0;
 
 protected:
     void initialize(const byte_span destination) noexcept
     {
-        free_bit_count_ = sizeof(bit_buffer_) * 8;
+        free_bit_count_ = bit_buffer_bit_count;
         bit_buffer_ = 0;
 
         position_ = destination.data;
         compressed_length_ = destination.size;
+        is_ff_written_ = false;
+        bytes_written_ = 0;
     }
 
     void append_to_bit_stream(const uint32_t bits, const int32_t bit_count)
@@ -53,80 +52,76 @@ class encoder_strategy
         ASSERT((bits | mask) == mask); // Not used bits must be set to zero.
 #endif
 
-        free_bit_count_ -= bit_count;
-        if (free_bit_count_ >= 0)
-        {
-            bit_buffer_ |= bits << free_bit_count_;
-        }
-        else
+        // Nothing to append (e.g. the padding of a byte aligned scan end): after a flush the buffer can be completely
+        // free and shifting by the full width of the bit buffer is undefined behavior.
+        if (bit_count == 0)
+            return;
+
+        // Flush before the buffer is completely filled: at least 1 bit stays free, which keeps the shifts in flush
+        // smaller than the width of the bit buffer.
+        if (free_bit_count_ <= bit_count)
         {
-            // Add as much bits in the remaining space as possible and flush.
-            bit_buffer_ |= bits >> -free_bit_count_;
             flush();
-
-            // A second flush may be required if extra marker detect bits were needed and not all bits could be written.
-            if (free_bit_count_ < 0)
-            {
-                bit_buffer_ |= bits >> -free_bit_count_;
-                flush();
-            }
-
-            ASSERT(free_bit_count_ >= 0);
-            bit_buffer_ |= bits << free_bit_count_;
         }
+
+        free_bit_count_ -= bit_count;
+        bit_buffer_ |= static_cast<bit_buffer_type>(bits) << free_bit_count_;
     }
 
     void end_scan()
     {
         flush();
 
-        // if a 0xff was written, Flush() will force one unset bit anyway
-        if (is_ff_written_)
-        {
-            append_to_bit_stream(0, (free_bit_count_ - 1) % 8);
-        }
+        // Pad the last byte with zero bits. If a 0xFF was written, the padding forms the byte with the extra 0 bit.
+        append_to_bit_stream(0, is_ff_written_ ? (free_bit_count_ - 1) % 8 : free_bit_count_ % 8);
 
         flush();
-        ASSERT(free_bit_count_ == 32);
+        ASSERT(free_bit_count_ == bit_buffer_bit_count);
     }
 
-    void flush()
+    void write_restart_marker(const uint32_t restart_marker_index)
     {
-        if (UNLIKELY(compressed_length_ < 4))
+        ASSERT(free_bit_count_ == bit_buffer_bit_count);
+        ASSERT(restart_marker_index < jpeg_restart_marker_range);
+
+        if (UNLIKELY(compressed_length_ < 2))
             impl::throw_jpegls_error(jpegls_errc::destination_buffer_too_small);
 
-        for (int i{}; i < 4; ++i)
-        {
-            if (free_bit_count_ >= 32)
-            {
-                free_bit_count_ = 32;
-                break;
-            }
-
-            if (is_ff_written_)
-            {
-                // JPEG-LS requirement (T.87, A.1) to detect markers: after a xFF value a single 0 bit needs to be inserted.
-                *position_ = static_cast<uint8_t>(bit_buffer_ >> 25);
-                bit_buffer_ = bit_buffer_ << 7;
-                free_bit_count_ += 7;
-            }
-            else
-            {
-                *position_ = static_cast<uint8_t>(bit_buffer_ >> 24);
-                bit_buffer_ = bit_buffer_ << 8;
-                free_bit_count_ += 8;
-            }
+        position_[0] = jpeg_marker_start_byte;
+        position_[1] = static_cast<uint8_t>(jpeg_restart_marker_base + restart_marker_index);
+        position_ += 2;
+        compressed_length_ -= 2;
+        bytes_written_ += 2;
+        is_ff_written_ = false;
+    }
 
-            is_ff_written_ = *position_ == jpeg_marker_start_byte;
-            ++position_;
-            --compressed_length_;
-            ++bytes_written_;
+    /// <summary>
+    /// Writes the complete bytes of the bit buffer to the destination.
+    /// </summary>
+    void flush()
+    {
+        // Fast path: without a 0xFF byte no extra 0 bits need to be inserted and all complete bytes can be stored at
+        // once. The bytes after the complete bytes are overwritten by the next flush.
+        if (!is_ff_written_ && !has_ff_byte(bit_buffer_) && compressed_length_ >= sizeof bit_buffer_)
+        {
+            const int32_t byte_count{(bit_buffer_bit_count - free_bit_count_) / 8};
+            write_big_endian_unaligned(position_, bit_buffer_);
+            bit_buffer_ <<= byte_count * 8;
+            free_bit_count_ += byte_count * 8;
+
+            position_ += byte_count;
+            compressed_length_ -= static_cast<size_t>(byte_count);
+            bytes_written_ += static_cast<size_t>(byte_count);
+            return;
         }
+
+        flush_with_bit_stuffing();
     }
 
     size_t get_length() const noexcept
     {
-        return bytes_written_ - (static_cast<size_t>(free_bit_count_) - 32U) / 8U;
+        ASSERT(free_bit_count_ == bit_buffer_bit_count);
+        return bytes_written_;
     }
 
     FORCE_INLINE void append_ones_to_bit_stream(const int32_t length)
@@ -140,8 +135,43 @@ class encoder_strategy
     std::unique_ptr<process_line> process_line_;
 
 private:
-    unsigned int bit_buffer_{};
-    int32_t free_bit_count_{sizeof bit_buffer_ * 8};
+    using bit_buffer_type = uint64_t;
+    static constexpr int32_t bit_buffer_bit_count{sizeof(bit_buffer_type) * 8};
+
+    static constexpr bool has_ff_byte(const bit_buffer_type value) noexcept
+    {
+        // A byte is 0xFF when its complement is zero, detect zero bytes with the "has zero byte" bit trick.
+        // Note: bytes that are not complete have at least 1 not used (zero) bit and are never 0xFF.
+        constexpr bit_buffer_type low_bits{0x0101'0101'0101'0101};
+        constexpr bit_buffer_type high_bits{0x8080'8080'8080'8080};
+        return ((~value - low_bits) & value & high_bits) != 0;
+    }
+
+    void flush_with_bit_stuffing()
+    {
+        for (;;)
+        {
+            // JPEG-LS requirement (T.87, A.1) to detect markers: after a xFF value a single 0 bit needs to be inserted.
+            const int32_t byte_bit_count{is_ff_written_ ? 7 : 8};
+            if (bit_buffer_bit_count - free_bit_count_ < byte_bit_count)
+                break;
+
+            if (UNLIKELY(compressed_length_ == 0))
+                impl::throw_jpegls_error(jpegls_errc::destination_buffer_too_small);
+
+            *position_ = static_cast<uint8_t>(bit_buffer_ >> (bit_buffer_bit_count - byte_bit_count));
+            bit_buffer_ <<= byte_bit_count;
+            free_bit_count_ += byte_bit_count;
+
+            is_ff_written_ = *position_ == jpeg_marker_start_byte;
+            ++position_;
+            --compressed_length_;
+            ++bytes_written_;
+        }
+    }
+
+    bit_buffer_type bit_buffer_{};
+    int32_t free_bit_count_{bit_buffer_bit_count};
     size_t compressed_length_{};
 
     // encoding
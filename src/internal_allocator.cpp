@@ -0,0 +1,120 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "internal_allocator.h"
+
+#include "charls/allocator.h"
+
+#include "util.h"
+
+#include <cstdint>
+#include <limits>
+
+using namespace charls;
+
+namespace charls {
+
+namespace {
+
+// Every memory block starts with a header that stores the allocator that allocated it: the block can be released
+// after the allocator of the scope or the process-wide allocator has been changed.
+struct alignas(alignof(std::max_align_t)) allocation_header final
+{
+    charls_allocator allocator;
+    size_t size;
+};
+
+charls_allocator process_allocator{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+thread_local const charls_allocator* scope_allocator{};
+
+const charls_allocator& current_allocator() noexcept
+{
+    return scope_allocator && scope_allocator->allocate ? *scope_allocator : process_allocator;
+}
+
+} // namespace
+
+
+void* allocate_memory(const size_t size)
+{
+    if (UNLIKELY(size > std::numeric_limits<size_t>::max() - sizeof(allocation_header)))
+        throw std::bad_alloc();
+
+    const size_t block_size{sizeof(allocation_header) + size};
+    const charls_allocator& allocator{current_allocator()};
+    void* const block{allocator.allocate ? allocator.allocate(block_size, allocator.user_context)
+                                         : ::operator new(block_size)};
+    if (UNLIKELY(!block))
+        throw std::bad_alloc();
+
+    auto* const header{new (block) allocation_header{allocator, block_size}};
+    return header + 1;
+}
+
+
+void deallocate_memory(void* memory) noexcept
+{
+    if (!memory)
+        return;
+
+    auto* const header{static_cast<allocation_header*>(memory) - 1};
+    const charls_allocator allocator{header->allocator};
+    const size_t block_size{header->size};
+    header->~allocation_header();
+
+    if (allocator.deallocate)
+    {
+        allocator.deallocate(header, block_size, allocator.user_context);
+    }
+    else
+    {
+        ::operator delete(header);
+    }
+}
+
+
+allocator_scope::allocator_scope(const charls_allocator* allocator) noexcept : previous_{scope_allocator}
+{
+    scope_allocator = allocator;
+}
+
+
+allocator_scope::~allocator_scope()
+{
+    scope_allocator = previous_;
+}
+
+
+const charls_allocator* allocator_scope::current() noexcept
+{
+    return scope_allocator;
+}
+
+} // namespace charls
+
+
+extern "C" {
+
+USE_DECL_ANNOTATIONS jpegls_errc CHARLS_API_CALLING_CONVENTION
+charls_set_allocator(const charls_allocator* allocator) noexcept
+try
+{
+    if (allocator)
+    {
+        check_argument(allocator->allocate && allocator->deallocate);
+        process_allocator = *allocator;
+    }
+    else
+    {
+        process_allocator = {};
+    }
+
+    return jpegls_errc::success;
+}
+catch (...)
+{
+    return to_jpegls_errc();
+}
+
+}
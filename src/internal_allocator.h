@@ -0,0 +1,143 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "charls/public_types.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace charls {
+
+/// <summary>
+/// Allocates a memory block with the allocator of the current allocator_scope, or with the process-wide allocator
+/// when the scope has none. Throws std::bad_alloc when the memory cannot be allocated.
+/// </summary>
+void* allocate_memory(size_t size);
+
+/// <summary>
+/// Releases a memory block with the allocator that allocated it.
+/// </summary>
+void deallocate_memory(void* memory) noexcept;
+
+
+// Purpose: selects the allocator of an encoder or decoder for the allocations of the current thread.
+class allocator_scope final
+{
+public:
+    explicit allocator_scope(const charls_allocator* allocator) noexcept;
+    ~allocator_scope();
+
+    allocator_scope(const allocator_scope&) = delete;
+    allocator_scope(allocator_scope&&) = delete;
+    allocator_scope& operator=(const allocator_scope&) = delete;
+    allocator_scope& operator=(allocator_scope&&) = delete;
+
+    /// <summary>
+    /// Returns the allocator of the current scope or nullptr, used to pass the scope to other threads.
+    /// </summary>
+    static const charls_allocator* current() noexcept;
+
+private:
+    const charls_allocator* previous_;
+};
+
+
+/// <summary>
+/// Standard library compatible allocator that allocates with allocate_memory.
+/// </summary>
+template<typename T>
+class internal_allocator
+{
+public:
+    using value_type = T;
+
+    internal_allocator() = default;
+
+    // NOLINTNEXTLINE(google-explicit-constructor, hicpp-explicit-conversions)
+    template<typename U>
+    internal_allocator(const internal_allocator<U>& /* other */) noexcept
+    {
+    }
+
+    T* allocate(const size_t count)
+    {
+        if (count > static_cast<size_t>(-1) / sizeof(T))
+            throw std::bad_alloc();
+
+        return static_cast<T*>(allocate_memory(count * sizeof(T)));
+    }
+
+    void deallocate(T* memory, size_t /* count */) noexcept
+    {
+        deallocate_memory(memory);
+    }
+
+    template<typename U>
+    bool operator==(const internal_allocator<U>& /* other */) const noexcept
+    {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const internal_allocator<U>& /* other */) const noexcept
+    {
+        return false;
+    }
+};
+
+template<typename T>
+using internal_vector = std::vector<T, internal_allocator<T>>;
+
+
+/// <summary>
+/// Base class for objects that are created with new: the operators new and delete use allocate_memory.
+/// </summary>
+struct internal_object
+{
+    static void* operator new(const size_t size)
+    {
+        return allocate_memory(size);
+    }
+
+    static void* operator new(const size_t size, const std::nothrow_t& /* tag */) noexcept
+    {
+        try
+        {
+            return allocate_memory(size);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+
+    static void operator delete(void* memory) noexcept
+    {
+        deallocate_memory(memory);
+    }
+
+    static void operator delete(void* memory, const std::nothrow_t& /* tag */) noexcept
+    {
+        deallocate_memory(memory);
+    }
+};
+
+
+/// <summary>
+/// Shared reference to a state object, allocated with allocate_memory to pass it to a task submitted to an executor.
+/// </summary>
+template<typename T>
+struct task_state_reference final : internal_object
+{
+    explicit task_state_reference(std::shared_ptr<T> shared_state) noexcept : state{std::move(shared_state)}
+    {
+    }
+
+    std::shared_ptr<T> state;
+};
+
+} // namespace charls
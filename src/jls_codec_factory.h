@@ -24,7 +24,35 @@ class jls_codec_factory final
     std::unique_ptr<Strategy> try_create_optimized_codec(const frame_info& frame, const coding_parameters& parameters);
 };
 
+/// <summary>
+/// Keeps the codec of the previous scan. A scan with the same frame info and coding parameters reuses it, together
+/// with its process_line and line buffers: coding a sequence of same-shaped images doesn't allocate memory.
+/// </summary>
+template<typename Strategy>
+class jls_codec_cache final
+{
+public:
+    jls_codec_cache() noexcept;
+    ~jls_codec_cache();
+
+    jls_codec_cache(const jls_codec_cache&) = delete;
+    jls_codec_cache(jls_codec_cache&&) noexcept;
+    jls_codec_cache& operator=(const jls_codec_cache&) = delete;
+    jls_codec_cache& operator=(jls_codec_cache&&) noexcept;
+
+    Strategy& get_codec(const frame_info& frame, const coding_parameters& parameters,
+                        const jpegls_pc_parameters& preset_coding_parameters);
+
+private:
+    std::unique_ptr<Strategy> codec_;
+    frame_info frame_info_{};
+    coding_parameters parameters_{};
+    jpegls_pc_parameters preset_coding_parameters_{};
+};
+
 extern template class jls_codec_factory<decoder_strategy>;
 extern template class jls_codec_factory<encoder_strategy>;
+extern template class jls_codec_cache<decoder_strategy>;
+extern template class jls_codec_cache<encoder_strategy>;
 
 } // namespace charls
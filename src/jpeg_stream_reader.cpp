@@ -9,12 +9,15 @@
 #include "jpeg_marker_code.h"
 #include "jpegls_preset_coding_parameters.h"
 #include "jpegls_preset_parameters_type.h"
+#include "parallel_for.h"
+#include "pipelined_process_line.h"
 #include "util.h"
 
 #include <algorithm>
 #include <array>
 #include <memory>
 #include <tuple>
+#include <vector>
 
 namespace charls {
 
@@ -44,11 +47,35 @@ void jpeg_stream_reader::source(const const_byte_span source) noexcept
 {
     ASSERT(state_ == state::before_start_of_image);
 
+    source_begin_ = source.begin();
     position_ = source.begin();
     end_position_ = source.end();
 }
 
 
+void jpeg_stream_reader::reset() noexcept
+{
+    source_begin_ = {};
+    position_ = {};
+    end_position_ = {};
+    segment_data_ = {};
+    frame_info_ = {};
+
+    // The output_bgr option is stored in the coding parameters and is kept.
+    const bool output_bgr{parameters_.output_bgr};
+    parameters_ = {};
+    parameters_.output_bgr = output_bgr;
+
+    preset_coding_parameters_ = {};
+    rect_ = {};
+    component_ids_.clear();
+    scans_.clear();
+    restart_marker_index_.clear();
+    state_ = state::before_start_of_image;
+    stopped_after_region_ = false;
+}
+
+
 void jpeg_stream_reader::read_header(spiff_header* header, bool* spiff_header_found)
 {
     ASSERT(state_ != state::scan_section);
@@ -131,6 +158,23 @@ void jpeg_stream_reader::decode(byte_span destination, size_t stride)
     if (UNLIKELY(destination.size < minimum_destination_size))
         throw_jpegls_error(jpegls_errc::destination_buffer_too_small);
 
+    // Only more than 1 plane or restart interval can be decoded in parallel: a single task would lose the codec cache and
+    // the early stop of the serial path.
+    const bool multiple_restart_intervals{parameters_.restart_interval != 0 &&
+                                          parameters_.restart_interval < frame_info_.height};
+    if (thread_count_ != 1 && (plane_count > 1 || multiple_restart_intervals))
+    {
+        decode_scans_in_parallel(destination, stride, bytes_per_plane, plane_count);
+        return;
+    }
+
+    // Decoding stops after the last line of the output rectangle.
+    const auto rect_top{static_cast<uint32_t>(rect_.Y)};
+    const uint64_t rect_bottom{static_cast<uint64_t>(rect_top) + static_cast<uint32_t>(rect_.Height)};
+    const uint32_t end_line{rect_top < frame_info_.height && rect_.Height > 0 && rect_bottom < frame_info_.height
+                                ? static_cast<uint32_t>(rect_bottom)
+                                : frame_info_.height};
+
     for (size_t i{}; i < plane_count; ++i)
     {
         if (state_ == state::scan_section)
@@ -139,12 +183,349 @@ void jpeg_stream_reader::decode(byte_span destination, size_t stride)
             skip_bytes(destination, bytes_per_plane);
         }
 
-        const unique_ptr<decoder_strategy> codec{jls_codec_factory<decoder_strategy>().create_codec(
-            frame_info_, parameters_, get_validated_preset_coding_parameters())};
-        unique_ptr<process_line> process_line(codec->create_process_line(destination, stride));
-        const size_t bytes_read{codec->decode_scan(std::move(process_line), rect_, const_byte_span{position_, end_position_})};
+        // Lines above the output rectangle don't need to be decoded: start at the restart interval that contains
+        // the first line of the rectangle.
+        const uint32_t first_interval_index{parameters_.restart_interval == 0 || rect_top >= frame_info_.height
+                                                ? 0
+                                                : rect_top / parameters_.restart_interval};
+        internal_vector<uint32_t> restart_marker_index;
+        restart_marker_index.swap(restart_marker_index_);
+        const auto scan_begin{position_};
+        if (first_interval_index != 0)
+        {
+            position_ = find_restart_interval_begin(first_interval_index, restart_marker_index);
+        }
+
+        // The scan cannot be split: use the additional thread to convert the decoded lines to the output format.
+        // The codec of a pipelined scan is not kept, as its process_line references the additional thread.
+        const bool pipelined_scan{thread_count_ != 1 && parameters_.interleave_mode != interleave_mode::none};
+        unique_ptr<decoder_strategy> pipelined_codec;
+        if (pipelined_scan)
+        {
+            pipelined_codec = jls_codec_factory<decoder_strategy>().create_codec(frame_info_, parameters_,
+                                                                                 get_validated_preset_coding_parameters());
+        }
+        decoder_strategy& codec{pipelined_scan ? *pipelined_codec
+                                               : codec_cache_.get_codec(frame_info_, parameters_,
+                                                                        get_validated_preset_coding_parameters())};
+        unique_ptr<process_line> process_line(codec.create_process_line(destination, stride));
+
+        pipelined_process_line* pipeline{};
+        if (pipelined_scan)
+        {
+            auto pipelined{std::make_unique<pipelined_process_line>(std::move(process_line), frame_info_,
+                                                                    parameters_.interleave_mode, executor_)};
+            pipeline = pipelined.get();
+            process_line = std::move(pipelined);
+        }
+
+        const size_t bytes_read{codec.decode_scan(std::move(process_line), rect_, const_byte_span{position_, end_position_},
+                                                  first_interval_index, end_line)};
+        if (pipeline)
+        {
+            pipeline->complete();
+        }
         advance_position(bytes_read);
         state_ = state::scan_section;
+
+        if (end_line != frame_info_.height)
+        {
+            // The remaining data of the last scan is not needed, the next scan can only be found by skipping it.
+            if (i + 1 == plane_count)
+            {
+                stopped_after_region_ = true;
+                return;
+            }
+
+            skip_remaining_scan_data(scan_begin, restart_marker_index);
+        }
+    }
+}
+
+
+void jpeg_stream_reader::read_restart_intervals()
+{
+    ASSERT(state_ == state::bit_stream_section);
+
+    check_parameter_coherent();
+    read_scans(parameters_.interleave_mode == interleave_mode::none ? frame_info_.component_count : 1U);
+}
+
+
+size_t jpeg_stream_reader::restart_interval_count() const noexcept
+{
+    size_t count{};
+    for (const auto& scan : scans_)
+    {
+        count += scan.restart_intervals.size();
+    }
+
+    return count;
+}
+
+
+charls::restart_interval_info jpeg_stream_reader::restart_interval_info(size_t index) const
+{
+    for (size_t scan_index{}; scan_index != scans_.size(); ++scan_index)
+    {
+        const scan_info& scan{scans_[scan_index]};
+        if (index >= scan.restart_intervals.size())
+        {
+            index -= scan.restart_intervals.size();
+            continue;
+        }
+
+        const restart_interval_position& interval{scan.restart_intervals[index]};
+        const uint32_t lines_per_interval{scan.parameters.restart_interval == 0 ? frame_info_.height
+                                                                                : scan.parameters.restart_interval};
+        const auto first_line{static_cast<uint32_t>(index) * lines_per_interval};
+
+        return {static_cast<size_t>(interval.begin - source_begin_),
+                static_cast<size_t>(interval.end - interval.begin),
+                static_cast<uint32_t>(scan_index),
+                first_line,
+                std::min(lines_per_interval, frame_info_.height - first_line),
+                scan.parameters.interleave_mode == interleave_mode::none ? 1 : frame_info_.component_count};
+    }
+
+    throw_jpegls_error(jpegls_errc::invalid_argument);
+}
+
+
+void jpeg_stream_reader::decode_restart_interval(const size_t index, const byte_span destination, size_t stride) const
+{
+    const charls::restart_interval_info info{restart_interval_info(index)};
+    const size_t minimum_stride{static_cast<size_t>(info.component_count) * frame_info_.width *
+                                bit_to_byte_count(frame_info_.bits_per_sample)};
+
+    if (stride == auto_calculate_stride)
+    {
+        stride = minimum_stride;
+    }
+    else
+    {
+        if (UNLIKELY(stride < minimum_stride))
+            throw_jpegls_error(jpegls_errc::invalid_argument_stride);
+    }
+
+    if (UNLIKELY(destination.size < stride * info.line_count - (stride - minimum_stride)))
+        throw_jpegls_error(jpegls_errc::destination_buffer_too_small);
+
+    // The output rectangle is the complete image: the lines of the interval are written to the start of the destination.
+    const scan_info& scan{scans_[info.scan_index]};
+    const uint32_t lines_per_interval{scan.parameters.restart_interval == 0 ? frame_info_.height
+                                                                            : scan.parameters.restart_interval};
+    decode_restart_interval(scan, info.first_line / lines_per_interval, destination, stride,
+                            {0, 0, static_cast<int32_t>(frame_info_.width), static_cast<int32_t>(frame_info_.height)});
+}
+
+
+void jpeg_stream_reader::read_scans(const size_t scan_count)
+{
+    // Locate all scans and their restart intervals first: the segments in front of every scan can change the
+    // coding parameters and need to be processed in byte stream order.
+    scans_.clear();
+    scans_.reserve(scan_count);
+    for (;;)
+    {
+        scans_.push_back({parameters_, get_validated_preset_coding_parameters(), {}});
+        find_restart_intervals(scans_.back());
+        state_ = state::scan_section;
+
+        if (scans_.size() == scan_count)
+            break;
+
+        read_next_start_of_scan();
+    }
+}
+
+
+void jpeg_stream_reader::decode_scans_in_parallel(const byte_span destination, const size_t stride,
+                                                  const size_t bytes_per_plane, const size_t scan_count)
+{
+    read_scans(scan_count);
+
+    // Every restart interval can be decoded independently as all context state is reset at a restart marker.
+    struct decode_task final
+    {
+        size_t scan_index;
+        uint32_t interval_index;
+    };
+
+    // Restart intervals that don't contain lines of the output rectangle don't need to be decoded.
+    internal_vector<decode_task> tasks;
+    for (size_t scan_index{}; scan_index != scans_.size(); ++scan_index)
+    {
+        const scan_info& scan{scans_[scan_index]};
+        for (size_t interval_index{}; interval_index != scan.restart_intervals.size(); ++interval_index)
+        {
+            const size_t first_line{interval_index * scan.parameters.restart_interval};
+            const size_t end_line{scan.parameters.restart_interval == 0 ? frame_info_.height
+                                                                         : first_line + scan.parameters.restart_interval};
+            if (end_line > static_cast<size_t>(rect_.Y) && first_line < static_cast<size_t>(rect_.Y) + rect_.Height)
+            {
+                tasks.push_back({scan_index, static_cast<uint32_t>(interval_index)});
+            }
+        }
+    }
+
+    parallel_for(tasks.size(), thread_count_, executor_, [&](const size_t index) {
+        const decode_task& task{tasks[index]};
+        const scan_info& scan{scans_[task.scan_index]};
+
+        // Position the destination at the first line of the interval that is part of the output rectangle.
+        const uint32_t first_line{task.interval_index * scan.parameters.restart_interval};
+        const auto rect_top{static_cast<uint32_t>(rect_.Y)};
+        const size_t skipped_line_count{
+            first_line > rect_top && first_line < rect_top + static_cast<uint32_t>(rect_.Height) ? first_line - rect_top
+                                                                                                 : 0};
+        byte_span interval_destination{destination};
+        skip_bytes(interval_destination, task.scan_index * bytes_per_plane + skipped_line_count * stride);
+
+        decode_restart_interval(scan, task.interval_index, interval_destination, stride, rect_);
+    });
+}
+
+
+void jpeg_stream_reader::decode_restart_interval(const scan_info& scan, const uint32_t interval_index,
+                                                 const byte_span destination, const size_t stride,
+                                                 const JlsRect& rect) const
+{
+    const restart_interval_position& interval{scan.restart_intervals[interval_index]};
+
+    const unique_ptr<decoder_strategy> codec{
+        jls_codec_factory<decoder_strategy>().create_codec(frame_info_, scan.parameters, scan.preset_coding_parameters)};
+    unique_ptr<process_line> process_line(codec->create_process_line(destination, stride));
+    const size_t bytes_read{codec->decode_restart_interval(std::move(process_line), rect,
+                                                           const_byte_span{interval.begin, end_position_}, interval_index)};
+
+    // The decoder stops at the first marker, which should be the marker that follows the interval.
+    if (UNLIKELY(static_cast<size_t>(interval.end - interval.begin) != bytes_read))
+        throw_jpegls_error(interval_index + 1 == scan.restart_intervals.size() ? jpegls_errc::jpeg_marker_start_byte_not_found
+                                                                               : jpegls_errc::restart_marker_not_found);
+}
+
+
+void jpeg_stream_reader::find_restart_intervals(scan_info& scan)
+{
+    const uint32_t restart_interval{scan.parameters.restart_interval};
+    const size_t interval_count{
+        restart_interval == 0 ? 1 : (frame_info_.height + static_cast<size_t>(restart_interval) - 1) / restart_interval};
+    scan.restart_intervals.reserve(interval_count);
+
+    auto interval_begin{position_};
+    for (;;)
+    {
+        const auto marker_code_position{find_next_marker()};
+        const auto marker_code{static_cast<jpeg_marker_code>(*marker_code_position)};
+        if (!is_restart_marker_code(marker_code) || scan.restart_intervals.size() + 1 == interval_count)
+            break;
+
+        if (UNLIKELY(static_cast<uint8_t>(marker_code) !=
+                     jpeg_restart_marker_base + scan.restart_intervals.size() % jpeg_restart_marker_range))
+            throw_jpegls_error(jpegls_errc::restart_marker_not_found);
+
+        scan.restart_intervals.push_back({interval_begin, position_});
+        position_ = marker_code_position + 1;
+        interval_begin = position_;
+    }
+
+    if (UNLIKELY(scan.restart_intervals.size() + 1 != interval_count))
+        throw_jpegls_error(jpegls_errc::restart_marker_not_found);
+
+    scan.restart_intervals.push_back({interval_begin, position_});
+}
+
+
+// Moves the position to the next marker in the entropy coded data and returns the position of its marker code.
+const_byte_span::iterator jpeg_stream_reader::find_next_marker()
+{
+    // Entropy coded data only contains 0xFF bytes followed by a byte with the high bit cleared (bit stuffing)
+    // or followed by a restart marker. Any other 0xFF byte is the start of the marker that ends the scan.
+    for (;;)
+    {
+        position_ = find(position_, end_position_, jpeg_marker_start_byte);
+        if (UNLIKELY(end_position_ - position_ < 2))
+            throw_jpegls_error(jpegls_errc::source_buffer_too_small);
+
+        auto marker_code_position{position_ + 1};
+        while (*marker_code_position == jpeg_marker_start_byte)
+        {
+            // Skip 0xFF fill bytes. (see ISO/IEC 10918-1, B.1.1.2)
+            ++marker_code_position;
+            if (UNLIKELY(marker_code_position == end_position_))
+                throw_jpegls_error(jpegls_errc::source_buffer_too_small);
+        }
+
+        if ((*marker_code_position & 0x80) != 0)
+            return marker_code_position;
+
+        position_ = marker_code_position;
+    }
+}
+
+
+const_byte_span::iterator
+jpeg_stream_reader::find_restart_interval_begin(const uint32_t interval_index,
+                                                const internal_vector<uint32_t>& restart_marker_index)
+{
+    ASSERT(interval_index != 0);
+
+    // Use the restart marker index (if present and valid) to prevent scanning the encoded data.
+    // The offsets of the index are relative to the start of the scan data and point to the restart markers.
+    const auto restart_marker{find_indexed_restart_marker(position_, restart_marker_index, interval_index - 1)};
+    if (restart_marker != end_position_)
+        return restart_marker + 2;
+
+    // Build the index by scanning the encoded data of the scan for the restart markers.
+    const auto scan_begin{position_};
+    scan_info scan{parameters_, {}, {}};
+    find_restart_intervals(scan);
+    position_ = scan_begin;
+    return scan.restart_intervals[interval_index].begin;
+}
+
+
+const_byte_span::iterator
+jpeg_stream_reader::find_indexed_restart_marker(const const_byte_span::iterator scan_begin,
+                                                const internal_vector<uint32_t>& restart_marker_index,
+                                                const size_t entry) const noexcept
+{
+    // The offsets of the index are relative to the start of the scan data and point to the restart markers.
+    // An entry is only used when it points to the expected restart marker.
+    if (entry >= restart_marker_index.size())
+        return end_position_;
+
+    const size_t offset{restart_marker_index[entry]};
+    if (offset + 2 > static_cast<size_t>(end_position_ - scan_begin) || scan_begin[offset] != jpeg_marker_start_byte ||
+        scan_begin[offset + 1] != jpeg_restart_marker_base + entry % jpeg_restart_marker_range)
+        return end_position_;
+
+    return scan_begin + offset;
+}
+
+
+void jpeg_stream_reader::skip_remaining_scan_data(const const_byte_span::iterator scan_begin,
+                                                  const internal_vector<uint32_t>& restart_marker_index)
+{
+    // Use the restart marker index (if present) to skip directly to the last restart interval.
+    if (!restart_marker_index.empty())
+    {
+        const auto last_restart_marker{
+            find_indexed_restart_marker(scan_begin, restart_marker_index, restart_marker_index.size() - 1)};
+        if (last_restart_marker != end_position_ && last_restart_marker > position_)
+        {
+            position_ = last_restart_marker + 2;
+        }
+    }
+
+    for (;;)
+    {
+        const auto marker_code_position{find_next_marker()};
+        if (!is_restart_marker_code(static_cast<jpeg_marker_code>(*marker_code_position)))
+            return;
+
+        position_ = marker_code_position + 1;
     }
 }
 
@@ -300,6 +681,10 @@ void jpeg_stream_reader::read_marker_segment(const jpeg_marker_code marker_code,
         try_read_application_data8_segment(header, spiff_header_found);
         break;
 
+    case jpeg_marker_code::application_data9:
+        try_read_application_data9_segment();
+        break;
+
     case jpeg_marker_code::comment:
         read_comment_segment();
         break;
@@ -312,7 +697,6 @@ void jpeg_stream_reader::read_marker_segment(const jpeg_marker_code marker_code,
     case jpeg_marker_code::application_data5:
     case jpeg_marker_code::application_data6:
     case jpeg_marker_code::application_data7:
-    case jpeg_marker_code::application_data9:
     case jpeg_marker_code::application_data10:
     case jpeg_marker_code::application_data11:
     case jpeg_marker_code::application_data12:
@@ -693,6 +1077,34 @@ void jpeg_stream_reader::try_read_hp_color_transform_segment()
 }
 
 
+void jpeg_stream_reader::try_read_application_data9_segment()
+{
+    call_application_data_callback(jpeg_marker_code::application_data9);
+
+    if (segment_data_.size() >= 4 && segment_data_.size() % sizeof(uint32_t) == 0)
+    {
+        try_read_restart_marker_index_segment();
+    }
+
+    skip_remaining_segment_data();
+}
+
+
+void jpeg_stream_reader::try_read_restart_marker_index_segment()
+{
+    const array<uint8_t, 4> restart_marker_index_tag{'r', 's', 't', 'i'};
+    if (!equal(restart_marker_index_tag.cbegin(), restart_marker_index_tag.cend(), read_bytes(4).begin()))
+        return;
+
+    // The index applies to the next scan. The offsets are validated when they are used.
+    restart_marker_index_.resize((segment_data_.size() - 4) / sizeof(uint32_t));
+    for (auto& offset : restart_marker_index_)
+    {
+        offset = read_uint32();
+    }
+}
+
+
 USE_DECL_ANNOTATIONS void jpeg_stream_reader::try_read_spiff_header_segment(spiff_header& header, bool& spiff_header_found)
 {
     ASSERT(segment_data_.size() >= 30);
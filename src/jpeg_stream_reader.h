@@ -7,6 +7,8 @@
 
 #include "byte_span.h"
 #include "coding_parameters.h"
+#include "internal_allocator.h"
+#include "jls_codec_factory.h"
 #include "util.h"
 
 #include <cstdint>
@@ -30,6 +32,11 @@ class jpeg_stream_reader final
 
     void source(const_byte_span source) noexcept;
 
+    /// <summary>
+    /// Resets the reader to read a new byte stream. The options, callbacks and the cached codec are kept.
+    /// </summary>
+    void reset() noexcept;
+
     const charls::frame_info& frame_info() const noexcept
     {
         return frame_info_;
@@ -55,6 +62,16 @@ class jpeg_stream_reader final
         rect_ = rect;
     }
 
+    void thread_count(const uint32_t value) noexcept
+    {
+        thread_count_ = value;
+    }
+
+    void executor(const charls_executor& value) noexcept
+    {
+        executor_ = value;
+    }
+
     void at_comment(const callback_function<at_comment_handler> at_comment_callback) noexcept
     {
         at_comment_callback_ = at_comment_callback;
@@ -67,9 +84,35 @@ class jpeg_stream_reader final
 
     void read_header(spiff_header* header = nullptr, bool* spiff_header_found = nullptr);
     void decode(byte_span destination, size_t stride);
+    void read_restart_intervals();
+    void decode_restart_interval(size_t index, byte_span destination, size_t stride) const;
     void read_end_of_image();
 
+    size_t restart_interval_count() const noexcept;
+    charls::restart_interval_info restart_interval_info(size_t index) const;
+
+    /// <summary>
+    /// Returns true when decoding stopped after the last line of the output rectangle, before the end of the last scan.
+    /// </summary>
+    bool stopped_after_region() const noexcept
+    {
+        return stopped_after_region_;
+    }
+
 private:
+    struct restart_interval_position final
+    {
+        const_byte_span::iterator begin;
+        const_byte_span::iterator end;
+    };
+
+    struct scan_info final
+    {
+        coding_parameters parameters;
+        jpegls_pc_parameters preset_coding_parameters;
+        internal_vector<restart_interval_position> restart_intervals;
+    };
+
     void advance_position(const size_t count) noexcept
     {
         ASSERT(position_ + count <= end_position_);
@@ -95,6 +138,19 @@ class jpeg_stream_reader final
     void check_minimal_segment_size(size_t minimum_size) const;
     void check_segment_size(size_t expected_size) const;
     void read_next_start_of_scan();
+    void read_scans(size_t scan_count);
+    void decode_scans_in_parallel(byte_span destination, size_t stride, size_t bytes_per_plane, size_t scan_count);
+    void decode_restart_interval(const scan_info& scan, uint32_t interval_index, byte_span destination, size_t stride,
+                                 const JlsRect& rect) const;
+    void find_restart_intervals(scan_info& scan);
+    CHARLS_CHECK_RETURN const_byte_span::iterator find_next_marker();
+    CHARLS_CHECK_RETURN const_byte_span::iterator
+    find_restart_interval_begin(uint32_t interval_index, const internal_vector<uint32_t>& restart_marker_index);
+    CHARLS_CHECK_RETURN const_byte_span::iterator
+    find_indexed_restart_marker(const_byte_span::iterator scan_begin,
+                                const internal_vector<uint32_t>& restart_marker_index, size_t entry) const noexcept;
+    void skip_remaining_scan_data(const_byte_span::iterator scan_begin,
+                                  const internal_vector<uint32_t>& restart_marker_index);
     CHARLS_CHECK_RETURN jpeg_marker_code read_next_marker_code();
     void validate_marker_code(jpeg_marker_code marker_code) const;
     CHARLS_CHECK_RETURN jpegls_pc_parameters get_validated_preset_coding_parameters() const;
@@ -112,6 +168,8 @@ class jpeg_stream_reader final
     void try_read_application_data8_segment(spiff_header* header, bool* spiff_header_found);
     void try_read_spiff_header_segment(CHARLS_OUT spiff_header& header, CHARLS_OUT bool& spiff_header_found);
     void try_read_hp_color_transform_segment();
+    void try_read_application_data9_segment();
+    void try_read_restart_marker_index_segment();
     void add_component(uint8_t component_id);
     void check_parameter_coherent() const;
     void check_interleave_mode(interleave_mode mode) const;
@@ -134,6 +192,7 @@ class jpeg_stream_reader final
         after_end_of_image
     };
 
+    const_byte_span::iterator source_begin_{};
     const_byte_span::iterator position_{};
     const_byte_span::iterator end_position_{};
     const_byte_span segment_data_;
@@ -141,8 +200,14 @@ class jpeg_stream_reader final
     coding_parameters parameters_{};
     jpegls_pc_parameters preset_coding_parameters_{};
     JlsRect rect_{};
-    std::vector<uint8_t> component_ids_;
+    uint32_t thread_count_{1};
+    charls_executor executor_{};
+    internal_vector<uint8_t> component_ids_;
+    internal_vector<scan_info> scans_;
+    internal_vector<uint32_t> restart_marker_index_;
     state state_{};
+    bool stopped_after_region_{};
+    jls_codec_cache<decoder_strategy> codec_cache_;
     callback_function<at_comment_handler> at_comment_callback_{};
     callback_function<at_application_data_handler> at_application_data_callback_{};
 };
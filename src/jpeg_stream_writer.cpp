@@ -191,6 +191,85 @@ void jpeg_stream_writer::write_start_of_scan_segment(const int32_t component_cou
     write_uint8(near_lossless);                       // NEAR parameter
     write_uint8(to_underlying_type(interleave_mode)); // ILV parameter
     write_uint8(0);                                   // transformation
+
+    scan_data_offset_ = byte_offset_;
+}
+
+
+void jpeg_stream_writer::write_restart_marker_index_segment(const size_t restart_marker_count)
+{
+    const array<uint8_t, 4> restart_marker_index_tag{'r', 's', 't', 'i'};
+
+    const size_t data_size{restart_marker_index_tag.size() + (restart_marker_count * sizeof(uint32_t))};
+    write_segment_header(jpeg_marker_code::application_data9, data_size);
+    write_bytes(restart_marker_index_tag.data(), restart_marker_index_tag.size());
+
+    // Reserve room for the offsets, the actual offsets are only known after the scan has been encoded.
+    restart_marker_index_offset_ = byte_offset_;
+    restart_marker_count_ = restart_marker_count;
+    memset(destination_.data + byte_offset_, 0, restart_marker_count * sizeof(uint32_t));
+    byte_offset_ += restart_marker_count * sizeof(uint32_t);
+}
+
+
+void jpeg_stream_writer::complete_restart_marker_index() noexcept
+{
+    if (restart_marker_index_offset_ == 0)
+        return;
+
+    // Entropy coded data only contains 0xFF bytes followed by a byte with the high bit cleared (bit stuffing)
+    // or followed by a marker. The offsets are relative to the start of the scan data.
+    const size_t scan_end_offset{byte_offset_};
+    size_t restart_marker_count{};
+    for (size_t offset{scan_data_offset_}; offset + 1 < scan_end_offset; ++offset)
+    {
+        const uint8_t marker_code{destination_.data[offset + 1]};
+        if (destination_.data[offset] != jpeg_marker_start_byte || marker_code < jpeg_restart_marker_base ||
+            marker_code >= jpeg_restart_marker_base + jpeg_restart_marker_range)
+            continue;
+
+        ASSERT(restart_marker_count < restart_marker_count_);
+        byte_offset_ = restart_marker_index_offset_ + (restart_marker_count * sizeof(uint32_t));
+        write_uint32(static_cast<uint32_t>(offset - scan_data_offset_));
+        ++restart_marker_count;
+        ++offset;
+    }
+    ASSERT(restart_marker_count == restart_marker_count_);
+
+    byte_offset_ = scan_end_offset;
+    restart_marker_index_offset_ = 0;
+}
+
+
+void jpeg_stream_writer::write_define_restart_interval_segment(const uint32_t restart_interval)
+{
+    // Format is defined in ISO/IEC 14495-1, C.2.5 (extends T.81, B.2.4.4): Ri can be stored in 2, 3 or 4 bytes.
+    if (restart_interval <= numeric_limits<uint16_t>::max())
+    {
+        write_segment_header(jpeg_marker_code::define_restart_interval, sizeof(uint16_t));
+        write_uint16(restart_interval);
+    }
+    else
+    {
+        write_segment_header(jpeg_marker_code::define_restart_interval, sizeof(uint32_t));
+        write_uint32(restart_interval);
+    }
+}
+
+
+void jpeg_stream_writer::write_restart_marker(const uint32_t restart_marker_index)
+{
+    ASSERT(restart_marker_index < jpeg_restart_marker_range);
+    write_segment_without_data(static_cast<jpeg_marker_code>(jpeg_restart_marker_base + restart_marker_index));
+}
+
+
+void jpeg_stream_writer::write_entropy_coded_data(const const_byte_span data)
+{
+    if (UNLIKELY(byte_offset_ + data.size() > destination_.size))
+        impl::throw_jpegls_error(jpegls_errc::destination_buffer_too_small);
+
+    write_bytes(data);
 }
 
 
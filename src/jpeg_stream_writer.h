@@ -91,8 +91,39 @@ class jpeg_stream_writer final
     /// <param name="interleave_mode">The interleave mode of the components.</param>
     void write_start_of_scan_segment(int32_t component_count, int32_t near_lossless, interleave_mode interleave_mode);
 
+    /// <summary>
+    /// Writes a JPEG Define Restart Interval (DRI) segment.
+    /// </summary>
+    /// <param name="restart_interval">The number of lines in a restart interval.</param>
+    void write_define_restart_interval_segment(uint32_t restart_interval);
+
+    /// <summary>
+    /// Writes a JPEG Restart (RSTm) marker.
+    /// </summary>
+    /// <param name="restart_marker_index">The modulo 8 index of the restart marker.</param>
+    void write_restart_marker(uint32_t restart_marker_index);
+
+    /// <summary>
+    /// Writes a restart marker index (APP9) segment with room for the byte offsets of the restart markers of the next scan.
+    /// The offsets are filled in by complete_restart_marker_index, after the scan has been written.
+    /// </summary>
+    /// <param name="restart_marker_count">The number of restart markers in the next scan.</param>
+    void write_restart_marker_index_segment(size_t restart_marker_count);
+
+    /// <summary>
+    /// Fills the restart marker index segment of the last written scan with the offsets of its restart markers.
+    /// Does nothing when no restart marker index segment is pending.
+    /// </summary>
+    void complete_restart_marker_index() noexcept;
+
     void write_end_of_image(bool even_destination_size);
 
+    /// <summary>
+    /// Writes entropy coded data that has been encoded into a separate buffer.
+    /// </summary>
+    /// <param name="data">The encoded bytes of a scan.</param>
+    void write_entropy_coded_data(const_byte_span data);
+
     size_t bytes_written() const noexcept
     {
         return byte_offset_;
@@ -118,6 +149,7 @@ class jpeg_stream_writer final
     {
         byte_offset_ = 0;
         component_id_ = 1;
+        restart_marker_index_offset_ = 0;
     }
 
 private:
@@ -207,6 +239,9 @@ class jpeg_stream_writer final
 
     byte_span destination_{};
     size_t byte_offset_{};
+    size_t scan_data_offset_{};
+    size_t restart_marker_index_offset_{};
+    size_t restart_marker_count_{};
     uint8_t component_id_{1};
 };
 
@@ -11,54 +11,19 @@
 #include "util.h"
 
 #include <array>
-#include <vector>
 
 namespace charls {
 
 using std::array;
 using std::make_unique;
 using std::unique_ptr;
-using std::vector;
 
 namespace {
 
-// See JPEG-LS standard ISO/IEC 14495-1, A.3.3, golomb_code Segment A.4
-int8_t quantize_gradient_org(const jpegls_pc_parameters& preset, const int32_t di) noexcept
-{
-    constexpr int32_t near_lossless{};
-
-    if (di <= -preset.threshold3)
-        return -4;
-    if (di <= -preset.threshold2)
-        return -3;
-    if (di <= -preset.threshold1)
-        return -2;
-    if (di < -near_lossless)
-        return -1;
-    if (di <= near_lossless)
-        return 0;
-    if (di < preset.threshold1)
-        return 1;
-    if (di < preset.threshold2)
-        return 2;
-    if (di < preset.threshold3)
-        return 3;
-
-    return 4;
-}
-
-vector<int8_t> create_quantize_lut_lossless(const int32_t bit_count)
+quantization_lut create_quantization_lut_lossless(const int32_t bit_count)
 {
     const jpegls_pc_parameters preset{compute_default(calculate_maximum_sample_value(bit_count), 0)};
-    const int32_t range{preset.maximum_sample_value + 1};
-
-    vector<int8_t> lut(static_cast<size_t>(range) * 2);
-    for (size_t i{}; i != lut.size(); ++i)
-    {
-        lut[i] = quantize_gradient_org(preset, static_cast<int32_t>(i) - range);
-    }
-
-    return lut;
+    return {preset.threshold1, preset.threshold2, preset.threshold3, 0, bit_count};
 }
 
 template<typename Strategy, typename Traits>
@@ -83,11 +48,11 @@ golomb_code_table initialize_table(const int32_t k) noexcept
         // Q is not used when k != 0
         const int32_t mapped_error_value{map_error_value(error_value)};
         const std::pair<int32_t, int32_t> pair_code{create_encoded_value(k, mapped_error_value)};
-        if (static_cast<size_t>(pair_code.first) > golomb_code_table::byte_bit_count)
+        if (static_cast<size_t>(pair_code.first) > golomb_code_table::bit_count)
             break;
 
         const golomb_code code(error_value, conditional_static_cast<int16_t>(pair_code.first));
-        table.add_entry(static_cast<uint8_t>(pair_code.second), code);
+        table.add_entry(static_cast<uint32_t>(pair_code.second), code);
     }
 
     for (int16_t error_value{-1};; --error_value)
@@ -95,43 +60,77 @@ golomb_code_table initialize_table(const int32_t k) noexcept
         // Q is not used when k != 0
         const int32_t mapped_error_value{map_error_value(error_value)};
         const std::pair<int32_t, int32_t> pair_code{create_encoded_value(k, mapped_error_value)};
-        if (static_cast<size_t>(pair_code.first) > golomb_code_table::byte_bit_count)
+        if (static_cast<size_t>(pair_code.first) > golomb_code_table::bit_count)
             break;
 
         const auto code{golomb_code(error_value, static_cast<int16_t>(pair_code.first))};
-        table.add_entry(static_cast<uint8_t>(pair_code.second), code);
+        table.add_entry(static_cast<uint32_t>(pair_code.second), code);
     }
 
     return table;
 }
 
+// A codec can be reused when it would be constructed with the same arguments: the thresholds and the restart interval
+// are (re)applied by set_presets.
+bool is_same_codec(const frame_info& frame1, const coding_parameters& parameters1,
+                   const jpegls_pc_parameters& presets1, const frame_info& frame2,
+                   const coding_parameters& parameters2, const jpegls_pc_parameters& presets2) noexcept
+{
+    return frame1.width == frame2.width && frame1.height == frame2.height &&
+           frame1.bits_per_sample == frame2.bits_per_sample && frame1.component_count == frame2.component_count &&
+           parameters1.near_lossless == parameters2.near_lossless &&
+           parameters1.interleave_mode == parameters2.interleave_mode &&
+           parameters1.transformation == parameters2.transformation && parameters1.output_bgr == parameters2.output_bgr &&
+           parameters1.validate_sample_values == parameters2.validate_sample_values &&
+           presets1.maximum_sample_value == presets2.maximum_sample_value &&
+           presets1.reset_value == presets2.reset_value;
+}
+
 
 } // namespace
 
 
 // Lookup tables to replace code with lookup tables.
-// To avoid threading issues, all tables are created when the program is loaded.
+// The tables are created the first time they are needed (thread safe static initialization): processes that load the
+// library but don't decode (or use other bit counts) don't spend time and memory on them.
 
-// Lookup table: decode symbols that are smaller or equal to 8 bit (16 tables for each value of k)
-// NOLINTNEXTLINE(clang-diagnostic-global-constructors)
-const array<golomb_code_table, max_k_value> decoding_tables{
-    initialize_table(0),  initialize_table(1),  initialize_table(2),  initialize_table(3),
-    initialize_table(4),  initialize_table(5),  initialize_table(6),  initialize_table(7),
-    initialize_table(8),  initialize_table(9),  initialize_table(10), initialize_table(11),
-    initialize_table(12), initialize_table(13), initialize_table(14), initialize_table(15)};
+// Lookup table: decode symbols that are smaller or equal to golomb_code_table::bit_count bits (16 tables for each value
+// of k)
+const golomb_code_table* golomb_decoding_tables()
+{
+    static const array<golomb_code_table, max_k_value> tables{
+        initialize_table(0),  initialize_table(1),  initialize_table(2),  initialize_table(3),
+        initialize_table(4),  initialize_table(5),  initialize_table(6),  initialize_table(7),
+        initialize_table(8),  initialize_table(9),  initialize_table(10), initialize_table(11),
+        initialize_table(12), initialize_table(13), initialize_table(14), initialize_table(15)};
+    return tables.data();
+}
 
 // Lookup tables: sample differences to bin indexes.
-// NOLINTNEXTLINE(clang-diagnostic-global-constructors)
-const vector<int8_t> quantization_lut_lossless_8{create_quantize_lut_lossless(8)};
-
-// NOLINTNEXTLINE(clang-diagnostic-global-constructors)
-const vector<int8_t> quantization_lut_lossless_10{create_quantize_lut_lossless(10)};
-
-// NOLINTNEXTLINE(clang-diagnostic-global-constructors)
-const vector<int8_t> quantization_lut_lossless_12{create_quantize_lut_lossless(12)};
-
-// NOLINTNEXTLINE(clang-diagnostic-global-constructors)
-const vector<int8_t> quantization_lut_lossless_16{create_quantize_lut_lossless(16)};
+const int8_t* quantization_lut_lossless(const int32_t bits_per_pixel)
+{
+    switch (bits_per_pixel)
+    {
+    case 8: {
+        static const quantization_lut lut{create_quantization_lut_lossless(8)};
+        return lut.center();
+    }
+    case 10: {
+        static const quantization_lut lut{create_quantization_lut_lossless(10)};
+        return lut.center();
+    }
+    case 12: {
+        static const quantization_lut lut{create_quantization_lut_lossless(12)};
+        return lut.center();
+    }
+    case 16: {
+        static const quantization_lut lut{create_quantization_lut_lossless(16)};
+        return lut.center();
+    }
+    default:
+        return nullptr;
+    }
+}
 
 
 template<typename Strategy>
@@ -248,7 +247,41 @@ unique_ptr<Strategy> jls_codec_factory<Strategy>::try_create_optimized_codec(con
 }
 
 
+template<typename Strategy>
+jls_codec_cache<Strategy>::jls_codec_cache() noexcept = default;
+
+template<typename Strategy>
+jls_codec_cache<Strategy>::~jls_codec_cache() = default;
+
+template<typename Strategy>
+jls_codec_cache<Strategy>::jls_codec_cache(jls_codec_cache&&) noexcept = default;
+
+template<typename Strategy>
+jls_codec_cache<Strategy>& jls_codec_cache<Strategy>::operator=(jls_codec_cache&&) noexcept = default;
+
+template<typename Strategy>
+Strategy& jls_codec_cache<Strategy>::get_codec(const frame_info& frame, const coding_parameters& parameters,
+                                               const jpegls_pc_parameters& preset_coding_parameters)
+{
+    if (codec_ && is_same_codec(frame_info_, parameters_, preset_coding_parameters_, frame, parameters,
+                                preset_coding_parameters))
+    {
+        codec_->set_presets(preset_coding_parameters, parameters.restart_interval);
+        return *codec_;
+    }
+
+    codec_.reset();
+    codec_ = jls_codec_factory<Strategy>().create_codec(frame, parameters, preset_coding_parameters);
+    frame_info_ = frame;
+    parameters_ = parameters;
+    preset_coding_parameters_ = preset_coding_parameters;
+    return *codec_;
+}
+
+
 template class jls_codec_factory<decoder_strategy>;
 template class jls_codec_factory<encoder_strategy>;
+template class jls_codec_cache<decoder_strategy>;
+template class jls_codec_cache<encoder_strategy>;
 
 } // namespace charls
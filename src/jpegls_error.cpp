@@ -77,6 +77,9 @@ const char* CHARLS_API_CALLING_CONVENTION charls_get_error_message(const charls_
     case jpegls_errc::invalid_argument_encoding_options:
         return "The encoding options argument has an invalid value";
 
+    case jpegls_errc::invalid_argument_sample_value:
+        return "The source contains a sample value that cannot be stored in bits per sample bits";
+
     case jpegls_errc::start_of_image_marker_not_found:
         return "Invalid JPEG-LS stream: first JPEG marker is not a Start Of Image (SOI) marker";
 
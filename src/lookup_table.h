@@ -8,16 +8,21 @@
 
 #include <array>
 #include <cassert>
+#include <limits>
 
 namespace charls {
 
 // Tables for fast decoding of short Golomb Codes.
+// Note: the entries are kept small (4 bytes) to keep the tables that are in use in the L1 data cache.
 struct golomb_code final
 {
     golomb_code() = default;
 
-    golomb_code(const int32_t value, const uint32_t length) noexcept : value_{value}, length_{length}
+    golomb_code(const int32_t value, const uint32_t length) noexcept :
+        value_{static_cast<int16_t>(value)}, length_{static_cast<uint16_t>(length)}
     {
+        ASSERT(value >= std::numeric_limits<int16_t>::min() && value <= std::numeric_limits<int16_t>::max());
+        ASSERT(length <= std::numeric_limits<uint16_t>::max());
     }
 
     int32_t value() const noexcept
@@ -31,35 +36,47 @@ struct golomb_code final
     }
 
 private:
-    int32_t value_{};
-    uint32_t length_{};
+    int16_t value_{};
+    uint16_t length_{};
 };
 
+static_assert(sizeof(golomb_code) == 4, "golomb_code should be 4 bytes");
+
+
+// The number of bits used to look up a Golomb code: codes with more bits are decoded by reading the bits.
+// Wider tables decode more codes with a single lookup (images with a higher bits per sample use larger values of k),
+// but need more memory: (1 << bit count) entries of 4 bytes for each of the 16 values of k.
+// The default of 8 bits needs 16 KB and keeps the tables resident in the L1 data cache. 12 bits (256 KB) only
+// decodes noisy images with 12 or 16 bits per sample faster.
+#ifndef CHARLS_GOLOMB_TABLE_BIT_COUNT
+#define CHARLS_GOLOMB_TABLE_BIT_COUNT 8
+#endif
 
 class golomb_code_table final
 {
 public:
-    static constexpr size_t byte_bit_count{8};
+    static constexpr size_t bit_count{CHARLS_GOLOMB_TABLE_BIT_COUNT};
+    static_assert(bit_count >= 8 && bit_count <= 16, "The decoder requires a table bit count between 8 and 16");
 
-    void add_entry(const uint8_t value, const golomb_code c) noexcept
+    void add_entry(const uint32_t value, const golomb_code c) noexcept
     {
         const uint32_t length{c.length()};
-        ASSERT(static_cast<size_t>(length) <= byte_bit_count);
+        ASSERT(static_cast<size_t>(length) <= bit_count);
 
-        for (size_t i{}; i < conditional_static_cast<size_t>(1U) << (byte_bit_count - length); ++i)
+        for (size_t i{}; i < conditional_static_cast<size_t>(1U) << (bit_count - length); ++i)
         {
-            ASSERT(types_[(static_cast<size_t>(value) << (byte_bit_count - length)) + i].length() == 0);
-            types_[(static_cast<size_t>(value) << (byte_bit_count - length)) + i] = c;
+            ASSERT(types_[(static_cast<size_t>(value) << (bit_count - length)) + i].length() == 0);
+            types_[(static_cast<size_t>(value) << (bit_count - length)) + i] = c;
         }
     }
 
-    FORCE_INLINE const golomb_code& get(const uint32_t value) const noexcept
+    FORCE_INLINE golomb_code get(const uint32_t value) const noexcept
     {
         return types_[value];
     }
 
 private:
-    std::array<golomb_code, 1 << byte_bit_count> types_;
+    std::array<golomb_code, 1 << bit_count> types_;
 };
 
 } // namespace charls
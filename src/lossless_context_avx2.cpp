@@ -0,0 +1,192 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "lossless_context_simd.h"
+
+#include "cpu_features.h"
+
+// Note: MSVC can generate AVX2 instructions without additional compiler options, other compilers need -mavx2.
+#if defined(__AVX2__) || (defined(CHARLS_X86_SIMD) && defined(_MSC_VER) && !defined(__clang__))
+#define CHARLS_AVX2_KERNELS
+#endif
+
+#ifdef CHARLS_AVX2_KERNELS
+
+#include "lossless_context_simd_kernels.h"
+
+#include <immintrin.h>
+
+namespace charls {
+
+namespace {
+
+struct avx2_operations
+{
+    using vector = __m256i;
+
+    static void complete() noexcept
+    {
+        // Prevents the performance penalty of mixing AVX and legacy SSE instructions in the calling code.
+        _mm256_zeroupper();
+    }
+
+protected:
+    static __m128i load_16_bytes(const void* source) noexcept
+    {
+        return _mm_loadu_si128(static_cast<const __m128i*>(source));
+    }
+
+    static void store_16_bytes(void* destination, const __m128i value) noexcept
+    {
+        _mm_storeu_si128(static_cast<__m128i*>(destination), value);
+    }
+
+    // The pack instructions operate per 128-bit lane: move the packed results of both lanes into the low lane.
+    static __m128i join_packed_lanes(const vector packed) noexcept
+    {
+        return _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0b1000));
+    }
+};
+
+
+template<typename SampleType>
+struct vector_operations;
+
+// 8-bit samples are processed in 16-bit lanes.
+template<>
+struct vector_operations<uint8_t> final : avx2_operations
+{
+    using sample_type = uint8_t;
+    static constexpr size_t pixels_per_block{16};
+
+    static vector load(const uint8_t* source) noexcept
+    {
+        return _mm256_cvtepu8_epi16(load_16_bytes(source));
+    }
+
+    static void store_samples(uint8_t* destination, const vector value) noexcept
+    {
+        store_16_bytes(destination, join_packed_lanes(_mm256_packus_epi16(value, value)));
+    }
+
+    static void store_context_ids(int16_t* destination, const vector value) noexcept
+    {
+        _mm256_storeu_si256(static_cast<vector*>(static_cast<void*>(destination)), value);
+    }
+
+    static vector set1(const int32_t value) noexcept
+    {
+        return _mm256_set1_epi16(static_cast<short>(value));
+    }
+
+    static vector add(const vector a, const vector b) noexcept
+    {
+        return _mm256_add_epi16(a, b);
+    }
+
+    static vector sub(const vector a, const vector b) noexcept
+    {
+        return _mm256_sub_epi16(a, b);
+    }
+
+    static vector multiply(const vector a, const vector b) noexcept
+    {
+        return _mm256_mullo_epi16(a, b);
+    }
+
+    static vector min(const vector a, const vector b) noexcept
+    {
+        return _mm256_min_epi16(a, b);
+    }
+
+    static vector max(const vector a, const vector b) noexcept
+    {
+        return _mm256_max_epi16(a, b);
+    }
+
+    static vector compare_greater(const vector a, const vector b) noexcept
+    {
+        return _mm256_cmpgt_epi16(a, b);
+    }
+};
+
+// 16-bit samples are processed in 32-bit lanes.
+template<>
+struct vector_operations<uint16_t> final : avx2_operations
+{
+    using sample_type = uint16_t;
+    static constexpr size_t pixels_per_block{8};
+
+    static vector load(const uint16_t* source) noexcept
+    {
+        return _mm256_cvtepu16_epi32(load_16_bytes(source));
+    }
+
+    static void store_samples(uint16_t* destination, const vector value) noexcept
+    {
+        store_16_bytes(destination, join_packed_lanes(_mm256_packus_epi32(value, value)));
+    }
+
+    static void store_context_ids(int16_t* destination, const vector value) noexcept
+    {
+        store_16_bytes(destination, join_packed_lanes(_mm256_packs_epi32(value, value)));
+    }
+
+    static vector set1(const int32_t value) noexcept
+    {
+        return _mm256_set1_epi32(value);
+    }
+
+    static vector add(const vector a, const vector b) noexcept
+    {
+        return _mm256_add_epi32(a, b);
+    }
+
+    static vector sub(const vector a, const vector b) noexcept
+    {
+        return _mm256_sub_epi32(a, b);
+    }
+
+    static vector multiply(const vector a, const vector b) noexcept
+    {
+        return _mm256_mullo_epi32(a, b);
+    }
+
+    static vector min(const vector a, const vector b) noexcept
+    {
+        return _mm256_min_epi32(a, b);
+    }
+
+    static vector max(const vector a, const vector b) noexcept
+    {
+        return _mm256_max_epi32(a, b);
+    }
+
+    static vector compare_greater(const vector a, const vector b) noexcept
+    {
+        return _mm256_cmpgt_epi32(a, b);
+    }
+};
+
+} // namespace
+
+
+lossless_context_kernel select_lossless_context_kernel_avx2(const size_t bytes_per_sample) noexcept
+{
+    return simd::select_kernel<vector_operations>(bytes_per_sample);
+}
+
+} // namespace charls
+
+#else
+
+namespace charls {
+
+lossless_context_kernel select_lossless_context_kernel_avx2(size_t /* bytes_per_sample */) noexcept
+{
+    return nullptr;
+}
+
+} // namespace charls
+
+#endif
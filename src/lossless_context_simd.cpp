@@ -0,0 +1,24 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "lossless_context_simd.h"
+
+#include "cpu_features.h"
+
+namespace charls {
+
+lossless_context_kernel select_lossless_context_kernel(const size_t bytes_per_sample) noexcept
+{
+    if (cpu_supports_avx2())
+    {
+        if (const auto kernel{select_lossless_context_kernel_avx2(bytes_per_sample)})
+            return kernel;
+    }
+
+    if (cpu_supports_sse41())
+        return select_lossless_context_kernel_sse41(bytes_per_sample);
+
+    return nullptr;
+}
+
+} // namespace charls
@@ -0,0 +1,35 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace charls {
+
+// This file defines the interface to the vectorized (SSE4.1 and AVX2) computation of the contexts of a lossless scan.
+// In lossless mode the reconstructed samples are equal to the source samples: the encoder can compute the context id
+// and the predicted value of every pixel of a line before the line is encoded.
+
+/// <summary>
+/// Computes the context ids (ISO/IEC 14495-1, A.3) and the predicted values (A.4) of the pixels of complete blocks and
+/// returns the number of processed pixels.
+/// The previous line must be readable from index -1 up to and including index pixel_count, the current line from
+/// index -1. The thresholds are the quantization thresholds T1, T2 and T3.
+/// </summary>
+using lossless_context_kernel = size_t (*)(const void* previous_line, const void* current_line, size_t pixel_count,
+                                           int32_t threshold1, int32_t threshold2, int32_t threshold3,
+                                           int16_t* context_ids, void* predicted_values);
+
+/// <summary>
+/// Returns the fastest kernel the CPU supports or nullptr when no vectorized kernel is available.
+/// </summary>
+lossless_context_kernel select_lossless_context_kernel(size_t bytes_per_sample) noexcept;
+
+// Instruction set specific selection functions, return nullptr when the compiler cannot generate the instructions.
+// Note: the caller needs to check that the CPU supports the instruction set.
+lossless_context_kernel select_lossless_context_kernel_sse41(size_t bytes_per_sample) noexcept;
+lossless_context_kernel select_lossless_context_kernel_avx2(size_t bytes_per_sample) noexcept;
+
+} // namespace charls
@@ -0,0 +1,112 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "lossless_context_simd.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// This file defines the instruction set independent part of the vectorized context computation.
+// Just like color_transform_simd_kernels.h, it is only included by the instruction set specific source files, which
+// provide a vector_operations<SampleType> class template, defined in an anonymous namespace. The templates below are
+// also defined in an anonymous namespace: every source file gets its own instantiations.
+//
+// The samples are widened to lanes that can hold the difference of 2 samples (16-bit lanes for 8-bit samples, 32-bit
+// lanes for 16-bit samples). Every lane of a compare result is 0 or -1: the quantized gradient is computed by
+// counting the thresholds that are passed in the positive and negative direction.
+
+namespace charls { namespace simd {
+
+namespace { // NOLINT(cert-dcl59-cpp, google-build-namespaces): local to every instruction set specific source file.
+
+template<typename Ops>
+struct gradient_quantizer final
+{
+    using vector = typename Ops::vector;
+
+    gradient_quantizer(const int32_t threshold1, const int32_t threshold2, const int32_t threshold3) noexcept :
+        zero_{Ops::set1(0)},
+        positive_{Ops::set1(threshold1 - 1), Ops::set1(threshold2 - 1), Ops::set1(threshold3 - 1)},
+        negative_{Ops::set1(1 - threshold1), Ops::set1(1 - threshold2), Ops::set1(1 - threshold3)}
+    {
+    }
+
+    // Vectorized equivalent of quantize_gradient_org for lossless scans (near_lossless = 0).
+    vector operator()(const vector di) const noexcept
+    {
+        vector positive{Ops::compare_greater(di, zero_)};
+        vector negative{Ops::compare_greater(zero_, di)};
+        for (size_t i{}; i != 3; ++i)
+        {
+            positive = Ops::add(positive, Ops::compare_greater(di, positive_[i]));
+            negative = Ops::add(negative, Ops::compare_greater(negative_[i], di));
+        }
+
+        return Ops::sub(negative, positive);
+    }
+
+private:
+    vector zero_;
+    vector positive_[3];
+    vector negative_[3];
+};
+
+
+template<typename Ops>
+size_t compute_lossless_contexts(const void* previous_line, const void* current_line, const size_t pixel_count,
+                                 const int32_t threshold1, const int32_t threshold2, const int32_t threshold3,
+                                 int16_t* context_ids, void* predicted_values) noexcept
+{
+    using sample_type = typename Ops::sample_type;
+    using vector = typename Ops::vector;
+
+    const auto* previous{static_cast<const sample_type*>(previous_line)};
+    const auto* current{static_cast<const sample_type*>(current_line)};
+    auto* predicted{static_cast<sample_type*>(predicted_values)};
+    const gradient_quantizer<Ops> quantize_gradient(threshold1, threshold2, threshold3);
+    const vector nine{Ops::set1(9)};
+
+    size_t i{};
+    for (; i + Ops::pixels_per_block <= pixel_count; i += Ops::pixels_per_block)
+    {
+        const vector ra{Ops::load(current + i - 1)};
+        const vector rc{Ops::load(previous + i - 1)};
+        const vector rb{Ops::load(previous + i)};
+        const vector rd{Ops::load(previous + i + 1)};
+
+        // compute_context_id: (q1 * 9 + q2) * 9 + q3
+        vector context_id{Ops::multiply(quantize_gradient(Ops::sub(rd, rb)), nine)};
+        context_id = Ops::multiply(Ops::add(context_id, quantize_gradient(Ops::sub(rb, rc))), nine);
+        context_id = Ops::add(context_id, quantize_gradient(Ops::sub(rc, ra)));
+        Ops::store_context_ids(context_ids + i, context_id);
+
+        // The median edge detector of get_predicted_value, written as: clamp(ra + rb - rc, min(ra, rb), max(ra, rb)).
+        const vector gradient_prediction{Ops::sub(Ops::add(ra, rb), rc)};
+        Ops::store_samples(predicted + i,
+                           Ops::min(Ops::max(gradient_prediction, Ops::min(ra, rb)), Ops::max(ra, rb)));
+    }
+
+    Ops::complete();
+    return i;
+}
+
+
+template<template<typename> class VectorOperations>
+lossless_context_kernel select_kernel(const size_t bytes_per_sample) noexcept
+{
+    switch (bytes_per_sample)
+    {
+    case sizeof(uint8_t):
+        return &compute_lossless_contexts<VectorOperations<uint8_t>>;
+    case sizeof(uint16_t):
+        return &compute_lossless_contexts<VectorOperations<uint16_t>>;
+    default:
+        return nullptr;
+    }
+}
+
+} // namespace
+
+}} // namespace charls::simd
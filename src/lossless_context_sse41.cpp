@@ -0,0 +1,184 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "lossless_context_simd.h"
+
+#include "cpu_features.h"
+
+// Note: MSVC can generate SSE4.1 instructions without additional compiler options, other compilers need -msse4.1.
+#if defined(__SSE4_1__) || (defined(CHARLS_X86_SIMD) && defined(_MSC_VER) && !defined(__clang__))
+#define CHARLS_SSE41_KERNELS
+#endif
+
+#ifdef CHARLS_SSE41_KERNELS
+
+#include "lossless_context_simd_kernels.h"
+
+#include <smmintrin.h>
+
+namespace charls {
+
+namespace {
+
+struct sse41_operations
+{
+    using vector = __m128i;
+
+    static void complete() noexcept
+    {
+    }
+
+protected:
+    static __m128i load_8_bytes(const void* source) noexcept
+    {
+        return _mm_loadl_epi64(static_cast<const __m128i*>(source));
+    }
+
+    static void store_8_bytes(void* destination, const __m128i value) noexcept
+    {
+        _mm_storel_epi64(static_cast<__m128i*>(destination), value);
+    }
+};
+
+
+template<typename SampleType>
+struct vector_operations;
+
+// 8-bit samples are processed in 16-bit lanes.
+template<>
+struct vector_operations<uint8_t> final : sse41_operations
+{
+    using sample_type = uint8_t;
+    static constexpr size_t pixels_per_block{8};
+
+    static vector load(const uint8_t* source) noexcept
+    {
+        return _mm_cvtepu8_epi16(load_8_bytes(source));
+    }
+
+    static void store_samples(uint8_t* destination, const vector value) noexcept
+    {
+        store_8_bytes(destination, _mm_packus_epi16(value, value));
+    }
+
+    static void store_context_ids(int16_t* destination, const vector value) noexcept
+    {
+        _mm_storeu_si128(static_cast<vector*>(static_cast<void*>(destination)), value);
+    }
+
+    static vector set1(const int32_t value) noexcept
+    {
+        return _mm_set1_epi16(static_cast<short>(value));
+    }
+
+    static vector add(const vector a, const vector b) noexcept
+    {
+        return _mm_add_epi16(a, b);
+    }
+
+    static vector sub(const vector a, const vector b) noexcept
+    {
+        return _mm_sub_epi16(a, b);
+    }
+
+    static vector multiply(const vector a, const vector b) noexcept
+    {
+        return _mm_mullo_epi16(a, b);
+    }
+
+    static vector min(const vector a, const vector b) noexcept
+    {
+        return _mm_min_epi16(a, b);
+    }
+
+    static vector max(const vector a, const vector b) noexcept
+    {
+        return _mm_max_epi16(a, b);
+    }
+
+    static vector compare_greater(const vector a, const vector b) noexcept
+    {
+        return _mm_cmpgt_epi16(a, b);
+    }
+};
+
+// 16-bit samples are processed in 32-bit lanes.
+template<>
+struct vector_operations<uint16_t> final : sse41_operations
+{
+    using sample_type = uint16_t;
+    static constexpr size_t pixels_per_block{4};
+
+    static vector load(const uint16_t* source) noexcept
+    {
+        return _mm_cvtepu16_epi32(load_8_bytes(source));
+    }
+
+    static void store_samples(uint16_t* destination, const vector value) noexcept
+    {
+        store_8_bytes(destination, _mm_packus_epi32(value, value));
+    }
+
+    static void store_context_ids(int16_t* destination, const vector value) noexcept
+    {
+        store_8_bytes(destination, _mm_packs_epi32(value, value));
+    }
+
+    static vector set1(const int32_t value) noexcept
+    {
+        return _mm_set1_epi32(value);
+    }
+
+    static vector add(const vector a, const vector b) noexcept
+    {
+        return _mm_add_epi32(a, b);
+    }
+
+    static vector sub(const vector a, const vector b) noexcept
+    {
+        return _mm_sub_epi32(a, b);
+    }
+
+    static vector multiply(const vector a, const vector b) noexcept
+    {
+        return _mm_mullo_epi32(a, b);
+    }
+
+    static vector min(const vector a, const vector b) noexcept
+    {
+        return _mm_min_epi32(a, b);
+    }
+
+    static vector max(const vector a, const vector b) noexcept
+    {
+        return _mm_max_epi32(a, b);
+    }
+
+    static vector compare_greater(const vector a, const vector b) noexcept
+    {
+        return _mm_cmpgt_epi32(a, b);
+    }
+};
+
+} // namespace
+
+
+lossless_context_kernel select_lossless_context_kernel_sse41(const size_t bytes_per_sample) noexcept
+{
+    return simd::select_kernel<vector_operations>(bytes_per_sample);
+}
+
+} // namespace charls
+
+#else
+
+namespace charls {
+
+lossless_context_kernel select_lossless_context_kernel_sse41(size_t /* bytes_per_sample */) noexcept
+{
+    return nullptr;
+}
+
+} // namespace charls
+
+#endif
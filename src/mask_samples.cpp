@@ -0,0 +1,75 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "mask_samples.h"
+
+#include "cpu_features.h"
+
+namespace charls {
+
+namespace {
+
+mask_samples_kernel select_mask_samples_kernel() noexcept
+{
+    if (cpu_supports_avx2())
+    {
+        if (const auto kernel{get_mask_samples_kernel_avx2()})
+            return kernel;
+    }
+
+    if (cpu_supports_sse41())
+        return get_mask_samples_kernel_sse41();
+
+    return nullptr;
+}
+
+
+template<typename SampleType>
+uint32_t mask_samples_impl(const SampleType* source, SampleType* destination, const size_t sample_count,
+                           const uint32_t mask, const uint32_t mask_pattern) noexcept
+{
+    static const mask_samples_kernel kernel{select_mask_samples_kernel()};
+
+    size_t i{};
+    uint32_t source_bits{};
+    if (kernel)
+    {
+        uint32_t source_pattern{};
+        i = kernel(source, destination, sample_count * sizeof(SampleType), mask_pattern, source_pattern) /
+            sizeof(SampleType);
+
+        // Fold the pattern back to the width of a single sample.
+        source_bits = source_pattern | (source_pattern >> 16);
+        if (sizeof(SampleType) == sizeof(uint8_t))
+        {
+            source_bits |= source_bits >> 8;
+        }
+        source_bits &= static_cast<SampleType>(~0U);
+    }
+
+    for (; i < sample_count; ++i)
+    {
+        source_bits |= source[i];
+        destination[i] = static_cast<SampleType>(source[i] & mask);
+    }
+
+    return source_bits;
+}
+
+} // namespace
+
+
+uint32_t mask_samples(const uint8_t* source, uint8_t* destination, const size_t sample_count,
+                      const uint32_t mask) noexcept
+{
+    return mask_samples_impl(source, destination, sample_count, mask, (mask & 0xFFU) * 0x01010101U);
+}
+
+
+uint32_t mask_samples(const uint16_t* source, uint16_t* destination, const size_t sample_count,
+                      const uint32_t mask) noexcept
+{
+    return mask_samples_impl(source, destination, sample_count, mask, (mask & 0xFFFFU) * 0x00010001U);
+}
+
+} // namespace charls
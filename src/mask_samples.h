@@ -0,0 +1,32 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace charls {
+
+/// <summary>
+/// Copies the samples and clears the bits that are not set in the mask.
+/// Returns the bitwise OR of all source samples: a result with bits outside the mask indicates an out of range sample.
+/// </summary>
+uint32_t mask_samples(const uint8_t* source, uint8_t* destination, size_t sample_count, uint32_t mask) noexcept;
+uint32_t mask_samples(const uint16_t* source, uint16_t* destination, size_t sample_count, uint32_t mask) noexcept;
+
+
+/// <summary>
+/// Vectorized implementation of mask_samples, processes complete blocks and returns the number of processed bytes.
+/// The 32-bit mask pattern contains the mask of every sample it covers (4 8-bit or 2 16-bit samples), the bitwise OR
+/// of the source is returned in the same format.
+/// </summary>
+using mask_samples_kernel = size_t (*)(const void* source, void* destination, size_t byte_count, uint32_t mask_pattern,
+                                       uint32_t& source_pattern);
+
+// Instruction set specific functions, return nullptr when the compiler cannot generate the instructions.
+// Note: the caller needs to check that the CPU supports the instruction set.
+mask_samples_kernel get_mask_samples_kernel_sse41() noexcept;
+mask_samples_kernel get_mask_samples_kernel_avx2() noexcept;
+
+} // namespace charls
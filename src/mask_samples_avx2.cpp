@@ -0,0 +1,73 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "mask_samples.h"
+
+#include "cpu_features.h"
+
+// Note: MSVC can generate AVX2 instructions without additional compiler options, other compilers need -mavx2.
+#if defined(__AVX2__) || (defined(CHARLS_X86_SIMD) && defined(_MSC_VER) && !defined(__clang__))
+#define CHARLS_AVX2_KERNELS
+#endif
+
+#ifdef CHARLS_AVX2_KERNELS
+
+#include <immintrin.h>
+
+namespace charls {
+
+namespace {
+
+size_t mask_samples_avx2(const void* source, void* destination, const size_t byte_count, const uint32_t mask_pattern,
+                         uint32_t& source_pattern) noexcept
+{
+    constexpr size_t block_size{2 * sizeof(__m256i)};
+    const auto* source_bytes{static_cast<const uint8_t*>(source)};
+    auto* destination_bytes{static_cast<uint8_t*>(destination)};
+    const __m256i mask{_mm256_set1_epi32(static_cast<int>(mask_pattern))};
+    __m256i bits{_mm256_setzero_si256()};
+
+    size_t i{};
+    for (; i + block_size <= byte_count; i += block_size)
+    {
+        const __m256i value1{
+            _mm256_loadu_si256(static_cast<const __m256i*>(static_cast<const void*>(source_bytes + i)))};
+        const __m256i value2{_mm256_loadu_si256(
+            static_cast<const __m256i*>(static_cast<const void*>(source_bytes + i + sizeof(__m256i))))};
+        bits = _mm256_or_si256(bits, _mm256_or_si256(value1, value2));
+        _mm256_storeu_si256(static_cast<__m256i*>(static_cast<void*>(destination_bytes + i)),
+                            _mm256_and_si256(value1, mask));
+        _mm256_storeu_si256(static_cast<__m256i*>(static_cast<void*>(destination_bytes + i + sizeof(__m256i))),
+                            _mm256_and_si256(value2, mask));
+    }
+
+    __m128i folded{_mm_or_si128(_mm256_castsi256_si128(bits), _mm256_extracti128_si256(bits, 1))};
+    folded = _mm_or_si128(folded, _mm_srli_si128(folded, 8));
+    folded = _mm_or_si128(folded, _mm_srli_si128(folded, 4));
+    source_pattern = static_cast<uint32_t>(_mm_cvtsi128_si32(folded));
+    _mm256_zeroupper();
+    return i;
+}
+
+} // namespace
+
+
+mask_samples_kernel get_mask_samples_kernel_avx2() noexcept
+{
+    return &mask_samples_avx2;
+}
+
+} // namespace charls
+
+#else
+
+namespace charls {
+
+mask_samples_kernel get_mask_samples_kernel_avx2() noexcept
+{
+    return nullptr;
+}
+
+} // namespace charls
+
+#endif
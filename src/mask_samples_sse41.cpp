@@ -0,0 +1,69 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "mask_samples.h"
+
+#include "cpu_features.h"
+
+// Note: MSVC can generate SSE4.1 instructions without additional compiler options, other compilers need -msse4.1.
+#if defined(__SSE4_1__) || (defined(CHARLS_X86_SIMD) && defined(_MSC_VER) && !defined(__clang__))
+#define CHARLS_SSE41_KERNELS
+#endif
+
+#ifdef CHARLS_SSE41_KERNELS
+
+#include <smmintrin.h>
+
+namespace charls {
+
+namespace {
+
+size_t mask_samples_sse41(const void* source, void* destination, const size_t byte_count, const uint32_t mask_pattern,
+                          uint32_t& source_pattern) noexcept
+{
+    constexpr size_t block_size{2 * sizeof(__m128i)};
+    const auto* source_bytes{static_cast<const uint8_t*>(source)};
+    auto* destination_bytes{static_cast<uint8_t*>(destination)};
+    const __m128i mask{_mm_set1_epi32(static_cast<int>(mask_pattern))};
+    __m128i bits{_mm_setzero_si128()};
+
+    size_t i{};
+    for (; i + block_size <= byte_count; i += block_size)
+    {
+        const __m128i value1{_mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(source_bytes + i)))};
+        const __m128i value2{_mm_loadu_si128(
+            static_cast<const __m128i*>(static_cast<const void*>(source_bytes + i + sizeof(__m128i))))};
+        bits = _mm_or_si128(bits, _mm_or_si128(value1, value2));
+        _mm_storeu_si128(static_cast<__m128i*>(static_cast<void*>(destination_bytes + i)), _mm_and_si128(value1, mask));
+        _mm_storeu_si128(static_cast<__m128i*>(static_cast<void*>(destination_bytes + i + sizeof(__m128i))),
+                         _mm_and_si128(value2, mask));
+    }
+
+    bits = _mm_or_si128(bits, _mm_srli_si128(bits, 8));
+    bits = _mm_or_si128(bits, _mm_srli_si128(bits, 4));
+    source_pattern = static_cast<uint32_t>(_mm_cvtsi128_si32(bits));
+    return i;
+}
+
+} // namespace
+
+
+mask_samples_kernel get_mask_samples_kernel_sse41() noexcept
+{
+    return &mask_samples_sse41;
+}
+
+} // namespace charls
+
+#else
+
+namespace charls {
+
+mask_samples_kernel get_mask_samples_kernel_sse41() noexcept
+{
+    return nullptr;
+}
+
+} // namespace charls
+
+#endif
@@ -0,0 +1,129 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "parallel_for.h"
+
+#include "internal_allocator.h"
+#include "thread_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace charls {
+
+namespace {
+
+// The state is shared between the calling thread and the submitted tasks. Submitted tasks that start after the
+// calling thread has completed all the work only access the state object and not the (by then destroyed) task.
+struct parallel_for_state final
+{
+    parallel_for_state(const size_t count, void (*const run)(void*, size_t), void* const context,
+                       const charls_allocator* scope_allocator) noexcept :
+        task_count{count},
+        run_task{run},
+        task_context{context},
+        allocator{scope_allocator ? *scope_allocator : charls_allocator{}}
+    {
+    }
+
+    void run_tasks() noexcept
+    {
+        for (size_t index{next_task++}; index < task_count && !failed; index = next_task++)
+        {
+            try
+            {
+                run_task(task_context, index);
+            }
+            catch (...)
+            {
+                const std::lock_guard<std::mutex> lock{mutex};
+                if (!first_exception)
+                {
+                    first_exception = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    }
+
+    const size_t task_count;
+    void (*const run_task)(void*, size_t);
+    void* const task_context;
+    const charls_allocator allocator;
+    std::atomic<size_t> next_task{};
+    std::atomic<bool> failed{};
+
+    std::mutex mutex;
+    std::condition_variable runner_completed;
+    std::exception_ptr first_exception;
+    size_t active_runner_count{};
+    bool completed{};
+};
+
+
+void CHARLS_API_CALLING_CONVENTION run_submitted_tasks(void* task_context) noexcept
+{
+    const std::unique_ptr<task_state_reference<parallel_for_state>> state_reference{
+        static_cast<task_state_reference<parallel_for_state>*>(task_context)};
+    parallel_for_state& state{*state_reference->state};
+
+    {
+        const std::lock_guard<std::mutex> lock{state.mutex};
+        if (state.completed)
+            return;
+
+        ++state.active_runner_count;
+    }
+
+    {
+        // The tasks allocate with the allocator of the encoder or decoder that started them.
+        const allocator_scope scope{&state.allocator};
+        state.run_tasks();
+    }
+
+    const std::lock_guard<std::mutex> lock{state.mutex};
+    --state.active_runner_count;
+    state.runner_completed.notify_all();
+}
+
+} // namespace
+
+
+void parallel_for(const size_t task_count, const uint32_t thread_count, const charls_executor& executor,
+                  void (*const run_task)(void* task_context, size_t index), void* const task_context)
+{
+    if (task_count == 0)
+        return;
+
+    const auto state{std::allocate_shared<parallel_for_state>(internal_allocator<parallel_for_state>{}, task_count,
+                                                              run_task, task_context, allocator_scope::current())};
+    const charls_executor actual_executor{executor.submit ? executor : default_executor()};
+
+    const size_t runner_count{std::min(task_count, static_cast<size_t>(resolve_thread_count(thread_count))) - 1};
+    for (size_t i{}; i != runner_count; ++i)
+    {
+        // Not being able to submit (all) tasks is not fatal: the calling thread will execute the remaining work.
+        auto state_reference{std::unique_ptr<task_state_reference<parallel_for_state>>(
+            new (std::nothrow) task_state_reference<parallel_for_state>(state))};
+        if (!state_reference ||
+            actual_executor.submit(&run_submitted_tasks, state_reference.get(), actual_executor.user_context) != 0)
+            break;
+
+        state_reference.release(); // NOLINT(bugprone-unused-return-value): ownership is passed to the submitted task.
+    }
+
+    state->run_tasks();
+
+    std::unique_lock<std::mutex> lock{state->mutex};
+    state->completed = true;
+    state->runner_completed.wait(lock, [&state] { return state->active_runner_count == 0; });
+
+    if (state->first_exception)
+        std::rethrow_exception(state->first_exception);
+}
+
+} // namespace charls
@@ -0,0 +1,46 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "charls/public_types.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace charls {
+
+/// <summary>
+/// Returns the number of threads to use: 0 is interpreted as "use all hardware threads".
+/// </summary>
+inline uint32_t resolve_thread_count(const uint32_t thread_count) noexcept
+{
+    if (thread_count != 0)
+        return thread_count;
+
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+
+/// <summary>
+/// Executes run_task(task_context, 0) .. run_task(task_context, task_count - 1) using at most thread_count threads,
+/// the calling thread included. The additional threads are requested from the executor, an executor without a submit
+/// function selects the built-in thread pool.
+/// Tasks are started in ascending order. After a task has thrown an exception no new tasks are started and
+/// the first exception is rethrown on the calling thread, after all running tasks have completed.
+/// </summary>
+void parallel_for(size_t task_count, uint32_t thread_count, const charls_executor& executor,
+                  void (*run_task)(void* task_context, size_t index), void* task_context);
+
+
+template<typename Task>
+void parallel_for(const size_t task_count, const uint32_t thread_count, const charls_executor& executor, Task task)
+{
+    parallel_for(
+        task_count, thread_count, executor,
+        [](void* task_context, const size_t index) { (*static_cast<Task*>(task_context))(index); }, &task);
+}
+
+} // namespace charls
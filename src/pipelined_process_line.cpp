@@ -0,0 +1,309 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pipelined_process_line.h"
+
+#include "internal_allocator.h"
+#include "thread_pool.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <new>
+
+namespace charls {
+
+namespace {
+
+// Number of lines the post-processing thread can be ahead of (encoding) or behind (decoding) the entropy coder.
+constexpr size_t line_buffer_count{16};
+
+} // namespace
+
+
+// The state is shared between the entropy coder and the submitted task. A task that starts after the pipeline has
+// been closed only accesses the state object and not the (by then destroyed) wrapped process_line.
+// The wrapped process_line is only used by 1 thread at a time (busy flag) and always in line order.
+struct pipeline_state final
+{
+    pipeline_state(process_line* wrapped, const bool decode, const size_t count, const size_t slot_size_bytes,
+                   const charls_allocator* scope_allocator) :
+        line_processor{wrapped},
+        decoding{decode},
+        line_count{count},
+        slot_size{slot_size_bytes},
+        allocator{scope_allocator ? *scope_allocator : charls_allocator{}},
+        buffer(line_buffer_count * slot_size_bytes)
+    {
+    }
+
+    uint8_t* slot(const size_t line) noexcept
+    {
+        return buffer.data() + (line % line_buffer_count) * slot_size;
+    }
+
+    bool work_available() const noexcept
+    {
+        if (busy || error)
+            return false;
+
+        return decoding ? read < written : written < line_count && written - read < line_buffer_count;
+    }
+
+    bool finished() const noexcept
+    {
+        return error || (decoding ? producer_done : written == line_count);
+    }
+
+    // Lets the wrapped process_line convert the next line, the lock is released while the line is converted.
+    void process_next(std::unique_lock<std::mutex>& lock)
+    {
+        ASSERT(work_available());
+
+        busy = true;
+        const size_t line{decoding ? read : written};
+        lock.unlock();
+
+        std::exception_ptr exception;
+        try
+        {
+            if (decoding)
+            {
+                line_processor->new_line_decoded(slot(line), pixel_count, stride);
+            }
+            else
+            {
+                line_processor->new_line_requested(slot(line), pixel_count, stride);
+            }
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        lock.lock();
+        if (exception)
+        {
+            error = exception;
+        }
+        else
+        {
+            ++(decoding ? read : written);
+        }
+        busy = false;
+        changed.notify_all();
+    }
+
+    void run() noexcept
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        if (closed)
+            return;
+
+        const allocator_scope scope{&allocator};
+        active = true;
+        for (;;)
+        {
+            changed.wait(lock, [this] { return stopping || work_available() || finished(); });
+            if (stopping || !work_available())
+                break;
+
+            process_next(lock);
+        }
+
+        active = false;
+        changed.notify_all();
+    }
+
+    process_line* const line_processor;
+    const bool decoding;
+    const size_t line_count;
+    const size_t slot_size;
+    size_t pixel_count{};
+    size_t stride{};
+    const charls_allocator allocator;
+    internal_vector<uint8_t> buffer;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::exception_ptr error;
+    size_t written{};
+    size_t read{};
+    bool busy{};
+    bool active{};
+    bool producer_done{};
+    bool stopping{};
+    bool closed{};
+};
+
+
+namespace {
+
+void CHARLS_API_CALLING_CONVENTION run_pipeline(void* task_context) noexcept
+{
+    const std::unique_ptr<task_state_reference<pipeline_state>> state_reference{
+        static_cast<task_state_reference<pipeline_state>*>(task_context)};
+    state_reference->state->run();
+}
+
+} // namespace
+
+
+pipelined_process_line::pipelined_process_line(std::unique_ptr<process_line> wrapped, const frame_info& info,
+                                               const interleave_mode mode, const charls_executor& executor) :
+    process_line_{std::move(wrapped)},
+    executor_{executor.submit ? executor : default_executor()},
+    line_count_{info.height},
+    component_count_{mode == interleave_mode::line ? static_cast<size_t>(info.component_count) : 1},
+    bytes_per_pixel_{(mode == interleave_mode::sample ? static_cast<size_t>(info.component_count) : 1) *
+                     bit_to_byte_count(info.bits_per_sample)}
+{
+}
+
+
+pipelined_process_line::~pipelined_process_line()
+{
+    if (!state_)
+        return;
+
+    std::unique_lock<std::mutex> lock{state_->mutex};
+    state_->stopping = true;
+    state_->changed.notify_all();
+    state_->changed.wait(lock, [this] { return !state_->active; });
+    state_->closed = true;
+}
+
+
+void pipelined_process_line::new_line_decoded(const void* source, const size_t pixel_count, const size_t source_stride)
+{
+    if (!state_)
+    {
+        start(true, pixel_count, source_stride);
+    }
+    ASSERT(pixel_count == state_->pixel_count && source_stride == state_->stride);
+
+    pipeline_state& state{*state_};
+    std::unique_lock<std::mutex> lock{state.mutex};
+    while (state.written - state.read == line_buffer_count)
+    {
+        if (state.error)
+            std::rethrow_exception(state.error);
+
+        if (state.busy)
+        {
+            state.changed.wait(lock);
+        }
+        else
+        {
+            state.process_next(lock);
+        }
+    }
+    uint8_t* slot{state.slot(state.written)};
+    lock.unlock();
+
+    // Only copy the pixels of every component, the line buffer of the entropy decoder also contains edge pixels.
+    const size_t component_size{pixel_count * bytes_per_pixel_};
+    for (size_t component{}; component != component_count_; ++component)
+    {
+        const size_t offset{component * source_stride * bytes_per_pixel_};
+        memcpy(slot + offset, static_cast<const uint8_t*>(source) + offset, component_size);
+    }
+
+    lock.lock();
+    ++state.written;
+    state.changed.notify_all();
+}
+
+
+void pipelined_process_line::new_line_requested(void* destination, const size_t pixel_count,
+                                                const size_t destination_stride)
+{
+    if (!state_)
+    {
+        start(false, pixel_count, destination_stride);
+    }
+    ASSERT(pixel_count == state_->pixel_count && destination_stride == state_->stride);
+
+    pipeline_state& state{*state_};
+    std::unique_lock<std::mutex> lock{state.mutex};
+    while (state.read == state.written)
+    {
+        if (state.error)
+            std::rethrow_exception(state.error);
+
+        if (state.busy)
+        {
+            state.changed.wait(lock);
+        }
+        else
+        {
+            state.process_next(lock);
+        }
+    }
+    const uint8_t* slot{state.slot(state.read)};
+    lock.unlock();
+
+    const size_t component_size{pixel_count * bytes_per_pixel_};
+    for (size_t component{}; component != component_count_; ++component)
+    {
+        const size_t offset{component * destination_stride * bytes_per_pixel_};
+        memcpy(static_cast<uint8_t*>(destination) + offset, slot + offset, component_size);
+    }
+
+    lock.lock();
+    ++state.read;
+    state.changed.notify_all();
+}
+
+
+void pipelined_process_line::complete()
+{
+    if (!state_)
+        return;
+
+    pipeline_state& state{*state_};
+    std::unique_lock<std::mutex> lock{state.mutex};
+    state.producer_done = true;
+    state.changed.notify_all();
+
+    // Help to process the remaining lines: the submitted task may not have been started yet.
+    for (;;)
+    {
+        if (state.work_available())
+        {
+            state.process_next(lock);
+        }
+        else if (state.busy || state.active)
+        {
+            state.changed.wait(lock);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (state.error)
+        std::rethrow_exception(state.error);
+}
+
+
+void pipelined_process_line::start(const bool decoding, const size_t pixel_count, const size_t stride)
+{
+    state_ = std::allocate_shared<pipeline_state>(internal_allocator<pipeline_state>{}, process_line_.get(), decoding,
+                                                  line_count_, component_count_ * stride * bytes_per_pixel_,
+                                                  allocator_scope::current());
+    state_->pixel_count = pixel_count;
+    state_->stride = stride;
+
+    // Not being able to submit the task is not fatal: the entropy coder will process all lines itself.
+    auto state_reference{std::unique_ptr<task_state_reference<pipeline_state>>(
+        new (std::nothrow) task_state_reference<pipeline_state>(state_))};
+    if (state_reference && executor_.submit(&run_pipeline, state_reference.get(), executor_.user_context) == 0)
+    {
+        state_reference.release(); // NOLINT(bugprone-unused-return-value): ownership is passed to the submitted task.
+    }
+}
+
+} // namespace charls
@@ -0,0 +1,52 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "process_line.h"
+
+#include <memory>
+
+namespace charls {
+
+struct pipeline_state;
+
+// Purpose: decorator that executes the wrapped process_line on a separate thread.
+// Lines are exchanged through a ring of line buffers: when decoding, the entropy decoder stores the decoded lines
+// in the ring and the wrapped process_line converts them to the output format on the other thread. When encoding,
+// the other thread converts the lines of the input format in advance and the entropy encoder copies them from the ring.
+// The serial entropy coder then only needs to perform the bit level work.
+// When the executor cannot provide a thread (or the thread starts late), the entropy coder processes the lines itself.
+class pipelined_process_line final : public process_line
+{
+public:
+    pipelined_process_line(std::unique_ptr<process_line> wrapped, const frame_info& info, interleave_mode mode,
+                           const charls_executor& executor);
+    ~pipelined_process_line() override;
+
+    pipelined_process_line(const pipelined_process_line&) = delete;
+    pipelined_process_line(pipelined_process_line&&) = delete;
+    pipelined_process_line& operator=(const pipelined_process_line&) = delete;
+    pipelined_process_line& operator=(pipelined_process_line&&) = delete;
+
+    void new_line_decoded(const void* source, size_t pixel_count, size_t source_stride) override;
+    void new_line_requested(void* destination, size_t pixel_count, size_t destination_stride) override;
+
+    /// <summary>
+    /// Waits until all lines have been processed by the wrapped process_line.
+    /// Rethrows the exception of the wrapped process_line, if it failed.
+    /// </summary>
+    void complete();
+
+private:
+    void start(bool decoding, size_t pixel_count, size_t stride);
+
+    std::unique_ptr<process_line> process_line_;
+    std::shared_ptr<pipeline_state> state_;
+    charls_executor executor_;
+    uint32_t line_count_;
+    size_t component_count_;
+    size_t bytes_per_pixel_;
+};
+
+} // namespace charls
@@ -0,0 +1,230 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "cpu_features.h"
+#include "util.h"
+
+#include <cstring>
+#include <type_traits>
+
+#ifdef CHARLS_SSE2
+#include <emmintrin.h>
+#endif
+
+// This file defines the classes that compute the context ids of the components of a sample interleaved pixel.
+// pixel_context_sse2 computes the context ids of all components at once and is used when SSE2 instructions are
+// available, pixel_context_scalar is the portable implementation.
+
+namespace charls {
+
+class pixel_context_scalar final
+{
+public:
+    explicit pixel_context_scalar(const int8_t* quantization) noexcept : quantization_{quantization}
+    {
+    }
+
+    /// <summary>
+    /// Computes the context ids of the pixel right of ra, previous points to rc (followed by rb and rd).
+    /// Returns true when all context ids are 0: the pixel is encoded or decoded in run mode.
+    /// </summary>
+    template<typename SampleType>
+    bool compute(const triplet<SampleType>* ra, const triplet<SampleType>* previous) noexcept
+    {
+        context_ids_[0] = compute_context_id(ra->v1, previous[1].v1, previous[0].v1, previous[2].v1);
+        context_ids_[1] = compute_context_id(ra->v2, previous[1].v2, previous[0].v2, previous[2].v2);
+        context_ids_[2] = compute_context_id(ra->v3, previous[1].v3, previous[0].v3, previous[2].v3);
+        return context_ids_[0] == 0 && context_ids_[1] == 0 && context_ids_[2] == 0;
+    }
+
+    template<typename SampleType>
+    bool compute(const quad<SampleType>* ra, const quad<SampleType>* previous) noexcept
+    {
+        context_ids_[0] = compute_context_id(ra->v1, previous[1].v1, previous[0].v1, previous[2].v1);
+        context_ids_[1] = compute_context_id(ra->v2, previous[1].v2, previous[0].v2, previous[2].v2);
+        context_ids_[2] = compute_context_id(ra->v3, previous[1].v3, previous[0].v3, previous[2].v3);
+        context_ids_[3] = compute_context_id(ra->v4, previous[1].v4, previous[0].v4, previous[2].v4);
+        return context_ids_[0] == 0 && context_ids_[1] == 0 && context_ids_[2] == 0 && context_ids_[3] == 0;
+    }
+
+    int32_t context_id(const size_t component) const noexcept
+    {
+        ASSERT(component < 4);
+        return context_ids_[component];
+    }
+
+private:
+    int32_t compute_context_id(const int32_t ra, const int32_t rb, const int32_t rc, const int32_t rd) const noexcept
+    {
+        return (quantization_[rd - rb] * 9 + quantization_[rb - rc]) * 9 + quantization_[rc - ra];
+    }
+
+    const int8_t* quantization_;
+    int32_t context_ids_[4]{};
+};
+
+#ifdef CHARLS_SSE2
+
+/// <summary>
+/// Computes the context ids (ISO/IEC 14495-1, A.3) of the 3 or 4 components of a sample interleaved pixel with SSE2
+/// instructions: every component uses a lane. 8-bit samples use 16-bit lanes, which allows to quantize the first 2
+/// gradients of all components with 1 operation. 16-bit samples use 32-bit lanes.
+/// </summary>
+template<typename SampleType>
+class pixel_context_sse2 final
+{
+public:
+    pixel_context_sse2(const int32_t threshold1, const int32_t threshold2, const int32_t threshold3,
+                       const int32_t near_lossless) noexcept :
+        thresholds_{set1(near_lossless), set1(threshold1 - 1), set1(threshold2 - 1), set1(threshold3 - 1)}
+    {
+    }
+
+    /// <summary>
+    /// Computes the context ids of the pixel right of ra, previous points to rc (followed by rb and rd).
+    /// Returns true when all context ids are 0: the pixel is encoded or decoded in run mode.
+    /// </summary>
+    /// <remarks>
+    /// The samples of a pixel are loaded with a single read: the line buffers must be readable up to 1 sample after rd.
+    /// </remarks>
+    template<typename PixelType>
+    bool compute(const PixelType* ra_pixel, const PixelType* previous) noexcept
+    {
+        return compute(load(ra_pixel), load(previous), load(previous + 1), load(previous + 2), lane_mask(ra_pixel));
+    }
+
+    int32_t context_id(const size_t component) const noexcept
+    {
+        ASSERT(component < 4);
+        return context_ids_[component];
+    }
+
+private:
+    using lane_type = std::conditional_t<sizeof(SampleType) == sizeof(uint8_t), int16_t, int32_t>;
+
+    bool compute(const __m128i ra, const __m128i rc, const __m128i rb, const __m128i rd, const __m128i lanes) noexcept
+    {
+        return compute(ra, rc, rb, rd, lanes, static_cast<lane_type*>(nullptr));
+    }
+
+    // 8-bit samples: the low half of a vector contains the gradients rd - rb, the high half the gradients rb - rc.
+    bool compute(const __m128i ra, const __m128i rc, const __m128i rb, const __m128i rd, const __m128i lanes,
+                 int16_t* /*template_selector*/) noexcept
+    {
+        const __m128i lanes_low_half{_mm_unpacklo_epi64(lanes, _mm_setzero_si128())};
+        const __m128i q12{quantize_gradient(
+            _mm_and_si128(_mm_sub_epi16(_mm_unpacklo_epi64(rd, rb), _mm_unpacklo_epi64(rb, rc)),
+                          _mm_unpacklo_epi64(lanes, lanes)))};
+        const __m128i q3{quantize_gradient(_mm_and_si128(_mm_sub_epi16(rc, ra), lanes_low_half))};
+
+        // compute_context_id: q1 * 81 + q2 * 9 + q3
+        __m128i context_ids{_mm_mullo_epi16(q12, _mm_setr_epi16(81, 81, 81, 81, 9, 9, 9, 9))};
+        context_ids = _mm_add_epi16(_mm_add_epi16(context_ids, _mm_srli_si128(context_ids, 8)), q3);
+        context_ids = _mm_and_si128(context_ids, lanes_low_half);
+
+        // Sign extend the 16-bit context ids to the 32-bit output.
+        _mm_store_si128(static_cast<__m128i*>(static_cast<void*>(context_ids_)),
+                        _mm_srai_epi32(_mm_unpacklo_epi16(context_ids, context_ids), 16));
+        return _mm_movemask_epi8(_mm_cmpeq_epi16(context_ids, _mm_setzero_si128())) == 0xFFFF;
+    }
+
+    bool compute(const __m128i ra, const __m128i rc, const __m128i rb, const __m128i rd, const __m128i lanes,
+                 int32_t* /*template_selector*/) noexcept
+    {
+        const __m128i q1{quantize_gradient(_mm_and_si128(_mm_sub_epi32(rd, rb), lanes))};
+        const __m128i q2{quantize_gradient(_mm_and_si128(_mm_sub_epi32(rb, rc), lanes))};
+        const __m128i q3{quantize_gradient(_mm_and_si128(_mm_sub_epi32(rc, ra), lanes))};
+
+        // compute_context_id: (q1 * 9 + q2) * 9 + q3
+        const __m128i context_ids{_mm_add_epi32(multiply_by_9(_mm_add_epi32(multiply_by_9(q1), q2)), q3)};
+        _mm_store_si128(static_cast<__m128i*>(static_cast<void*>(context_ids_)), context_ids);
+        return _mm_movemask_epi8(_mm_cmpeq_epi32(context_ids, _mm_setzero_si128())) == 0xFFFF;
+    }
+
+    // Vectorized equivalent of quantize_gradient_org: the quantized value of |di| is the number of
+    // thresholds it passes (a compare result is 0 or -1), the sign of di is applied afterwards.
+    __m128i quantize_gradient(const __m128i di) const noexcept
+    {
+        const __m128i sign{shift_right_sign(di)};
+        const __m128i magnitude{sub(_mm_xor_si128(di, sign), sign)};
+
+        __m128i count{compare_greater(magnitude, thresholds_[0])};
+        for (size_t i{1}; i != 4; ++i)
+        {
+            count = add(count, compare_greater(magnitude, thresholds_[i]));
+        }
+
+        const __m128i quantized{sub(_mm_setzero_si128(), count)};
+        return sub(_mm_xor_si128(quantized, sign), sign);
+    }
+
+    static __m128i multiply_by_9(const __m128i value) noexcept
+    {
+        return _mm_add_epi32(_mm_slli_epi32(value, 3), value);
+    }
+
+    template<typename PixelSampleType>
+    static __m128i lane_mask(const triplet<PixelSampleType>* /*pixel*/) noexcept
+    {
+        // The 4th lane of a triplet contains the first sample of the next pixel: it is cleared to get a context id of 0.
+        return sizeof(lane_type) == sizeof(int16_t) ? _mm_setr_epi16(-1, -1, -1, 0, 0, 0, 0, 0)
+                                                    : _mm_setr_epi32(-1, -1, -1, 0);
+    }
+
+    template<typename PixelSampleType>
+    static __m128i lane_mask(const quad<PixelSampleType>* /*pixel*/) noexcept
+    {
+        return sizeof(lane_type) == sizeof(int16_t) ? _mm_setr_epi16(-1, -1, -1, -1, 0, 0, 0, 0) : _mm_set1_epi32(-1);
+    }
+
+    static __m128i load(const void* pixel) noexcept
+    {
+        return load(pixel, static_cast<lane_type*>(nullptr));
+    }
+
+    static __m128i load(const void* pixel, int16_t* /*template_selector*/) noexcept
+    {
+        int32_t samples;
+        memcpy(&samples, pixel, sizeof samples);
+        return _mm_unpacklo_epi8(_mm_cvtsi32_si128(samples), _mm_setzero_si128());
+    }
+
+    static __m128i load(const void* pixel, int32_t* /*template_selector*/) noexcept
+    {
+        return _mm_unpacklo_epi16(_mm_loadl_epi64(static_cast<const __m128i*>(pixel)), _mm_setzero_si128());
+    }
+
+    static __m128i set1(const int32_t value) noexcept
+    {
+        return sizeof(lane_type) == sizeof(int16_t) ? _mm_set1_epi16(static_cast<short>(value)) : _mm_set1_epi32(value);
+    }
+
+    static __m128i add(const __m128i a, const __m128i b) noexcept
+    {
+        return sizeof(lane_type) == sizeof(int16_t) ? _mm_add_epi16(a, b) : _mm_add_epi32(a, b);
+    }
+
+    static __m128i sub(const __m128i a, const __m128i b) noexcept
+    {
+        return sizeof(lane_type) == sizeof(int16_t) ? _mm_sub_epi16(a, b) : _mm_sub_epi32(a, b);
+    }
+
+    static __m128i compare_greater(const __m128i a, const __m128i b) noexcept
+    {
+        return sizeof(lane_type) == sizeof(int16_t) ? _mm_cmpgt_epi16(a, b) : _mm_cmpgt_epi32(a, b);
+    }
+
+    static __m128i shift_right_sign(const __m128i a) noexcept
+    {
+        return sizeof(lane_type) == sizeof(int16_t) ? _mm_srai_epi16(a, 15) : _mm_srai_epi32(a, 31);
+    }
+
+    __m128i thresholds_[4];
+    alignas(16) int32_t context_ids_[4]{};
+};
+
+#endif
+
+} // namespace charls
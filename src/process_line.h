@@ -4,10 +4,14 @@
 #pragma once
 
 #include "coding_parameters.h"
+#include "color_transform_simd.h"
+#include "internal_allocator.h"
+#include "mask_samples.h"
 #include "util.h"
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 #include <sstream>
 #include <vector>
 
@@ -23,13 +27,33 @@
 
 namespace charls {
 
-struct process_line
+class post_process_single_component;
+
+struct process_line : internal_object
 {
     virtual ~process_line() = default;
 
     virtual void new_line_decoded(const void* source, size_t pixel_count, size_t source_stride) = 0;
     virtual void new_line_requested(void* destination, size_t pixel_count, size_t destination_stride) = 0;
 
+    /// <summary>
+    /// Returns the object when it is a post_process_single_component, otherwise nullptr.
+    /// The codecs use it to select once per scan line loops that copy the lines without a virtual call.
+    /// </summary>
+    virtual post_process_single_component* as_single_component() noexcept
+    {
+        return nullptr;
+    }
+
+    /// <summary>
+    /// Prepares the object for the next scan of a reused codec, the application buffer starts at the given position.
+    /// Returns false when the object cannot be reused: the codec then creates a new process_line.
+    /// </summary>
+    virtual bool reset(byte_span /* raw_pixels */, size_t /* stride */) noexcept
+    {
+        return false;
+    }
+
 protected:
     process_line() = default;
     process_line(const process_line&) = default;
@@ -61,6 +85,18 @@ class post_process_single_component final : public process_line
         raw_data_ += stride_;
     }
 
+    post_process_single_component* as_single_component() noexcept override
+    {
+        return this;
+    }
+
+    bool reset(const byte_span raw_pixels, const size_t stride) noexcept override
+    {
+        raw_data_ = raw_pixels.data;
+        stride_ = stride;
+        return true;
+    }
+
 private:
     uint8_t* raw_data_;
     size_t bytes_per_pixel_;
@@ -72,12 +108,13 @@ class post_process_single_component_masked final : public process_line
 {
 public:
     post_process_single_component_masked(void* raw_data, const size_t stride, const size_t bytes_per_pixel,
-                                         const uint32_t bits_per_pixel) noexcept :
+                                         const uint32_t bits_per_pixel, const bool validate_sample_values) noexcept :
         raw_data_{raw_data},
         bytes_per_pixel_{bytes_per_pixel},
         stride_{stride},
         mask_{(1U << bits_per_pixel) - 1U},
-        single_byte_pixel_{bytes_per_pixel_ == sizeof(uint8_t)}
+        single_byte_pixel_{bytes_per_pixel_ == sizeof(uint8_t)},
+        validate_sample_values_{validate_sample_values}
     {
         ASSERT(bytes_per_pixel == sizeof(uint8_t) || bytes_per_pixel == sizeof(uint16_t));
     }
@@ -85,24 +122,15 @@ class post_process_single_component_masked final : public process_line
     void new_line_requested(void* destination, const size_t pixel_count,
                             size_t /* destination_stride */) noexcept(false) override
     {
-        if (single_byte_pixel_)
-        {
-            const auto* pixel_source{static_cast<uint8_t*>(raw_data_)};
-            auto* pixel_destination{static_cast<uint8_t*>(destination)};
-            for (size_t i{}; i < pixel_count; ++i)
-            {
-                pixel_destination[i] = static_cast<uint8_t>(pixel_source[i] & mask_);
-            }
-        }
-        else
-        {
-            const auto* pixel_source{static_cast<uint16_t*>(raw_data_)};
-            auto* pixel_destination{static_cast<uint16_t*>(destination)};
-            for (size_t i{}; i < pixel_count; ++i)
-            {
-                pixel_destination[i] = static_cast<uint16_t>(pixel_source[i] & mask_);
-            }
-        }
+        // Masking and the detection of out of range samples are done in a single pass.
+        const uint32_t source_bits{
+            single_byte_pixel_
+                ? mask_samples(static_cast<const uint8_t*>(raw_data_), static_cast<uint8_t*>(destination), pixel_count,
+                               mask_)
+                : mask_samples(static_cast<const uint16_t*>(raw_data_), static_cast<uint16_t*>(destination),
+                               pixel_count, mask_)};
+        if (validate_sample_values_ && (source_bits & ~mask_) != 0)
+            impl::throw_jpegls_error(jpegls_errc::invalid_argument_sample_value);
 
         raw_data_ = static_cast<uint8_t*>(raw_data_) + stride_;
     }
@@ -113,12 +141,20 @@ class post_process_single_component_masked final : public process_line
         raw_data_ = static_cast<uint8_t*>(raw_data_) + stride_;
     }
 
+    bool reset(const byte_span raw_pixels, const size_t stride) noexcept override
+    {
+        raw_data_ = raw_pixels.data;
+        stride_ = stride;
+        return true;
+    }
+
 private:
     void* raw_data_;
     size_t bytes_per_pixel_;
     size_t stride_;
     uint32_t mask_;
     bool single_byte_pixel_;
+    bool validate_sample_values_;
 };
 
 
@@ -298,13 +334,25 @@ class process_transformed final : public process_line
         transform_{transform},
         inverse_transform_{transform},
         raw_pixels_{source_pixels},
-        mask_{(1U << info.bits_per_sample) - 1U}
+        mask_{(1U << info.bits_per_sample) - 1U},
+        encode_kernel_{select_color_transform_kernel(TransformType::transformation, false, info.component_count,
+                                                     sizeof(size_type), sample_layout::interleaved,
+                                                     internal_layout(parameters.interleave_mode))},
+        decode_kernel_{select_color_transform_kernel(TransformType::transformation, true, info.component_count,
+                                                     sizeof(size_type), internal_layout(parameters.interleave_mode),
+                                                     sample_layout::interleaved)}
     {
     }
 
     void new_line_requested(void* destination, const size_t pixel_count,
                             const size_t destination_stride) noexcept(false) override
     {
+        if (parameters_.validate_sample_values && mask_ != std::numeric_limits<size_type>::max())
+        {
+            check_sample_values(static_cast<const size_type*>(static_cast<const void*>(raw_pixels_.data)),
+                                pixel_count * frame_info_.component_count);
+        }
+
         encode_transform(raw_pixels_.data, destination, pixel_count, destination_stride);
         raw_pixels_.data += stride_;
     }
@@ -312,10 +360,20 @@ class process_transformed final : public process_line
     void encode_transform(const void* source, void* destination, const size_t pixel_count,
                           const size_t destination_stride) noexcept
     {
+        // The vectorized kernel transforms complete blocks of pixels, the remaining pixels are transformed below.
+        const size_t transformed{encode_kernel_ ? encode_kernel_(source, 0, destination, destination_stride,
+                                                                 pixel_count, mask_, parameters_.output_bgr)
+                                                : 0};
+        if (transformed == pixel_count)
+            return;
+
+        const size_t remaining_pixel_count{pixel_count - transformed};
+        source = static_cast<const size_type*>(source) + transformed * frame_info_.component_count;
         if (parameters_.output_bgr)
         {
-            memcpy(temp_line_.data(), source, sizeof(triplet<size_type>) * pixel_count);
-            transform_rgb_to_bgr(temp_line_.data(), frame_info_.component_count, pixel_count);
+            memcpy(temp_line_.data(), source,
+                   sizeof(size_type) * frame_info_.component_count * remaining_pixel_count);
+            transform_rgb_to_bgr(temp_line_.data(), frame_info_.component_count, remaining_pixel_count);
             source = temp_line_.data();
         }
 
@@ -323,62 +381,77 @@ class process_transformed final : public process_line
         {
             if (parameters_.interleave_mode == interleave_mode::sample)
             {
-                transform_line(static_cast<triplet<size_type>*>(destination), static_cast<const triplet<size_type>*>(source),
-                               pixel_count, transform_, mask_);
+                transform_line(static_cast<triplet<size_type>*>(destination) + transformed,
+                               static_cast<const triplet<size_type>*>(source), remaining_pixel_count, transform_, mask_);
             }
             else
             {
-                transform_triplet_to_line(static_cast<const triplet<size_type>*>(source), pixel_count,
-                                          static_cast<size_type*>(destination), destination_stride, transform_, mask_);
+                transform_triplet_to_line(static_cast<const triplet<size_type>*>(source), remaining_pixel_count,
+                                          static_cast<size_type*>(destination) + transformed, destination_stride,
+                                          transform_, mask_);
             }
         }
         else if (frame_info_.component_count == 4)
         {
             if (parameters_.interleave_mode == interleave_mode::sample)
             {
-                transform_line(static_cast<quad<size_type>*>(destination), static_cast<const quad<size_type>*>(source),
-                               pixel_count, transform_, mask_);
+                transform_line(static_cast<quad<size_type>*>(destination) + transformed,
+                               static_cast<const quad<size_type>*>(source), remaining_pixel_count, transform_, mask_);
             }
             else if (parameters_.interleave_mode == interleave_mode::line)
             {
-                transform_quad_to_line(static_cast<const quad<size_type>*>(source), pixel_count,
-                                       static_cast<size_type*>(destination), destination_stride, transform_, mask_);
+                transform_quad_to_line(static_cast<const quad<size_type>*>(source), remaining_pixel_count,
+                                       static_cast<size_type*>(destination) + transformed, destination_stride,
+                                       transform_, mask_);
             }
         }
     }
 
     void decode_transform(const void* source, void* destination, const size_t pixel_count, const size_t byte_stride) noexcept
     {
+        const size_t transformed{decode_kernel_ ? decode_kernel_(source, byte_stride, destination, 0, pixel_count,
+                                                                 std::numeric_limits<uint32_t>::max(),
+                                                                 parameters_.output_bgr)
+                                                : 0};
+        if (transformed == pixel_count)
+            return;
+
+        const size_t remaining_pixel_count{pixel_count - transformed};
         if (frame_info_.component_count == 3)
         {
             if (parameters_.interleave_mode == interleave_mode::sample)
             {
-                transform_line(static_cast<triplet<size_type>*>(destination), static_cast<const triplet<size_type>*>(source),
-                               pixel_count, inverse_transform_);
+                transform_line(static_cast<triplet<size_type>*>(destination) + transformed,
+                               static_cast<const triplet<size_type>*>(source) + transformed, remaining_pixel_count,
+                               inverse_transform_);
             }
             else
             {
-                transform_line_to_triplet(static_cast<const size_type*>(source), byte_stride,
-                                          static_cast<triplet<size_type>*>(destination), pixel_count, inverse_transform_);
+                transform_line_to_triplet(static_cast<const size_type*>(source) + transformed, byte_stride,
+                                          static_cast<triplet<size_type>*>(destination) + transformed,
+                                          remaining_pixel_count, inverse_transform_);
             }
         }
         else if (frame_info_.component_count == 4)
         {
             if (parameters_.interleave_mode == interleave_mode::sample)
             {
-                transform_line(static_cast<quad<size_type>*>(destination), static_cast<const quad<size_type>*>(source),
-                               pixel_count, inverse_transform_);
+                transform_line(static_cast<quad<size_type>*>(destination) + transformed,
+                               static_cast<const quad<size_type>*>(source) + transformed, remaining_pixel_count,
+                               inverse_transform_);
             }
             else if (parameters_.interleave_mode == interleave_mode::line)
             {
-                transform_line_to_quad(static_cast<const size_type*>(source), byte_stride,
-                                       static_cast<quad<size_type>*>(destination), pixel_count, inverse_transform_);
+                transform_line_to_quad(static_cast<const size_type*>(source) + transformed, byte_stride,
+                                       static_cast<quad<size_type>*>(destination) + transformed, remaining_pixel_count,
+                                       inverse_transform_);
             }
         }
 
         if (parameters_.output_bgr)
         {
-            transform_rgb_to_bgr(static_cast<size_type*>(destination), frame_info_.component_count, pixel_count);
+            transform_rgb_to_bgr(static_cast<size_type*>(destination) + transformed * frame_info_.component_count,
+                                 frame_info_.component_count, remaining_pixel_count);
         }
     }
 
@@ -388,18 +461,38 @@ class process_transformed final : public process_line
         raw_pixels_.data += stride_;
     }
 
+    bool reset(const byte_span raw_pixels, const size_t stride) noexcept override
+    {
+        raw_pixels_ = raw_pixels;
+        stride_ = stride;
+        return true;
+    }
+
 private:
     using size_type = typename TransformType::size_type;
 
+    void check_sample_values(const size_type* source, const size_t sample_count)
+    {
+        if ((mask_samples(source, temp_line_.data(), sample_count, mask_) & ~mask_) != 0)
+            impl::throw_jpegls_error(jpegls_errc::invalid_argument_sample_value);
+    }
+
+    static constexpr sample_layout internal_layout(const interleave_mode mode) noexcept
+    {
+        return mode == interleave_mode::sample ? sample_layout::interleaved : sample_layout::planar;
+    }
+
     const frame_info& frame_info_;
     const coding_parameters& parameters_;
-    const size_t stride_;
-    std::vector<size_type> temp_line_;
-    std::vector<uint8_t> buffer_;
+    size_t stride_;
+    internal_vector<size_type> temp_line_;
+    internal_vector<uint8_t> buffer_;
     TransformType transform_;
     typename TransformType::inverse inverse_transform_;
     byte_span raw_pixels_;
     uint32_t mask_;
+    color_transform_kernel encode_kernel_;
+    color_transform_kernel decode_kernel_;
 };
 
 } // namespace charls
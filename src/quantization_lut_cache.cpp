@@ -0,0 +1,103 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "quantization_lut_cache.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace charls {
+
+namespace {
+
+// Purpose: bounded list of the most recently used tables, the first entry is the most recently used one.
+class quantization_lut_cache final
+{
+public:
+    std::shared_ptr<const quantization_lut> find(const int32_t threshold1, const int32_t threshold2,
+                                                 const int32_t threshold3, const int32_t near_lossless,
+                                                 const int32_t bits_per_pixel)
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+
+        const auto entry{std::find_if(entries_.begin(), entries_.end(), [=](const auto& table) {
+            return table->matches(threshold1, threshold2, threshold3, near_lossless, bits_per_pixel);
+        })};
+        if (entry == entries_.end())
+            return nullptr;
+
+        std::rotate(entries_.begin(), entry, entry + 1);
+        return entries_.front();
+    }
+
+    // Adds the table, or returns the equal table that another thread added in the meantime.
+    std::shared_ptr<const quantization_lut> add(std::shared_ptr<const quantization_lut> table,
+                                                const int32_t threshold1, const int32_t threshold2,
+                                                const int32_t threshold3, const int32_t near_lossless,
+                                                const int32_t bits_per_pixel)
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+
+        for (const auto& entry : entries_)
+        {
+            if (entry->matches(threshold1, threshold2, threshold3, near_lossless, bits_per_pixel))
+                return entry;
+        }
+
+        if (entries_.size() == quantization_lut_cache_capacity)
+        {
+            entries_.pop_back();
+        }
+        entries_.insert(entries_.begin(), std::move(table));
+        return entries_.front();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<const quantization_lut>> entries_;
+};
+
+
+quantization_lut_cache& process_cache()
+{
+    // The cache is intentionally never destroyed: codecs in static objects may still use it during process exit.
+    static quantization_lut_cache* const cache{new quantization_lut_cache}; // NOLINT(cppcoreguidelines-owning-memory)
+    return *cache;
+}
+
+} // namespace
+
+
+quantization_lut::quantization_lut(const int32_t threshold1, const int32_t threshold2, const int32_t threshold3,
+                                   const int32_t near_lossless, const int32_t bits_per_pixel) :
+    threshold1_{threshold1},
+    threshold2_{threshold2},
+    threshold3_{threshold3},
+    near_lossless_{near_lossless},
+    bits_per_pixel_{bits_per_pixel},
+    lut_(static_cast<size_t>(2) << bits_per_pixel)
+{
+    const int32_t range{1 << bits_per_pixel};
+    for (size_t i{}; i != lut_.size(); ++i)
+    {
+        lut_[i] = quantize_gradient_org(threshold1, threshold2, threshold3, near_lossless,
+                                        static_cast<int32_t>(i) - range);
+    }
+}
+
+
+std::shared_ptr<const quantization_lut> get_quantization_lut(const int32_t threshold1, const int32_t threshold2,
+                                                             const int32_t threshold3, const int32_t near_lossless,
+                                                             const int32_t bits_per_pixel)
+{
+    quantization_lut_cache& cache{process_cache()};
+    auto table{cache.find(threshold1, threshold2, threshold3, near_lossless, bits_per_pixel)};
+    if (table)
+        return table;
+
+    // The table is computed without holding the lock, other threads can use the cache in the meantime.
+    table = std::make_shared<const quantization_lut>(threshold1, threshold2, threshold3, near_lossless, bits_per_pixel);
+    return cache.add(std::move(table), threshold1, threshold2, threshold3, near_lossless, bits_per_pixel);
+}
+
+} // namespace charls
@@ -0,0 +1,85 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace charls {
+
+/// <summary>
+/// Returns the quantized gradient (-4 .. 4) of the sample difference di.
+/// See JPEG-LS standard ISO/IEC 14495-1, A.3.3, Code segment A.4.
+/// </summary>
+constexpr int8_t quantize_gradient_org(const int32_t threshold1, const int32_t threshold2, const int32_t threshold3,
+                                       const int32_t near_lossless, const int32_t di) noexcept
+{
+    if (di <= -threshold3)
+        return -4;
+    if (di <= -threshold2)
+        return -3;
+    if (di <= -threshold1)
+        return -2;
+    if (di < -near_lossless)
+        return -1;
+    if (di <= near_lossless)
+        return 0;
+    if (di < threshold1)
+        return 1;
+    if (di < threshold2)
+        return 2;
+    if (di < threshold3)
+        return 3;
+
+    return 4;
+}
+
+
+// Maximum number of quantization lookup tables kept alive by the cache (a table is at most 128 KB).
+constexpr size_t quantization_lut_cache_capacity{16};
+
+// Purpose: immutable lookup table that maps a sample difference to its quantized gradient (-4 .. 4).
+class quantization_lut final
+{
+public:
+    quantization_lut(int32_t threshold1, int32_t threshold2, int32_t threshold3, int32_t near_lossless,
+                     int32_t bits_per_pixel);
+
+    /// <summary>
+    /// Returns a pointer to the entry of difference 0: the table can be indexed with a sample difference in the range
+    /// [-2^bits_per_pixel, 2^bits_per_pixel).
+    /// </summary>
+    const int8_t* center() const noexcept
+    {
+        return &lut_[lut_.size() / 2];
+    }
+
+    bool matches(const int32_t threshold1, const int32_t threshold2, const int32_t threshold3,
+                 const int32_t near_lossless, const int32_t bits_per_pixel) const noexcept
+    {
+        return threshold1_ == threshold1 && threshold2_ == threshold2 && threshold3_ == threshold3 &&
+               near_lossless_ == near_lossless && bits_per_pixel_ == bits_per_pixel;
+    }
+
+private:
+    int32_t threshold1_;
+    int32_t threshold2_;
+    int32_t threshold3_;
+    int32_t near_lossless_;
+    int32_t bits_per_pixel_;
+    std::vector<int8_t> lut_;
+};
+
+
+/// <summary>
+/// Returns the quantization lookup table for the thresholds, NEAR and bit count from the process-wide cache.
+/// The table is created and added to the cache when it is not present, the least recently used table is removed
+/// when the cache is full. A table remains valid while a reference to it exists. This function is thread safe.
+/// </summary>
+std::shared_ptr<const quantization_lut> get_quantization_lut(int32_t threshold1, int32_t threshold2, int32_t threshold3,
+                                                             int32_t near_lossless, int32_t bits_per_pixel);
+
+} // namespace charls
@@ -9,11 +9,16 @@
 #include "context_run_mode.h"
 #include "jpeg_marker_code.h"
 #include "lookup_table.h"
+#include "lossless_context_simd.h"
+#include "pixel_context.h"
 #include "process_line.h"
+#include "quantization_lut_cache.h"
 
 #include <array>
 #include <sstream>
 #include <limits>
+#include <memory>
+#include <type_traits>
 
 // This file contains the code for handling a "scan". Usually an image is encoded as a single scan.
 // Note: the functions in this header could be moved into jpegls.cpp as they are only used in that file.
@@ -23,11 +28,16 @@ namespace charls {
 class decoder_strategy;
 class encoder_strategy;
 
-extern const std::array<golomb_code_table, max_k_value> decoding_tables;
-extern const std::vector<int8_t> quantization_lut_lossless_8;
-extern const std::vector<int8_t> quantization_lut_lossless_10;
-extern const std::vector<int8_t> quantization_lut_lossless_12;
-extern const std::vector<int8_t> quantization_lut_lossless_16;
+/// <summary>
+/// Returns the max_k_value tables to decode short Golomb codes, the tables are created by the first call.
+/// </summary>
+const golomb_code_table* golomb_decoding_tables();
+
+/// <summary>
+/// Returns the center of the quantization lookup table for lossless coding with the default thresholds, or nullptr
+/// when there is no precomputed table for the bit count. The table is created by the first call.
+/// </summary>
+const int8_t* quantization_lut_lossless(int32_t bits_per_pixel);
 
 // Used to determine how large runs should be encoded at a time. Defined by the JPEG-LS standard, A.2.1., Initialization
 // step 3.
@@ -111,16 +121,23 @@ class jls_codec final : public Strategy
     // Factory function for ProcessLine objects to copy/transform un encoded pixels to/from our scan line buffers.
     std::unique_ptr<process_line> create_process_line(byte_span info, const size_t stride) override
     {
+        // A reused codec also reuses the process_line of its previous scan, which has the same type.
+        if (Strategy::process_line_ && Strategy::process_line_->reset(info, stride))
+            return std::move(Strategy::process_line_);
+
         if (!is_interleaved())
         {
-            if (frame_info().bits_per_sample == sizeof(sample_type) * 8)
+            // Only the source samples of the encoder need to be masked, the decoder copies the decoded samples.
+            if (frame_info().bits_per_sample == sizeof(sample_type) * 8 ||
+                std::is_same<Strategy, decoder_strategy>::value)
             {
                 return std::make_unique<post_process_single_component>(info.data, stride,
                                                                        sizeof(typename Traits::pixel_type));
             }
 
             return std::make_unique<post_process_single_component_masked>(
-                info.data, stride, sizeof(typename Traits::pixel_type), frame_info().bits_per_sample);
+                info.data, stride, sizeof(typename Traits::pixel_type), frame_info().bits_per_sample,
+                parameters().validate_sample_values);
         }
 
         if (parameters().transformation == color_transformation::none)
@@ -153,6 +170,7 @@ class jls_codec final : public Strategy
     {
         initialize_parameters(presets.threshold1, presets.threshold2, presets.threshold3, presets.reset_value);
         restart_interval_ = restart_interval;
+        restart_interval_counter_ = 0;
     }
 
     bool is_interleaved() noexcept
@@ -173,31 +191,9 @@ class jls_codec final : public Strategy
         return Strategy::frame_info_;
     }
 
-    int8_t quantize_gradient_org(const int32_t di) const noexcept
-    {
-        if (di <= -t3_)
-            return -4;
-        if (di <= -t2_)
-            return -3;
-        if (di <= -t1_)
-            return -2;
-        if (di < -traits_.near_lossless)
-            return -1;
-        if (di <= traits_.near_lossless)
-            return 0;
-        if (di < t1_)
-            return 1;
-        if (di < t2_)
-            return 2;
-        if (di < t3_)
-            return 3;
-
-        return 4;
-    }
-
     FORCE_INLINE int32_t quantize_gradient(const int32_t di) const noexcept
     {
-        ASSERT(quantize_gradient_org(di) == *(quantization_ + di));
+        ASSERT(quantize_gradient_org(t1_, t2_, t3_, traits_.near_lossless, di) == *(quantization_ + di));
         return *(quantization_ + di);
     }
 
@@ -215,38 +211,15 @@ class jls_codec final : public Strategy
             const jpegls_pc_parameters presets{compute_default(traits_.maximum_sample_value, traits_.near_lossless)};
             if (presets.threshold1 == t1_ && presets.threshold2 == t2_ && presets.threshold3 == t3_)
             {
-                if (traits_.bits_per_pixel == 8)
-                {
-                    quantization_ = &quantization_lut_lossless_8[quantization_lut_lossless_8.size() / 2];
-                    return;
-                }
-                if (traits_.bits_per_pixel == 10)
-                {
-                    quantization_ = &quantization_lut_lossless_10[quantization_lut_lossless_10.size() / 2];
-                    return;
-                }
-                if (traits_.bits_per_pixel == 12)
-                {
-                    quantization_ = &quantization_lut_lossless_12[quantization_lut_lossless_12.size() / 2];
-                    return;
-                }
-                if (traits_.bits_per_pixel == 16)
-                {
-                    quantization_ = &quantization_lut_lossless_16[quantization_lut_lossless_16.size() / 2];
+                quantization_ = quantization_lut_lossless(traits_.bits_per_pixel);
+                if (quantization_)
                     return;
-                }
             }
         }
 
-        // Initialize the quantization lookup table dynamic.
-        const int32_t range{1 << traits_.bits_per_pixel};
-        quantization_lut_.resize(static_cast<size_t>(range) * 2);
-        for (size_t i{}; i < quantization_lut_.size(); ++i)
-        {
-            quantization_lut_[i] = quantize_gradient_org(-range + static_cast<int32_t>(i));
-        }
-
-        quantization_ = &quantization_lut_[range];
+        // The tables of the other presets are shared by all codecs through the process-wide cache.
+        quantization_lut_ = get_quantization_lut(t1_, t2_, t3_, traits_.near_lossless, traits_.bits_per_pixel);
+        quantization_ = quantization_lut_->center();
     }
     MSVC_WARNING_UNSUPPRESS()
 
@@ -269,6 +242,16 @@ class jls_codec final : public Strategy
 
         if (high_bits < limit - traits_.quantized_bits_per_pixel - 1)
         {
+            // The code word is high_bits 0 bits, a 1 bit and the k low bits of the mapped error value.
+            const int32_t code_length{high_bits + 1 + k};
+            if (code_length < 32)
+            {
+                const uint32_t low_bits_mask{(1U << k) - 1U};
+                Strategy::append_to_bit_stream((1U << k) | (static_cast<uint32_t>(mapped_error) & low_bits_mask),
+                                               code_length);
+                return;
+            }
+
             if (high_bits + 1 > 31)
             {
                 Strategy::append_to_bit_stream(0, high_bits / 2);
@@ -311,7 +294,8 @@ class jls_codec final : public Strategy
         const int32_t predicted_value{traits_.correct_prediction(predicted + apply_sign(context.c(), sign))};
 
         int32_t error_value;
-        const golomb_code& code = decoding_tables[k].get(Strategy::peek_byte());
+        const golomb_code code{
+            decoding_tables_[k].get(Strategy::peek_bits(static_cast<int32_t>(golomb_code_table::bit_count)))};
         if (code.length() != 0)
         {
             Strategy::skip(code.length());
@@ -353,6 +337,12 @@ class jls_codec final : public Strategy
     /// <summary>Encodes/Decodes a scan line of samples</summary>
     FORCE_INLINE void do_line(sample_type* /*template_selector*/)
     {
+        if (lossless_context_kernel_)
+        {
+            encode_line_with_contexts();
+            return;
+        }
+
         int32_t index{};
         int32_t rb{previous_line_[index - 1]};
         int32_t rd{previous_line_[index]};
@@ -382,37 +372,82 @@ class jls_codec final : public Strategy
         }
     }
 
-    /// <summary>Encodes/Decodes a scan line of triplets in ILV_SAMPLE mode</summary>
-    void do_line(triplet<sample_type>* /*template_selector*/)
+#ifdef CHARLS_SSE2
+    pixel_context_sse2<sample_type> create_pixel_context() const noexcept
     {
+        return {t1_, t2_, t3_, traits_.near_lossless};
+    }
+#else
+    pixel_context_scalar create_pixel_context() const noexcept
+    {
+        return pixel_context_scalar{quantization_};
+    }
+#endif
+
+    /// <summary>Encodes a scan line of samples of a lossless scan with the contexts computed in advance</summary>
+    void encode_line_with_contexts()
+    {
+        compute_line_contexts();
+
         int32_t index{};
         while (static_cast<uint32_t>(index) < width_)
         {
-            const triplet<sample_type> ra{current_line_[index - 1]};
-            const triplet<sample_type> rc{previous_line_[index - 1]};
-            const triplet<sample_type> rb{previous_line_[index]};
-            const triplet<sample_type> rd{previous_line_[index + 1]};
+            const int32_t qs{line_context_ids_[index]};
+            if (qs != 0)
+            {
+                // Lossless: the reconstructed sample is equal to the source sample, the current line is not updated.
+                do_regular(qs, current_line_[index], line_predicted_values_[index], static_cast<Strategy*>(nullptr));
+                ++index;
+            }
+            else
+            {
+                index += do_run_mode(index, static_cast<Strategy*>(nullptr));
+            }
+        }
+    }
+
+    void compute_line_contexts() noexcept
+    {
+        size_t index{lossless_context_kernel_(previous_line_, current_line_, width_, t1_, t2_, t3_,
+                                              line_context_ids_.data(), line_predicted_values_.data())};
+
+        for (; index < width_; ++index)
+        {
+            const int32_t ra{current_line_[index - 1]};
+            const int32_t rb{previous_line_[index]};
+            const int32_t rc{previous_line_[index - 1]};
+            const int32_t rd{previous_line_[index + 1]};
 
-            const int32_t qs1{compute_context_id(quantize_gradient(rd.v1 - rb.v1), quantize_gradient(rb.v1 - rc.v1),
-                                                 quantize_gradient(rc.v1 - ra.v1))};
-            const int32_t qs2{compute_context_id(quantize_gradient(rd.v2 - rb.v2), quantize_gradient(rb.v2 - rc.v2),
-                                                 quantize_gradient(rc.v2 - ra.v2))};
-            const int32_t qs3{compute_context_id(quantize_gradient(rd.v3 - rb.v3), quantize_gradient(rb.v3 - rc.v3),
-                                                 quantize_gradient(rc.v3 - ra.v3))};
+            line_context_ids_[index] = static_cast<int16_t>(
+                compute_context_id(quantize_gradient(rd - rb), quantize_gradient(rb - rc), quantize_gradient(rc - ra)));
+            line_predicted_values_[index] = static_cast<sample_type>(get_predicted_value(ra, rb, rc));
+        }
+    }
 
-            if (qs1 == 0 && qs2 == 0 && qs3 == 0)
+    /// <summary>Encodes/Decodes a scan line of triplets in ILV_SAMPLE mode</summary>
+    void do_line(triplet<sample_type>* /*template_selector*/)
+    {
+        auto context{create_pixel_context()};
+        int32_t index{};
+        while (static_cast<uint32_t>(index) < width_)
+        {
+            if (context.compute(current_line_ + index - 1, previous_line_ + index - 1))
             {
                 index += do_run_mode(index, static_cast<Strategy*>(nullptr));
             }
             else
             {
+                const triplet<sample_type> ra{current_line_[index - 1]};
+                const triplet<sample_type> rc{previous_line_[index - 1]};
+                const triplet<sample_type> rb{previous_line_[index]};
+
                 triplet<sample_type> rx;
-                rx.v1 = do_regular(qs1, current_line_[index].v1, get_predicted_value(ra.v1, rb.v1, rc.v1),
-                                   static_cast<Strategy*>(nullptr));
-                rx.v2 = do_regular(qs2, current_line_[index].v2, get_predicted_value(ra.v2, rb.v2, rc.v2),
-                                   static_cast<Strategy*>(nullptr));
-                rx.v3 = do_regular(qs3, current_line_[index].v3, get_predicted_value(ra.v3, rb.v3, rc.v3),
-                                   static_cast<Strategy*>(nullptr));
+                rx.v1 = do_regular(context.context_id(0), current_line_[index].v1,
+                                   get_predicted_value(ra.v1, rb.v1, rc.v1), static_cast<Strategy*>(nullptr));
+                rx.v2 = do_regular(context.context_id(1), current_line_[index].v2,
+                                   get_predicted_value(ra.v2, rb.v2, rc.v2), static_cast<Strategy*>(nullptr));
+                rx.v3 = do_regular(context.context_id(2), current_line_[index].v3,
+                                   get_predicted_value(ra.v3, rb.v3, rc.v3), static_cast<Strategy*>(nullptr));
                 current_line_[index] = rx;
                 ++index;
             }
@@ -438,18 +473,53 @@ class jls_codec final : public Strategy
         Strategy::process_line_ = std::move(process_line);
 
         Strategy::initialize(destination);
+        initialize_line_contexts();
+
+        // Process images without a restart interval, as 1 large restart interval.
+        if (restart_interval_ == 0)
+        {
+            restart_interval_ = frame_info().height;
+        }
+
         encode_lines();
 
         return Strategy::get_length();
     }
 
     // NOLINTNEXTLINE(cppcoreguidelines-explicit-virtual-functions, hicpp-use-override, modernize-use-override, clang-diagnostic-suggest-override)
-    size_t decode_scan(std::unique_ptr<process_line> process_line, const JlsRect& rect, const_byte_span encoded_source)
+    size_t encode_restart_interval(std::unique_ptr<process_line> process_line, byte_span destination,
+                                   const uint32_t interval_index)
+    {
+        Strategy::process_line_ = std::move(process_line);
+
+        Strategy::initialize(destination);
+        initialize_line_contexts();
+
+        if (restart_interval_ == 0)
+        {
+            restart_interval_ = frame_info().height;
+        }
+
+        const uint32_t first_line{interval_index * restart_interval_};
+        ASSERT(first_line < frame_info().height);
+
+        clear_line_buffers();
+        encode_lines(first_line, std::min(frame_info().height - first_line, restart_interval_), line_buffer_,
+                     run_indices_);
+        Strategy::end_scan();
+
+        return Strategy::get_length();
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-explicit-virtual-functions, hicpp-use-override, modernize-use-override, clang-diagnostic-suggest-override)
+    size_t decode_scan(std::unique_ptr<process_line> process_line, const JlsRect& rect, const_byte_span encoded_source,
+                       const uint32_t first_interval_index, const uint32_t end_line)
     {
         Strategy::process_line_ = std::move(process_line);
 
         const auto* scan_begin{encoded_source.begin()};
         rect_ = rect;
+        decoding_tables_ = golomb_decoding_tables();
 
         Strategy::initialize(encoded_source);
 
@@ -459,9 +529,44 @@ class jls_codec final : public Strategy
             restart_interval_ = frame_info().height;
         }
 
-        decode_lines();
+        decode_lines(first_interval_index, end_line);
+
+        // When decoding stops before the end of the scan, the position is somewhere in the entropy coded data.
+        return (end_line == frame_info().height ? Strategy::get_cur_byte_pos() : Strategy::position()) - scan_begin;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-explicit-virtual-functions, hicpp-use-override, modernize-use-override, clang-diagnostic-suggest-override)
+    size_t decode_restart_interval(std::unique_ptr<process_line> process_line, const JlsRect& rect,
+                                   const_byte_span encoded_source, const uint32_t interval_index)
+    {
+        Strategy::process_line_ = std::move(process_line);
+
+        const auto* interval_begin{encoded_source.begin()};
+        rect_ = rect;
+        decoding_tables_ = golomb_decoding_tables();
+
+        Strategy::initialize(encoded_source);
+
+        if (restart_interval_ == 0)
+        {
+            restart_interval_ = frame_info().height;
+        }
+
+        const uint32_t first_line{interval_index * restart_interval_};
+        ASSERT(first_line < frame_info().height);
+        const uint32_t lines_in_interval{std::min(frame_info().height - first_line, restart_interval_)};
+
+        clear_line_buffers();
+        decode_lines(first_line, lines_in_interval, line_buffer_, run_indices_);
+
+        if (first_line + lines_in_interval == frame_info().height)
+        {
+            Strategy::end_scan();
+            return Strategy::get_cur_byte_pos() - interval_begin;
+        }
 
-        return Strategy::get_cur_byte_pos() - scan_begin;
+        // A restart marker is expected at the current read position.
+        return Strategy::position() - interval_begin;
     }
 
     // clang-format on
@@ -473,12 +578,17 @@ class jls_codec final : public Strategy
 
     void initialize_parameters(const int32_t t1, const int32_t t2, const int32_t t3, const int32_t reset_threshold)
     {
+        // A reused codec only needs to compute the quantization lookup table again when the thresholds changed.
+        const bool thresholds_changed{!quantization_ || t1 != t1_ || t2 != t2_ || t3 != t3_};
         t1_ = t1;
         t2_ = t2;
         t3_ = t3;
         reset_threshold_ = static_cast<uint8_t>(reset_threshold);
 
-        initialize_quantization_lut();
+        if (thresholds_changed)
+        {
+            initialize_quantization_lut();
+        }
         reset_parameters();
     }
 
@@ -495,6 +605,22 @@ class jls_codec final : public Strategy
         run_index_ = 0;
     }
 
+    // In lossless mode the reconstructed samples are equal to the source samples: the encoder can compute the context
+    // ids and predicted values of a complete line with a vectorized kernel, before the line is encoded.
+    void initialize_line_contexts()
+    {
+        if (!std::is_same<Strategy, encoder_strategy>::value || !std::is_same<pixel_type, sample_type>::value ||
+            traits_.near_lossless != 0 || traits_.maximum_sample_value != (1 << traits_.bits_per_pixel) - 1)
+            return;
+
+        lossless_context_kernel_ = select_lossless_context_kernel(sizeof(sample_type));
+        if (lossless_context_kernel_)
+        {
+            line_context_ids_.resize(width_);
+            line_predicted_values_.resize(width_);
+        }
+    }
+
     static charls::frame_info update_component_count(charls::frame_info frame, const coding_parameters& parameters) noexcept
     {
         if (parameters.interleave_mode == interleave_mode::none)
@@ -510,14 +636,52 @@ class jls_codec final : public Strategy
     // In ILV_NONE mode, do_scan is called for each component
     void encode_lines()
     {
-        const uint32_t pixel_stride{width_ + 4U};
-        const size_t component_count{
-            parameters().interleave_mode == interleave_mode::line ? static_cast<size_t>(frame_info().component_count) : 1U};
+        clear_line_buffers();
 
-        std::vector<pixel_type> line_buffer(component_count * pixel_stride * 2);
-        std::vector<int32_t> run_index(component_count);
+        for (uint32_t line{};;)
+        {
+            const uint32_t lines_in_interval{std::min(frame_info().height - line, restart_interval_)};
+            encode_lines(line, lines_in_interval, line_buffer_, run_indices_);
+            line += lines_in_interval;
+
+            if (line == frame_info().height)
+                break;
+
+            // Complete the restart interval with a restart marker and reset the encoder for the next interval.
+            Strategy::end_scan();
+            Strategy::write_restart_marker(restart_interval_counter_);
+            restart_interval_counter_ = (restart_interval_counter_ + 1) % jpeg_restart_marker_range;
+
+            clear_line_buffers();
+            reset_parameters();
+        }
 
-        for (uint32_t line{}; line < frame_info().height; ++line)
+        Strategy::end_scan();
+    }
+
+    // Encodes the lines of 1 restart interval, the line buffer and run index are expected to be zero initialized.
+    void encode_lines(const uint32_t first_line, const uint32_t line_count, internal_vector<pixel_type>& line_buffer,
+                      internal_vector<int32_t>& run_index)
+    {
+        // The lines of single component images are copied without a virtual call for every line.
+        if (auto* const single_component{Strategy::process_line_->as_single_component()})
+        {
+            encode_lines(first_line, line_count, line_buffer, run_index, *single_component);
+        }
+        else
+        {
+            encode_lines(first_line, line_count, line_buffer, run_index, *Strategy::process_line_);
+        }
+    }
+
+    template<typename ProcessLine>
+    void encode_lines(const uint32_t first_line, const uint32_t line_count, internal_vector<pixel_type>& line_buffer,
+                      internal_vector<int32_t>& run_index, ProcessLine& process_line)
+    {
+        const uint32_t pixel_stride{width_ + 4U};
+        const size_t component_count{run_index.size()};
+
+        for (uint32_t line{first_line}; line < first_line + line_count; ++line)
         {
             previous_line_ = &line_buffer[1];
             current_line_ = &line_buffer[1 + static_cast<size_t>(component_count) * pixel_stride];
@@ -526,7 +690,7 @@ class jls_codec final : public Strategy
                 std::swap(previous_line_, current_line_);
             }
 
-            Strategy::on_line_begin(current_line_, width_, pixel_stride);
+            process_line.new_line_requested(current_line_, width_, pixel_stride);
 
             for (size_t component{}; component < component_count; ++component)
             {
@@ -542,56 +706,41 @@ class jls_codec final : public Strategy
                 current_line_ += pixel_stride;
             }
         }
+    }
 
-        Strategy::end_scan();
+    size_t line_component_count() const noexcept
+    {
+        return parameters().interleave_mode == interleave_mode::line ? static_cast<size_t>(frame_info().component_count)
+                                                                      : 1U;
     }
 
-    void decode_lines()
+    size_t line_buffer_size() const noexcept
     {
-        const uint32_t pixel_stride{width_ + 4U};
-        const size_t component_count{
-            parameters().interleave_mode == interleave_mode::line ? static_cast<size_t>(frame_info().component_count) : 1U};
+        return line_component_count() * (width_ + 4U) * 2;
+    }
 
-        std::vector<pixel_type> line_buffer(component_count * pixel_stride * 2);
-        std::vector<int32_t> run_index(component_count);
+    // The line buffers are kept by the codec: a reused codec doesn't need to allocate them again.
+    void clear_line_buffers()
+    {
+        line_buffer_.assign(line_buffer_size(), pixel_type{});
+        run_indices_.assign(line_component_count(), 0);
+    }
 
-        for (uint32_t line{};;)
-        {
-            const uint32_t lines_in_interval{std::min(frame_info().height - line, restart_interval_)};
+    // Decodes the lines from the start of the given restart interval up to (not including) the end line.
+    void decode_lines(const uint32_t first_interval_index, const uint32_t end_line)
+    {
+        clear_line_buffers();
 
-            for (uint32_t mcu{}; mcu < lines_in_interval; ++mcu, ++line)
-            {
-                previous_line_ = &line_buffer[1];
-                current_line_ = &line_buffer[1 + static_cast<size_t>(component_count) * pixel_stride];
-                if ((line & 1) == 1)
-                {
-                    std::swap(previous_line_, current_line_);
-                }
-
-                for (size_t component{}; component < component_count; ++component)
-                {
-                    run_index_ = run_index[component];
-
-                    // initialize edge pixels used for prediction
-                    previous_line_[width_] = previous_line_[width_ - 1];
-                    current_line_[-1] = previous_line_[0];
-                    do_line(static_cast<pixel_type*>(nullptr)); // dummy argument for overload resolution
-
-                    run_index[component] = run_index_;
-                    previous_line_ += pixel_stride;
-                    current_line_ += pixel_stride;
-                }
-
-                // Only copy the line if it is part of the output rectangle.
-                if (static_cast<uint32_t>(rect_.Y) <= line && line < static_cast<uint32_t>(rect_.Y + rect_.Height))
-                {
-                    Strategy::on_line_end(current_line_ + rect_.X - (static_cast<size_t>(component_count) * pixel_stride),
-                                          rect_.Width,
-                                          pixel_stride);
-                }
-            }
+        ASSERT(first_interval_index * static_cast<uint64_t>(restart_interval_) < end_line);
+        ASSERT(end_line <= frame_info().height);
+        restart_interval_counter_ = first_interval_index % jpeg_restart_marker_range;
+        for (uint32_t line{first_interval_index * restart_interval_};;)
+        {
+            const uint32_t lines_in_interval{std::min(end_line - line, restart_interval_)};
+            decode_lines(line, lines_in_interval, line_buffer_, run_indices_);
+            line += lines_in_interval;
 
-            if (line == frame_info().height)
+            if (line == end_line)
                 break;
 
             // At this point in the byte stream a restart marker should be present: process it.
@@ -600,12 +749,70 @@ class jls_codec final : public Strategy
 
             // After a restart marker it is required to reset the decoder.
             Strategy::reset();
-            std::fill(line_buffer.begin(), line_buffer.end(), pixel_type{});
-            std::fill(run_index.begin(), run_index.end(), 0);
+            clear_line_buffers();
             reset_parameters();
         }
 
-        Strategy::end_scan();
+        // The remaining entropy coded data is not validated when decoding stops before the last line.
+        if (end_line == frame_info().height)
+        {
+            Strategy::end_scan();
+        }
+    }
+
+    // Decodes the lines of 1 restart interval, the line buffer and run index are expected to be zero initialized.
+    void decode_lines(const uint32_t first_line, const uint32_t line_count, internal_vector<pixel_type>& line_buffer,
+                      internal_vector<int32_t>& run_index)
+    {
+        // The lines of single component images are copied without a virtual call for every line.
+        if (auto* const single_component{Strategy::process_line_->as_single_component()})
+        {
+            decode_lines(first_line, line_count, line_buffer, run_index, *single_component);
+        }
+        else
+        {
+            decode_lines(first_line, line_count, line_buffer, run_index, *Strategy::process_line_);
+        }
+    }
+
+    template<typename ProcessLine>
+    void decode_lines(const uint32_t first_line, const uint32_t line_count, internal_vector<pixel_type>& line_buffer,
+                      internal_vector<int32_t>& run_index, ProcessLine& process_line)
+    {
+        const uint32_t pixel_stride{width_ + 4U};
+        const size_t component_count{run_index.size()};
+
+        for (uint32_t line{first_line}; line < first_line + line_count; ++line)
+        {
+            previous_line_ = &line_buffer[1];
+            current_line_ = &line_buffer[1 + static_cast<size_t>(component_count) * pixel_stride];
+            if ((line & 1) == 1)
+            {
+                std::swap(previous_line_, current_line_);
+            }
+
+            for (size_t component{}; component < component_count; ++component)
+            {
+                run_index_ = run_index[component];
+
+                // initialize edge pixels used for prediction
+                previous_line_[width_] = previous_line_[width_ - 1];
+                current_line_[-1] = previous_line_[0];
+                do_line(static_cast<pixel_type*>(nullptr)); // dummy argument for overload resolution
+
+                run_index[component] = run_index_;
+                previous_line_ += pixel_stride;
+                current_line_ += pixel_stride;
+            }
+
+            // Only copy the line if it is part of the output rectangle.
+            if (static_cast<uint32_t>(rect_.Y) <= line && line < static_cast<uint32_t>(rect_.Y + rect_.Height))
+            {
+                process_line.new_line_decoded(
+                    current_line_ + rect_.X - (static_cast<size_t>(component_count) * pixel_stride), rect_.Width,
+                    pixel_stride);
+            }
+        }
     }
 
     void read_restart_marker()
@@ -627,38 +834,29 @@ class jls_codec final : public Strategy
     /// <summary>Encodes/Decodes a scan line of quads in ILV_SAMPLE mode</summary>
     void do_line(quad<sample_type>* /*template_selector*/)
     {
+        auto context{create_pixel_context()};
         int32_t index{};
         while (static_cast<uint32_t>(index) < width_)
         {
-            const quad<sample_type> ra{current_line_[index - 1]};
-            const quad<sample_type> rc{previous_line_[index - 1]};
-            const quad<sample_type> rb{previous_line_[index]};
-            const quad<sample_type> rd{previous_line_[index + 1]};
-
-            const int32_t qs1{compute_context_id(quantize_gradient(rd.v1 - rb.v1), quantize_gradient(rb.v1 - rc.v1),
-                                                 quantize_gradient(rc.v1 - ra.v1))};
-            const int32_t qs2{compute_context_id(quantize_gradient(rd.v2 - rb.v2), quantize_gradient(rb.v2 - rc.v2),
-                                                 quantize_gradient(rc.v2 - ra.v2))};
-            const int32_t qs3{compute_context_id(quantize_gradient(rd.v3 - rb.v3), quantize_gradient(rb.v3 - rc.v3),
-                                                 quantize_gradient(rc.v3 - ra.v3))};
-            const int32_t qs4{compute_context_id(quantize_gradient(rd.v4 - rb.v4), quantize_gradient(rb.v4 - rc.v4),
-                                                 quantize_gradient(rc.v4 - ra.v4))};
-
-            if (qs1 == 0 && qs2 == 0 && qs3 == 0 && qs4 == 0)
+            if (context.compute(current_line_ + index - 1, previous_line_ + index - 1))
             {
                 index += do_run_mode(index, static_cast<Strategy*>(nullptr));
             }
             else
             {
+                const quad<sample_type> ra{current_line_[index - 1]};
+                const quad<sample_type> rc{previous_line_[index - 1]};
+                const quad<sample_type> rb{previous_line_[index]};
+
                 quad<sample_type> rx;
-                rx.v1 = do_regular(qs1, current_line_[index].v1, get_predicted_value(ra.v1, rb.v1, rc.v1),
-                                   static_cast<Strategy*>(nullptr));
-                rx.v2 = do_regular(qs2, current_line_[index].v2, get_predicted_value(ra.v2, rb.v2, rc.v2),
-                                   static_cast<Strategy*>(nullptr));
-                rx.v3 = do_regular(qs3, current_line_[index].v3, get_predicted_value(ra.v3, rb.v3, rc.v3),
-                                   static_cast<Strategy*>(nullptr));
-                rx.v4 = do_regular(qs4, current_line_[index].v4, get_predicted_value(ra.v4, rb.v4, rc.v4),
-                                   static_cast<Strategy*>(nullptr));
+                rx.v1 = do_regular(context.context_id(0), current_line_[index].v1,
+                                   get_predicted_value(ra.v1, rb.v1, rc.v1), static_cast<Strategy*>(nullptr));
+                rx.v2 = do_regular(context.context_id(1), current_line_[index].v2,
+                                   get_predicted_value(ra.v2, rb.v2, rc.v2), static_cast<Strategy*>(nullptr));
+                rx.v3 = do_regular(context.context_id(2), current_line_[index].v3,
+                                   get_predicted_value(ra.v3, rb.v3, rc.v3), static_cast<Strategy*>(nullptr));
+                rx.v4 = do_regular(context.context_id(3), current_line_[index].v4,
+                                   get_predicted_value(ra.v4, rb.v4, rc.v4), static_cast<Strategy*>(nullptr));
                 current_line_[index] = rx;
                 ++index;
             }
@@ -897,11 +1095,19 @@ class jls_codec final : public Strategy
     pixel_type* previous_line_{};
     pixel_type* current_line_{};
 
-    // quantization lookup table
-    const int8_t* quantization_{};
-    std::vector<int8_t> quantization_lut_;
-};
+    // line buffers (previous and current line of every component in the line) and the run index of every component
+    internal_vector<pixel_type> line_buffer_;
+    internal_vector<int32_t> run_indices_;
 
+    // quantization lookup table and the Golomb code decoding tables (decoder only)
+    const int8_t* quantization_{};
+    const golomb_code_table* decoding_tables_{};
+    std::shared_ptr<const quantization_lut> quantization_lut_;
 
+    // contexts of the current line, computed in advance by the lossless encoder
+    lossless_context_kernel lossless_context_kernel_{};
+    internal_vector<int16_t> line_context_ids_;
+    internal_vector<sample_type> line_predicted_values_;
+};
 
 } // namespace charls
@@ -0,0 +1,102 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "thread_pool.h"
+
+#include "parallel_for.h"
+
+#include <exception>
+
+namespace charls {
+
+thread_pool::thread_pool(const uint32_t thread_count)
+{
+    try
+    {
+        workers_.reserve(thread_count);
+        for (uint32_t i{}; i != thread_count; ++i)
+        {
+            workers_.emplace_back(&thread_pool::run, this);
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Not being able to create (all) worker threads is not fatal: submit will reject tasks when there are no workers.
+    }
+}
+
+
+thread_pool::~thread_pool()
+{
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+    task_available_.notify_all();
+
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+
+bool thread_pool::submit(const charls_executor_task task, void* task_context)
+{
+    if (workers_.empty())
+        return false;
+
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        tasks_.emplace_back(task, task_context);
+    }
+    task_available_.notify_one();
+    return true;
+}
+
+
+void thread_pool::run() noexcept
+{
+    for (;;)
+    {
+        std::pair<charls_executor_task, void*> task;
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            task_available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty())
+                return;
+
+            task = tasks_.front();
+            tasks_.pop_front();
+        }
+
+        task.first(task.second);
+    }
+}
+
+
+namespace {
+
+int32_t CHARLS_API_CALLING_CONVENTION submit_to_default_thread_pool(const charls_executor_task task, void* task_context,
+                                                                    void* /*user_context*/) noexcept
+try
+{
+    // The calling thread also executes tasks, 1 worker thread less is needed to use all hardware threads.
+    // The pool is intentionally never destroyed: joining threads during process exit can deadlock on some platforms.
+    static thread_pool* const pool{new thread_pool{std::max(resolve_thread_count(0) - 1, 1U)}}; // NOLINT(cppcoreguidelines-owning-memory)
+    return pool->submit(task, task_context) ? 0 : 1;
+}
+catch (...)
+{
+    return 1;
+}
+
+} // namespace
+
+
+charls_executor default_executor() noexcept
+{
+    return {&submit_to_default_thread_pool, nullptr};
+}
+
+} // namespace charls
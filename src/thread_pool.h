@@ -0,0 +1,52 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "charls/public_types.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace charls {
+
+// Purpose: a simple pool of worker threads that execute the submitted tasks in FIFO order.
+class thread_pool final
+{
+public:
+    explicit thread_pool(uint32_t thread_count);
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool(thread_pool&&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    thread_pool& operator=(thread_pool&&) = delete;
+
+    /// <summary>
+    /// Adds a task to the queue. Returns false when the pool has no worker threads.
+    /// </summary>
+    bool submit(charls_executor_task task, void* task_context);
+
+private:
+    void run() noexcept;
+
+    std::mutex mutex_;
+    std::condition_variable task_available_;
+    std::deque<std::pair<charls_executor_task, void*>> tasks_;
+    std::vector<std::thread> workers_;
+    bool stopping_{};
+};
+
+
+/// <summary>
+/// Returns the executor that submits tasks to the built-in thread pool.
+/// The built-in pool is started the first time a task is submitted.
+/// </summary>
+charls_executor default_executor() noexcept;
+
+} // namespace charls
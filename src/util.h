@@ -370,6 +370,18 @@ T read_big_endian_unaligned(const void* buffer) noexcept
 #endif
 
 
+template<typename T>
+void write_big_endian_unaligned(void* buffer, const T value) noexcept
+{
+#ifdef LITTLE_ENDIAN_ARCHITECTURE
+    const T big_endian_value{byte_swap(value)};
+#else
+    const T big_endian_value{value};
+#endif
+    memcpy(buffer, &big_endian_value, sizeof(T));
+}
+
+
 inline void skip_bytes(byte_span& stream_info, const size_t count) noexcept
 {
     ASSERT(count <= stream_info.size);
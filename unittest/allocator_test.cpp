@@ -0,0 +1,188 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.h"
+
+#include "util.h"
+
+#include <charls/charls.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <tuple>
+#include <vector>
+
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using std::atomic;
+using std::vector;
+using namespace charls_test;
+
+namespace charls { namespace test {
+
+namespace {
+
+class counting_allocator final : public allocator
+{
+public:
+    void* allocate(const size_t size) override
+    {
+        if (fail)
+            return nullptr;
+
+        ++allocation_count;
+        allocated_bytes += size;
+        return malloc(size); // NOLINT(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+    }
+
+    void deallocate(void* memory, const size_t size) noexcept override
+    {
+        ++deallocation_count;
+        allocated_bytes -= size;
+        free(memory); // NOLINT(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+    }
+
+    atomic<int> allocation_count{};
+    atomic<int> deallocation_count{};
+    atomic<size_t> allocated_bytes{};
+    bool fail{};
+};
+
+
+void* CHARLS_API_CALLING_CONVENTION allocate_nothing(size_t /* size */, void* /* user_context */) noexcept
+{
+    return nullptr;
+}
+
+} // namespace
+
+
+TEST_CLASS(allocator_test)
+{
+public:
+    TEST_METHOD(decoder_allocates_with_allocator) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/t8c1e0.jls")};
+        counting_allocator allocator;
+
+        {
+            jpegls_decoder decoder;
+            decoder.allocator(allocator);
+            decoder.source(source).read_header();
+            vector<uint8_t> destination(decoder.destination_size());
+            decoder.decode(destination);
+
+            Assert::IsTrue(allocator.allocation_count > 0);
+        }
+
+        Assert::AreEqual(allocator.allocation_count.load(), allocator.deallocation_count.load());
+        Assert::AreEqual(size_t{}, allocator.allocated_bytes.load());
+    }
+
+    TEST_METHOD(decoder_allocates_nothing_after_warm_up) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/t8c1e0.jls")};
+        counting_allocator allocator;
+        jpegls_decoder decoder;
+        decoder.allocator(allocator);
+        vector<uint8_t> destination;
+
+        for (int i{}; i != 3; ++i)
+        {
+            const int allocation_count{allocator.allocation_count};
+
+            decoder.reset();
+            decoder.source(source).read_header();
+            destination.resize(decoder.destination_size());
+            decoder.decode(destination);
+
+            if (i != 0)
+            {
+                Assert::AreEqual(allocation_count, allocator.allocation_count.load());
+            }
+        }
+    }
+
+    TEST_METHOD(encoder_allocates_nothing_after_warm_up) // NOLINT
+    {
+        const vector<uint8_t> source(size_t{64} * 64 * 3, 7);
+        counting_allocator allocator;
+
+        {
+            jpegls_encoder encoder;
+            encoder.allocator(allocator).frame_info({64, 64, 8, 3}).interleave_mode(interleave_mode::sample);
+            vector<uint8_t> destination(encoder.estimated_destination_size());
+
+            for (int i{}; i != 3; ++i)
+            {
+                const int allocation_count{allocator.allocation_count};
+
+                encoder.reset();
+                encoder.destination(destination);
+                std::ignore = encoder.encode(source);
+
+                if (i == 0)
+                {
+                    Assert::IsTrue(allocator.allocation_count > allocation_count);
+                }
+                else
+                {
+                    Assert::AreEqual(allocation_count, allocator.allocation_count.load());
+                }
+            }
+        }
+
+        Assert::AreEqual(allocator.allocation_count.load(), allocator.deallocation_count.load());
+    }
+
+    TEST_METHOD(decode_with_allocator_that_fails_throws) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/t8c1e0.jls")};
+        counting_allocator allocator;
+        allocator.fail = true;
+        jpegls_decoder decoder;
+        decoder.allocator(allocator);
+        decoder.source(source);
+
+        assert_expect_exception(jpegls_errc::not_enough_memory, [&decoder] { decoder.read_header(); });
+    }
+
+    TEST_METHOD(set_allocator_is_used_by_decoder_without_allocator) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/t8c1e0.jls")};
+        counting_allocator allocator;
+
+        set_allocator(&allocator);
+        {
+            jpegls_decoder decoder;
+            decoder.source(source).read_header();
+            vector<uint8_t> destination(decoder.destination_size());
+            decoder.decode(destination);
+        }
+        set_allocator(nullptr);
+
+        Assert::IsTrue(allocator.allocation_count > 0);
+        Assert::AreEqual(allocator.allocation_count.load(), allocator.deallocation_count.load());
+    }
+
+    TEST_METHOD(set_allocator_without_deallocate_throws) // NOLINT
+    {
+        const charls_allocator allocator{&allocate_nothing, nullptr, nullptr};
+
+        const auto error{charls_set_allocator(&allocator)};
+
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
+    TEST_METHOD(decoder_set_allocator_without_allocate_throws) // NOLINT
+    {
+        charls_jpegls_decoder* decoder{charls_jpegls_decoder_create()};
+        const charls_allocator allocator{};
+
+        const auto error{charls_jpegls_decoder_set_allocator(decoder, &allocator)};
+
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+        charls_jpegls_decoder_destroy(decoder);
+    }
+};
+
+}} // namespace charls::test
@@ -47,6 +47,12 @@ TEST_CLASS(charls_jpegls_decoder_test)
         Assert::AreEqual(jpegls_errc::invalid_argument, error);
     }
 
+    TEST_METHOD(reset_nullptr) // NOLINT
+    {
+        const auto error{charls_jpegls_decoder_reset(nullptr)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
     TEST_METHOD(read_spiff_header_nullptr) // NOLINT
     {
         charls_spiff_header spiff_header{};
@@ -154,6 +160,40 @@ TEST_CLASS(charls_jpegls_decoder_test)
         charls_jpegls_decoder_destroy(decoder);
     }
 
+    TEST_METHOD(get_region_destination_size_nullptr) // NOLINT
+    {
+        constexpr charls_region region{0, 0, 1, 1};
+        size_t destination_size_bytes;
+        auto error{charls_jpegls_decoder_get_region_destination_size(nullptr, &region, 0, &destination_size_bytes)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        const auto* decoder{get_initialized_decoder()};
+        error = charls_jpegls_decoder_get_region_destination_size(decoder, nullptr, 0, &destination_size_bytes);
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        error = charls_jpegls_decoder_get_region_destination_size(decoder, &region, 0, nullptr);
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        charls_jpegls_decoder_destroy(decoder);
+    }
+
+    TEST_METHOD(decode_region_to_buffer_nullptr) // NOLINT
+    {
+        constexpr charls_region region{0, 0, 1, 1};
+        array<uint8_t, 5> buffer{};
+        auto error{charls_jpegls_decoder_decode_region_to_buffer(nullptr, &region, buffer.data(), buffer.size(), 0)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        auto* decoder{get_initialized_decoder()};
+        error = charls_jpegls_decoder_decode_region_to_buffer(decoder, nullptr, buffer.data(), buffer.size(), 0);
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        error = charls_jpegls_decoder_decode_region_to_buffer(decoder, &region, nullptr, buffer.size(), 0);
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        charls_jpegls_decoder_destroy(decoder);
+    }
+
     TEST_METHOD(read_header_from_zero_size_buffer) // NOLINT
     {
         auto* decoder{charls_jpegls_decoder_create()};
@@ -188,6 +228,72 @@ TEST_CLASS(charls_jpegls_decoder_test)
         Assert::AreEqual(jpegls_errc::invalid_argument, error);
     }
 
+    TEST_METHOD(set_thread_count_nullptr) // NOLINT
+    {
+        const auto error{charls_jpegls_decoder_set_thread_count(nullptr, 2)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
+    TEST_METHOD(set_executor_nullptr) // NOLINT
+    {
+        const auto error{charls_jpegls_decoder_set_executor(nullptr, nullptr)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
+    TEST_METHOD(set_allocator_nullptr) // NOLINT
+    {
+        const auto error{charls_jpegls_decoder_set_allocator(nullptr, nullptr)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
+    TEST_METHOD(read_restart_intervals_nullptr) // NOLINT
+    {
+        size_t count;
+        auto error{charls_jpegls_decoder_read_restart_intervals(nullptr, &count)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        auto* decoder{get_initialized_decoder()};
+        error = charls_jpegls_decoder_read_restart_intervals(decoder, nullptr);
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        charls_jpegls_decoder_destroy(decoder);
+    }
+
+    TEST_METHOD(get_restart_interval_info_nullptr) // NOLINT
+    {
+        charls_restart_interval_info info;
+        auto error{charls_jpegls_decoder_get_restart_interval_info(nullptr, 0, &info)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        const auto* decoder{get_initialized_decoder()};
+        error = charls_jpegls_decoder_get_restart_interval_info(decoder, 0, nullptr);
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        charls_jpegls_decoder_destroy(decoder);
+    }
+
+    TEST_METHOD(decode_restart_interval_nullptr) // NOLINT
+    {
+        array<uint8_t, 5> buffer{};
+        auto error{charls_jpegls_decoder_decode_restart_interval(nullptr, 0, buffer.data(), buffer.size(), 0)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        const auto* decoder{get_initialized_decoder()};
+        error = charls_jpegls_decoder_decode_restart_interval(decoder, 0, nullptr, buffer.size(), 0);
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        charls_jpegls_decoder_destroy(decoder);
+    }
+
+    TEST_METHOD(decode_batch_nullptr) // NOLINT
+    {
+        auto error{charls_jpegls_decode_batch(nullptr, 1, 0, nullptr)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        error = charls_jpegls_decode_batch(nullptr, 0, 0, nullptr);
+        Assert::AreEqual(jpegls_errc::success, error);
+    }
+
 private:
     static charls_jpegls_decoder* get_initialized_decoder()
     {
@@ -184,6 +184,45 @@ TEST_CLASS(charls_jpegls_encoder_test)
         Assert::AreEqual(jpegls_errc::invalid_argument, error);
     }
 
+    TEST_METHOD(reset_nullptr) // NOLINT
+    {
+        const auto error{charls_jpegls_encoder_reset(nullptr)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
+    TEST_METHOD(set_restart_interval_nullptr) // NOLINT
+    {
+        const auto error{charls_jpegls_encoder_set_restart_interval(nullptr, 8)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
+    TEST_METHOD(set_thread_count_nullptr) // NOLINT
+    {
+        const auto error{charls_jpegls_encoder_set_thread_count(nullptr, 2)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
+    TEST_METHOD(set_executor_nullptr) // NOLINT
+    {
+        const auto error{charls_jpegls_encoder_set_executor(nullptr, nullptr)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
+    TEST_METHOD(set_allocator_nullptr) // NOLINT
+    {
+        const auto error{charls_jpegls_encoder_set_allocator(nullptr, nullptr)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+    }
+
+    TEST_METHOD(encode_batch_nullptr) // NOLINT
+    {
+        auto error{charls_jpegls_encode_batch(nullptr, 1, 0, nullptr)};
+        Assert::AreEqual(jpegls_errc::invalid_argument, error);
+
+        error = charls_jpegls_encode_batch(nullptr, 0, 0, nullptr);
+        Assert::AreEqual(jpegls_errc::success, error);
+    }
+
     TEST_METHOD(encode_to_zero_size_buffer) // NOLINT
     {
         auto* encoder{charls_jpegls_encoder_create()};
@@ -0,0 +1,294 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.h"
+
+#include "../src/color_transform.h"
+#include "../src/color_transform_simd.h"
+#include "../src/cpu_features.h"
+#include "../src/process_line.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using std::vector;
+
+namespace charls { namespace test {
+
+namespace {
+
+// The pixel count is not a multiple of the block size: the kernels only transform the complete blocks.
+constexpr size_t pixel_count{100};
+constexpr size_t stride{pixel_count + 2};
+constexpr uint32_t all_bits{0xFFFFFFFF};
+
+using select_kernel_function = color_transform_kernel (*)(color_transformation, bool, int32_t, size_t, sample_layout,
+                                                          sample_layout);
+
+vector<select_kernel_function> supported_kernel_selectors()
+{
+    vector<select_kernel_function> selectors;
+    if (cpu_supports_sse41())
+    {
+        selectors.push_back(&select_color_transform_kernel_sse41);
+    }
+    if (cpu_supports_avx2())
+    {
+        selectors.push_back(&select_color_transform_kernel_avx2);
+    }
+    return selectors;
+}
+
+
+template<typename SampleType>
+vector<SampleType> create_samples(const size_t count)
+{
+    std::mt19937 generator(42);
+    MSVC_WARNING_SUPPRESS_NEXT_LINE(26496) // cannot be marked as const as operator() is not always defined const.
+    std::uniform_int_distribution<uint32_t> distribution(0, (1U << (sizeof(SampleType) * 8)) - 1U);
+
+    vector<SampleType> samples(count);
+    for (auto& sample : samples)
+    {
+        sample = static_cast<SampleType>(distribution(generator));
+    }
+    return samples;
+}
+
+
+template<typename Transform, typename SampleType>
+void transform_to_planar(const triplet<SampleType>* source, SampleType* destination, Transform& transform,
+                         const uint32_t mask)
+{
+    transform_triplet_to_line(source, pixel_count, destination, stride, transform, mask);
+}
+
+template<typename Transform, typename SampleType>
+void transform_to_planar(const quad<SampleType>* source, SampleType* destination, Transform& transform,
+                         const uint32_t mask)
+{
+    transform_quad_to_line(source, pixel_count, destination, stride, transform, mask);
+}
+
+template<typename Transform, typename SampleType>
+void transform_from_planar(const SampleType* source, triplet<SampleType>* destination, Transform& transform)
+{
+    transform_line_to_triplet(source, stride, destination, pixel_count, transform);
+}
+
+template<typename Transform, typename SampleType>
+void transform_from_planar(const SampleType* source, quad<SampleType>* destination, Transform& transform)
+{
+    transform_line_to_quad(source, stride, destination, pixel_count, transform);
+}
+
+
+template<typename Transform, typename Pixel>
+void check_forward_kernels(const uint32_t mask, const bool swap_red_blue)
+{
+    using sample_type = typename Transform::size_type;
+    constexpr auto component_count{static_cast<int32_t>(sizeof(Pixel) / sizeof(sample_type))};
+    const auto samples{create_samples<sample_type>(pixel_count * component_count)};
+    const auto* source{reinterpret_cast<const Pixel*>(samples.data())};
+    Transform transform;
+
+    // The scalar reference implementation swaps the red and blue samples in a separate step.
+    auto reference_samples{samples};
+    if (swap_red_blue)
+    {
+        transform_rgb_to_bgr(reference_samples.data(), component_count, pixel_count);
+    }
+    const auto* reference_source{reinterpret_cast<const Pixel*>(reference_samples.data())};
+
+    for (const auto select_kernel : supported_kernel_selectors())
+    {
+        const auto interleaved_kernel{select_kernel(Transform::transformation, false, component_count, sizeof(sample_type),
+                                                    sample_layout::interleaved, sample_layout::interleaved)};
+        vector<Pixel> expected(pixel_count);
+        vector<Pixel> actual(pixel_count);
+        transform_line(expected.data(), reference_source, pixel_count, transform, mask);
+        const size_t transformed{interleaved_kernel(source, 0, actual.data(), 0, pixel_count, mask, swap_red_blue)};
+
+        Assert::IsTrue(transformed > 0 && transformed <= pixel_count);
+        Assert::AreEqual(0, memcmp(expected.data(), actual.data(), transformed * sizeof(Pixel)));
+
+        const auto planar_kernel{select_kernel(Transform::transformation, false, component_count, sizeof(sample_type),
+                                               sample_layout::interleaved, sample_layout::planar)};
+        vector<sample_type> expected_planar(component_count * stride);
+        vector<sample_type> actual_planar(component_count * stride);
+        transform_to_planar(reference_source, expected_planar.data(), transform, mask);
+        Assert::AreEqual(transformed,
+                         planar_kernel(source, 0, actual_planar.data(), stride, pixel_count, mask, swap_red_blue));
+        for (int32_t component{}; component != component_count; ++component)
+        {
+            Assert::AreEqual(0, memcmp(&expected_planar[component * stride], &actual_planar[component * stride],
+                                       transformed * sizeof(sample_type)));
+        }
+    }
+}
+
+
+template<typename Pixel>
+void swap_red_blue_samples(vector<Pixel>& pixels)
+{
+    transform_rgb_to_bgr(&pixels[0].v1, sizeof(Pixel) / sizeof(pixels[0].v1), pixels.size());
+}
+
+
+template<typename Transform, typename Pixel>
+void check_inverse_kernels(const bool swap_red_blue)
+{
+    using sample_type = typename Transform::size_type;
+    constexpr auto component_count{static_cast<int32_t>(sizeof(Pixel) / sizeof(sample_type))};
+    const auto samples{create_samples<sample_type>(component_count * stride)};
+    typename Transform::inverse transform(Transform{});
+
+    for (const auto select_kernel : supported_kernel_selectors())
+    {
+        const auto interleaved_kernel{select_kernel(Transform::transformation, true, component_count, sizeof(sample_type),
+                                                    sample_layout::interleaved, sample_layout::interleaved)};
+        const auto* source{reinterpret_cast<const Pixel*>(samples.data())};
+        vector<Pixel> expected(pixel_count);
+        vector<Pixel> actual(pixel_count);
+        transform_line(expected.data(), source, pixel_count, transform);
+        if (swap_red_blue)
+        {
+            swap_red_blue_samples(expected);
+        }
+        const size_t transformed{interleaved_kernel(source, 0, actual.data(), 0, pixel_count, all_bits, swap_red_blue)};
+
+        Assert::IsTrue(transformed > 0 && transformed <= pixel_count);
+        Assert::AreEqual(0, memcmp(expected.data(), actual.data(), transformed * sizeof(Pixel)));
+
+        const auto planar_kernel{select_kernel(Transform::transformation, true, component_count, sizeof(sample_type),
+                                               sample_layout::planar, sample_layout::interleaved)};
+        transform_from_planar(samples.data(), expected.data(), transform);
+        if (swap_red_blue)
+        {
+            swap_red_blue_samples(expected);
+        }
+        Assert::AreEqual(transformed,
+                         planar_kernel(samples.data(), stride, actual.data(), 0, pixel_count, all_bits, swap_red_blue));
+        Assert::AreEqual(0, memcmp(expected.data(), actual.data(), transformed * sizeof(Pixel)));
+    }
+}
+
+
+template<typename Transform>
+void check_kernels(const bool swap_red_blue = false)
+{
+    using sample_type = typename Transform::size_type;
+    constexpr uint32_t mask{(1U << (sizeof(sample_type) * 8 - 2)) - 1U};
+    check_forward_kernels<Transform, triplet<sample_type>>(all_bits, swap_red_blue);
+    check_forward_kernels<Transform, quad<sample_type>>(all_bits, swap_red_blue);
+    check_forward_kernels<Transform, triplet<sample_type>>(mask, swap_red_blue);
+    check_forward_kernels<Transform, quad<sample_type>>(mask, swap_red_blue);
+    check_inverse_kernels<Transform, triplet<sample_type>>(swap_red_blue);
+    check_inverse_kernels<Transform, quad<sample_type>>(swap_red_blue);
+}
+
+// The SSE4.1 and AVX2 kernels are compiled from the same templates: every instruction set must have its own
+// instantiations, a shared function would execute instructions of the other instruction set.
+void check_kernels_are_instruction_set_specific(const color_transformation transformation)
+{
+    for (const bool inverse : {false, true})
+    {
+        for (const int32_t component_count : {3, 4})
+        {
+            for (const size_t bytes_per_sample : {size_t{1}, size_t{2}})
+            {
+                for (const auto source_layout : {sample_layout::interleaved, sample_layout::planar})
+                {
+                    for (const auto destination_layout : {sample_layout::interleaved, sample_layout::planar})
+                    {
+                        const auto sse41_kernel{select_color_transform_kernel_sse41(
+                            transformation, inverse, component_count, bytes_per_sample, source_layout,
+                            destination_layout)};
+                        const auto avx2_kernel{select_color_transform_kernel_avx2(
+                            transformation, inverse, component_count, bytes_per_sample, source_layout,
+                            destination_layout)};
+                        if (sse41_kernel && avx2_kernel)
+                        {
+                            Assert::IsTrue(sse41_kernel != avx2_kernel);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+
+TEST_CLASS(color_transform_simd_test)
+{
+public:
+    TEST_METHOD(interleave_kernels_match_scalar_implementation) // NOLINT
+    {
+        check_kernels<transform_none<uint8_t>>();
+        check_kernels<transform_none<uint16_t>>();
+    }
+
+    TEST_METHOD(interleave_kernels_with_swapped_red_blue_match_scalar_implementation) // NOLINT
+    {
+        check_kernels<transform_none<uint8_t>>(true);
+        check_kernels<transform_none<uint16_t>>(true);
+    }
+
+    TEST_METHOD(kernels_with_swapped_red_blue_match_scalar_transform) // NOLINT
+    {
+        check_kernels<transform_hp1<uint8_t>>(true);
+        check_kernels<transform_hp2<uint16_t>>(true);
+        check_kernels<transform_hp3<uint8_t>>(true);
+    }
+
+    TEST_METHOD(hp1_kernels_match_scalar_transform) // NOLINT
+    {
+        check_kernels<transform_hp1<uint8_t>>();
+        check_kernels<transform_hp1<uint16_t>>();
+    }
+
+    TEST_METHOD(hp2_kernels_match_scalar_transform) // NOLINT
+    {
+        check_kernels<transform_hp2<uint8_t>>();
+        check_kernels<transform_hp2<uint16_t>>();
+    }
+
+    TEST_METHOD(hp3_kernels_match_scalar_transform) // NOLINT
+    {
+        check_kernels<transform_hp3<uint8_t>>();
+        check_kernels<transform_hp3<uint16_t>>();
+    }
+
+    TEST_METHOD(interleave_kernels_are_instruction_set_specific) // NOLINT
+    {
+        // Covers the copy and (de)interleave kernels of all layouts, including the interleaved to interleaved
+        // kernels that only swap the red and blue samples.
+        check_kernels_are_instruction_set_specific(color_transformation::none);
+    }
+
+    TEST_METHOD(transform_kernels_are_instruction_set_specific) // NOLINT
+    {
+        check_kernels_are_instruction_set_specific(color_transformation::hp1);
+        check_kernels_are_instruction_set_specific(color_transformation::hp2);
+        check_kernels_are_instruction_set_specific(color_transformation::hp3);
+    }
+
+    TEST_METHOD(no_kernel_for_unsupported_layout_or_component_count) // NOLINT
+    {
+        for (const auto select_kernel : supported_kernel_selectors())
+        {
+            Assert::IsTrue(select_kernel(color_transformation::hp1, false, 3, 1, sample_layout::planar,
+                                         sample_layout::interleaved) == nullptr);
+            Assert::IsTrue(select_kernel(color_transformation::hp1, true, 3, 1, sample_layout::interleaved,
+                                         sample_layout::planar) == nullptr);
+            Assert::IsTrue(select_kernel(color_transformation::hp1, false, 2, 1, sample_layout::interleaved,
+                                         sample_layout::interleaved) == nullptr);
+        }
+    }
+};
+
+}} // namespace charls::test
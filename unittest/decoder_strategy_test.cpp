@@ -6,8 +6,10 @@
 #include "../src/decoder_strategy.h"
 
 #include "encoder_strategy_tester.h"
+#include "util.h"
 
 #include <array>
+#include <tuple>
 
 using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
 using std::array;
@@ -40,7 +42,15 @@ class decoder_strategy_tester final : public charls::decoder_strategy
     }
 
     size_t decode_scan(unique_ptr<charls::process_line> /*process_line*/, const JlsRect& /*size*/,
-                       charls::const_byte_span /*encoded_source*/) noexcept(false) override
+                       charls::const_byte_span /*encoded_source*/,
+                       uint32_t /*first_interval_index*/, uint32_t /*end_line*/) noexcept(false) override
+    {
+        return {};
+    }
+
+    size_t decode_restart_interval(unique_ptr<charls::process_line> /*process_line*/, const JlsRect& /*size*/,
+                                   charls::const_byte_span /*encoded_source*/,
+                                   uint32_t /*interval_index*/) noexcept(false) override
     {
         return {};
     }
@@ -123,7 +133,7 @@ TEST_CLASS(decoder_strategy_test)
         Assert::IsFalse(decoder_strategy.read_bit());
     }
 
-    TEST_METHOD(peek_0_bits) // NOLINT
+    TEST_METHOD(read_high_bits) // NOLINT
     {
         constexpr frame_info frame_info{};
         constexpr coding_parameters parameters{};
@@ -132,23 +142,89 @@ TEST_CLASS(decoder_strategy_test)
             array<uint8_t, 4> buffer{0xF, 100, 23, 99};
 
             decoder_strategy_tester decoder_strategy(frame_info, parameters, buffer.data(), buffer.size());
-            Assert::AreEqual(4, decoder_strategy.peek_0_bits());
+            Assert::AreEqual(4, decoder_strategy.read_high_bits());
         }
 
         {
             array<uint8_t, 4> buffer{0, 1, 0, 0};
 
             decoder_strategy_tester decoder_strategy(frame_info, parameters, buffer.data(), buffer.size());
-            Assert::AreEqual(15, decoder_strategy.peek_0_bits());
+            Assert::AreEqual(15, decoder_strategy.read_high_bits());
         }
 
         {
             array<uint8_t, 4> buffer{0, 0, 0, 0};
 
             decoder_strategy_tester decoder_strategy(frame_info, parameters, buffer.data(), buffer.size());
-            Assert::AreEqual(-1, decoder_strategy.peek_0_bits());
+            assert_expect_exception(jpegls_errc::invalid_encoded_data,
+                                    [&decoder_strategy] { std::ignore = decoder_strategy.read_high_bits(); });
+        }
+    }
+
+    TEST_METHOD(read_high_bits_longer_than_cache) // NOLINT
+    {
+        constexpr frame_info frame_info{};
+        constexpr coding_parameters parameters{};
+
+        // 75 zero bits followed by a 1 bit and the bits 101.
+        array<uint8_t, 16> buffer{0, 0, 0, 0, 0, 0, 0, 0, 0, 0b00011010};
+
+        decoder_strategy_tester decoder_strategy(frame_info, parameters, buffer.data(), buffer.size());
+        Assert::AreEqual(75, decoder_strategy.read_high_bits());
+        Assert::AreEqual(0b101, decoder_strategy.read(3));
+    }
+
+    TEST_METHOD(read_high_bits_after_ff) // NOLINT
+    {
+        constexpr frame_info frame_info{};
+        constexpr coding_parameters parameters{};
+
+        // 0xFF followed by a 0 bit that is ignored, 7 + 8 + 7 zero bits before the 1 bit.
+        array<uint8_t, 12> buffer{0xFF, 0x00, 0x00, 0x01, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0};
+
+        decoder_strategy_tester decoder_strategy(frame_info, parameters, buffer.data(), buffer.size());
+        Assert::AreEqual(0xFF, decoder_strategy.read(8));
+        Assert::AreEqual(22, decoder_strategy.read_high_bits());
+        Assert::AreEqual(0x12, decoder_strategy.read(8));
+        Assert::AreEqual(0x34, decoder_strategy.read(8));
+    }
+
+    TEST_METHOD(read_bytes_with_many_ff_bytes) // NOLINT
+    {
+        constexpr frame_info frame_info{};
+        constexpr coding_parameters parameters{};
+
+        array<uint8_t, 256> enc_buf{};
+        encoder_strategy_tester encoder(frame_info, parameters);
+        encoder.initialize_forward({enc_buf.data(), enc_buf.size()});
+
+        // Every other byte is 0xFF: the decoder needs to remove the extra 0 bits after these bytes.
+        for (int32_t i{}; i != 100; ++i)
+        {
+            encoder.append_to_bit_stream_forward(0xFF, 8);
+            encoder.append_to_bit_stream_forward(static_cast<uint32_t>(i), 8);
+        }
+        encoder.end_scan_forward();
+
+        decoder_strategy_tester decoder(frame_info, parameters, enc_buf.data(), encoder.get_length_forward());
+        for (int32_t i{}; i != 100; ++i)
+        {
+            Assert::AreEqual(0xFF, decoder.read(8));
+            Assert::AreEqual(i, decoder.read(8));
         }
     }
+
+    TEST_METHOD(decode_image_with_entropy_data_ending_on_byte_boundary) // NOLINT
+    {
+        // The entropy coded data of this image ends exactly on a byte boundary: no padding bits are appended at the end.
+        const std::vector<uint8_t> source(48);
+
+        const auto encoded{jpegls_encoder::encode(source, {48, 1, 8, 1})};
+        std::vector<uint8_t> decoded;
+        jpegls_decoder::decode(encoded, decoded);
+
+        Assert::IsTrue(decoded == source);
+    }
 };
 
 }} // namespace charls::test
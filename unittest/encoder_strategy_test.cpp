@@ -4,6 +4,7 @@
 #include "pch.h"
 
 #include "encoder_strategy_tester.h"
+#include "util.h"
 
 #include <array>
 
@@ -40,7 +41,8 @@ TEST_CLASS(encoder_strategy_test)
         array<uint8_t, 1024> destination{};
         destination[13] = 0x77; // marker byte to detect overruns.
 
-        strategy.initialize_forward({destination.data(), destination.size()});
+        // Note: bytes after the written bytes (but inside the destination) may be overwritten by the bulk store.
+        strategy.initialize_forward({destination.data(), 13});
 
         // We want _isFFWritten == true.
         strategy.append_to_bit_stream_forward(0, 24);
@@ -50,10 +52,10 @@ TEST_CLASS(encoder_strategy_test)
         strategy.append_to_bit_stream_forward(0xffff, 16);
         strategy.append_to_bit_stream_forward(0xffff, 16);
 
-        // Buffer is full with FFs and _isFFWritten = true: Flush can only write 30 date bits.
+        // Buffer is full with FFs and _isFFWritten = true: every 0xFF byte is followed by an extra 0 bit.
         strategy.append_to_bit_stream_forward(0x3, 31);
 
-        strategy.flush_forward();
+        strategy.end_scan_forward();
 
         // Verify output.
         Assert::AreEqual(size_t{13}, strategy.get_length_forward());
@@ -72,6 +74,96 @@ TEST_CLASS(encoder_strategy_test)
         Assert::AreEqual(uint8_t{0xC0}, destination[12]);
         Assert::AreEqual(uint8_t{0x77}, destination[13]);
     }
+
+    TEST_METHOD(append_to_bit_stream_without_ff_bytes) // NOLINT
+    {
+        constexpr frame_info frame_info{};
+        constexpr coding_parameters parameters{};
+
+        encoder_strategy_tester strategy(frame_info, parameters);
+
+        array<uint8_t, 1024> destination{};
+        destination[100] = 0x77; // marker byte to detect overruns.
+
+        strategy.initialize_forward({destination.data(), 100});
+
+        // 100 bytes of 0x12, 0x34, 0x56, 0x78 written with varying bit counts: the bulk store is used.
+        for (int i{}; i != 25; ++i)
+        {
+            strategy.append_to_bit_stream_forward(0x1, 4);
+            strategy.append_to_bit_stream_forward(0x234, 12);
+            strategy.append_to_bit_stream_forward(0x5678, 16);
+        }
+        strategy.end_scan_forward();
+
+        Assert::AreEqual(size_t{100}, strategy.get_length_forward());
+        for (size_t i{}; i != 100; i += 4)
+        {
+            Assert::AreEqual(uint8_t{0x12}, destination[i]);
+            Assert::AreEqual(uint8_t{0x34}, destination[i + 1]);
+            Assert::AreEqual(uint8_t{0x56}, destination[i + 2]);
+            Assert::AreEqual(uint8_t{0x78}, destination[i + 3]);
+        }
+        Assert::AreEqual(uint8_t{0x77}, destination[100]);
+    }
+
+    TEST_METHOD(end_scan_fills_exact_size_destination) // NOLINT
+    {
+        constexpr frame_info frame_info{};
+        constexpr coding_parameters parameters{};
+
+        encoder_strategy_tester strategy(frame_info, parameters);
+
+        array<uint8_t, 5> destination{};
+        strategy.initialize_forward({destination.data(), destination.size()});
+
+        strategy.append_to_bit_stream_forward(0x1234567, 28);
+        strategy.append_to_bit_stream_forward(0x89, 8);
+        strategy.end_scan_forward();
+
+        Assert::AreEqual(size_t{5}, strategy.get_length_forward());
+        Assert::AreEqual(uint8_t{0x12}, destination[0]);
+        Assert::AreEqual(uint8_t{0x34}, destination[1]);
+        Assert::AreEqual(uint8_t{0x56}, destination[2]);
+        Assert::AreEqual(uint8_t{0x78}, destination[3]);
+        Assert::AreEqual(uint8_t{0x90}, destination[4]);
+    }
+
+    TEST_METHOD(end_scan_on_byte_boundary) // NOLINT
+    {
+        constexpr frame_info frame_info{};
+        constexpr coding_parameters parameters{};
+
+        encoder_strategy_tester strategy(frame_info, parameters);
+
+        array<uint8_t, 1024> destination{};
+        strategy.initialize_forward({destination.data(), destination.size()});
+
+        // After the flush the bit buffer is completely free and no padding bits are needed.
+        strategy.append_to_bit_stream_forward(0x12345, 24);
+        strategy.end_scan_forward();
+
+        Assert::AreEqual(size_t{3}, strategy.get_length_forward());
+        Assert::AreEqual(uint8_t{0x01}, destination[0]);
+        Assert::AreEqual(uint8_t{0x23}, destination[1]);
+        Assert::AreEqual(uint8_t{0x45}, destination[2]);
+    }
+
+    TEST_METHOD(end_scan_with_too_small_destination_throws) // NOLINT
+    {
+        constexpr frame_info frame_info{};
+        constexpr coding_parameters parameters{};
+
+        encoder_strategy_tester strategy(frame_info, parameters);
+
+        array<uint8_t, 4> destination{};
+        strategy.initialize_forward({destination.data(), destination.size()});
+
+        strategy.append_to_bit_stream_forward(0x1234567, 28);
+        strategy.append_to_bit_stream_forward(0x89, 8);
+
+        assert_expect_exception(jpegls_errc::destination_buffer_too_small, [&strategy] { strategy.end_scan_forward(); });
+    }
 };
 
 }} // namespace charls::test
@@ -24,6 +24,12 @@ class encoder_strategy_tester final : encoder_strategy
         return 0;
     }
 
+    size_t encode_restart_interval(std::unique_ptr<process_line>, byte_span, uint32_t /*interval_index*/) noexcept(
+        false) override
+    {
+        return 0;
+    }
+
     std::unique_ptr<process_line> create_process_line(byte_span, size_t /*stride*/) noexcept(false) override
     {
         return nullptr;
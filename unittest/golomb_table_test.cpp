@@ -23,12 +23,29 @@ TEST_CLASS(golomb_table_test)
         const golomb_code_table golomb_table;
 #endif
 
-        for (uint32_t i{}; i != 256U; ++i)
+        for (uint32_t i{}; i != 1U << golomb_code_table::bit_count; ++i)
         {
             Assert::AreEqual(0U, golomb_table.get(i).length());
             Assert::AreEqual(0, golomb_table.get(i).value());
         }
     }
+
+    TEST_METHOD(golomb_table_add_entry_fills_all_bit_patterns) // NOLINT
+    {
+        golomb_code_table golomb_table;
+
+        // A code of 10 bits (0b0000000101) is found for all values that start with these bits.
+        constexpr uint32_t length{10};
+        constexpr uint32_t shift{golomb_code_table::bit_count - length};
+        golomb_table.add_entry(0b101, golomb_code(-3, length));
+
+        for (uint32_t i{}; i != 1U << golomb_code_table::bit_count; ++i)
+        {
+            const bool match{i >> shift == 0b101};
+            Assert::AreEqual(match ? length : 0U, golomb_table.get(i).length());
+            Assert::AreEqual(match ? -3 : 0, golomb_table.get(i).value());
+        }
+    }
 };
 
 }} // namespace charls::test
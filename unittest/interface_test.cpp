@@ -8,6 +8,7 @@
 #include <charls/charls.h>
 
 #include <array>
+#include <utility>
 #include <vector>
 
 using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
@@ -216,6 +217,76 @@ TEST_CLASS(interface_test)
         Assert::IsTrue(strlen(error_message.data()) > 0);
     }
 
+    TEST_METHOD(JpegLsDecodeRect_with_restart_marker_index) // NOLINT
+    {
+        const vector<uint8_t> encoded_source{encode_test8_with_restart_marker_index(interleave_mode::none)};
+
+        decode_rect_and_compare(encoded_source, {0, 200, 256, 56});
+        decode_rect_and_compare(encoded_source, {16, 7, 100, 1});
+        decode_rect_and_compare(encoded_source, {16, 255, 100, 1});
+        decode_rect_and_compare(encoded_source, {0, 0, 256, 256});
+    }
+
+    TEST_METHOD(JpegLsDecodeRect_interleaved_with_restart_marker_index) // NOLINT
+    {
+        const vector<uint8_t> encoded_source{encode_test8_with_restart_marker_index(interleave_mode::sample)};
+
+        decode_rect_and_compare(encoded_source, {32, 128, 64, 100});
+    }
+
+    TEST_METHOD(JpegLsDecodeRect_with_restart_markers_without_index) // NOLINT
+    {
+        // The decoder should build the index by scanning the encoded data.
+        decode_rect_and_compare(read_file("DataFiles/test8_ilv_none_rm_7.jls"), {0, 100, 256, 20});
+        decode_rect_and_compare(read_file("DataFiles/test8_ilv_sample_rm_7.jls"), {10, 250, 40, 6});
+    }
+
+    TEST_METHOD(JpegLsDecodeRect_with_invalid_restart_marker_index) // NOLINT
+    {
+        vector<uint8_t> encoded_source{encode_test8_with_restart_marker_index(interleave_mode::none)};
+
+        // Let all offsets of the first index point to the first byte of the scan: the decoder should ignore them.
+        const auto index_segment{find_marker(encoded_source, 0xE9)};
+        const size_t offset_count{(((encoded_source[index_segment + 2] << 8) | encoded_source[index_segment + 3]) - 6U) / 4};
+        std::fill_n(encoded_source.begin() + static_cast<ptrdiff_t>(index_segment) + 8, offset_count * 4, uint8_t{});
+
+        decode_rect_and_compare(encoded_source, {0, 200, 256, 56});
+    }
+
+    TEST_METHOD(JpegLsDecodeRect_with_restart_marker_index_skips_lines_above_rect) // NOLINT
+    {
+        vector<uint8_t> encoded_source{encode_test8_with_restart_marker_index(interleave_mode::sample)};
+        vector<uint8_t> expected(static_cast<size_t>(256) * 64 * 3);
+        JlsParameters params{};
+        params.stride = 256 * 3;
+        auto error{JpegLsDecodeRect(expected.data(), expected.size(), encoded_source.data(), encoded_source.size(),
+                                    {0, 192, 256, 64}, &params, nullptr)};
+        Assert::AreEqual(jpegls_errc::success, error);
+
+        // Corrupt the first restart interval: the decoder should not need it to decode the lower part of the image.
+        const size_t scan_data{find_marker(encoded_source, 0xDA) + 2 + 12};
+        encoded_source[scan_data] = 0xFF;
+        encoded_source[scan_data + 1] = 0xD9;
+
+        vector<uint8_t> destination(expected.size());
+        error = JpegLsDecodeRect(destination.data(), destination.size(), encoded_source.data(), encoded_source.size(),
+                                 {0, 192, 256, 64}, &params, nullptr);
+        Assert::AreEqual(jpegls_errc::success, error);
+        Assert::IsTrue(expected == destination);
+    }
+
+    TEST_METHOD(JpegLsDecode_output_bgr_line_interleaved) // NOLINT
+    {
+        decode_bgr_and_compare(read_file("DataFiles/t8c1e0.jls"));
+        decode_bgr_and_compare(read_file("DataFiles/t8c1e3.jls"));
+    }
+
+    TEST_METHOD(JpegLsDecode_output_bgr_sample_interleaved) // NOLINT
+    {
+        decode_bgr_and_compare(read_file("DataFiles/t8c2e0.jls"));
+        decode_bgr_and_compare(encode_test8_with_restart_marker_index(interleave_mode::sample));
+    }
+
     TEST_METHOD(noise_image_with_custom_reset) // NOLINT
     {
         JlsParameters params{};
@@ -231,6 +302,94 @@ TEST_CLASS(interface_test)
 
         test_round_trip_legacy(noise_image, params);
     }
+
+private:
+    static vector<uint8_t> encode_test8_with_restart_marker_index(const interleave_mode interleave_mode)
+    {
+        const charls_test::portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", interleave_mode)};
+
+        jpegls_encoder encoder;
+        encoder
+            .frame_info({static_cast<uint32_t>(reference_file.width()), static_cast<uint32_t>(reference_file.height()),
+                         reference_file.bits_per_sample(), reference_file.component_count()})
+            .interleave_mode(interleave_mode)
+            .restart_interval(16)
+            .encoding_options(encoding_options::include_restart_marker_index);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(reference_file.image_data()));
+
+        return destination;
+    }
+
+    static void decode_rect_and_compare(const vector<uint8_t>& encoded_source, const JlsRect rect)
+    {
+        JlsParameters params{};
+        auto error{JpegLsReadHeader(encoded_source.data(), encoded_source.size(), &params, nullptr)};
+        Assert::AreEqual(jpegls_errc::success, error);
+
+        const size_t width{static_cast<size_t>(params.width)};
+        const size_t height{static_cast<size_t>(params.height)};
+        const size_t plane_count{params.interleaveMode == interleave_mode::none ? static_cast<size_t>(params.components) : 1};
+        const size_t pixel_size{params.interleaveMode == interleave_mode::none ? 1 : static_cast<size_t>(params.components)};
+        vector<uint8_t> decoded_destination(width * height * plane_count * pixel_size);
+        error = JpegLsDecode(decoded_destination.data(), decoded_destination.size(), encoded_source.data(),
+                             encoded_source.size(), &params, nullptr);
+        Assert::AreEqual(jpegls_errc::success, error);
+
+        const size_t rect_stride{static_cast<size_t>(rect.Width) * pixel_size};
+        vector<uint8_t> decoded_rect(rect_stride * rect.Height * plane_count);
+        params.stride = static_cast<int32_t>(rect_stride);
+        error = JpegLsDecodeRect(decoded_rect.data(), decoded_rect.size(), encoded_source.data(), encoded_source.size(), rect,
+                                 &params, nullptr);
+        Assert::AreEqual(jpegls_errc::success, error);
+
+        for (size_t plane{}; plane != plane_count; ++plane)
+        {
+            for (size_t line{}; line != static_cast<size_t>(rect.Height); ++line)
+            {
+                const uint8_t* expected{&decoded_destination[(plane * height + rect.Y + line) * width * pixel_size +
+                                                             rect.X * pixel_size]};
+                Assert::IsTrue(memcmp(expected, &decoded_rect[(plane * rect.Height + line) * rect_stride], rect_stride) == 0);
+            }
+        }
+    }
+
+    static void decode_bgr_and_compare(const vector<uint8_t>& encoded_source)
+    {
+        JlsParameters params{};
+        auto error{JpegLsReadHeader(encoded_source.data(), encoded_source.size(), &params, nullptr)};
+        Assert::AreEqual(jpegls_errc::success, error);
+
+        vector<uint8_t> expected(static_cast<size_t>(params.width) * params.height * params.components);
+        error = JpegLsDecode(expected.data(), expected.size(), encoded_source.data(), encoded_source.size(), &params,
+                             nullptr);
+        Assert::AreEqual(jpegls_errc::success, error);
+        for (size_t i{}; i < expected.size(); i += static_cast<size_t>(params.components))
+        {
+            std::swap(expected[i], expected[i + 2]);
+        }
+
+        vector<uint8_t> destination(expected.size());
+        params.outputBgr = static_cast<char>(true);
+        error = JpegLsDecode(destination.data(), destination.size(), encoded_source.data(), encoded_source.size(),
+                             &params, nullptr);
+        Assert::AreEqual(jpegls_errc::success, error);
+        Assert::IsTrue(expected == destination);
+    }
+
+    static size_t find_marker(const vector<uint8_t>& source, const uint8_t marker_code)
+    {
+        for (size_t i{}; i + 1 < source.size(); ++i)
+        {
+            if (source[i] == 0xFF && source[i + 1] == marker_code)
+                return i;
+        }
+
+        Assert::Fail(); // The marker should be present.
+        return source.size();
+    }
 };
 
 }} // namespace charls::test
@@ -471,6 +471,50 @@ TEST_CLASS(jpeg_stream_writer_test)
         Assert::AreEqual(uint8_t{}, buffer[9]);  // transformation.
     }
 
+    TEST_METHOD(write_define_restart_interval_segment) // NOLINT
+    {
+        array<uint8_t, 6> buffer{};
+        jpeg_stream_writer writer({buffer.data(), buffer.size()});
+
+        writer.write_define_restart_interval_segment(0x1234);
+
+        Assert::AreEqual(buffer.size(), writer.bytes_written());
+        Assert::AreEqual(uint8_t{0xFF}, buffer[0]);
+        Assert::AreEqual(uint8_t{0xDD}, buffer[1]); // DRI
+        Assert::AreEqual(uint8_t{}, buffer[2]);     // length (high byte)
+        Assert::AreEqual(uint8_t{4}, buffer[3]);    // length (low byte)
+        Assert::AreEqual(uint8_t{0x12}, buffer[4]); // restart interval (high byte)
+        Assert::AreEqual(uint8_t{0x34}, buffer[5]); // restart interval (low byte)
+    }
+
+    TEST_METHOD(write_define_restart_interval_segment_larger_than_16_bit) // NOLINT
+    {
+        array<uint8_t, 8> buffer{};
+        jpeg_stream_writer writer({buffer.data(), buffer.size()});
+
+        writer.write_define_restart_interval_segment(0x12345);
+
+        Assert::AreEqual(buffer.size(), writer.bytes_written());
+        Assert::AreEqual(uint8_t{0xDD}, buffer[1]); // DRI
+        Assert::AreEqual(uint8_t{6}, buffer[3]);    // length (low byte)
+        Assert::AreEqual(uint8_t{}, buffer[4]);
+        Assert::AreEqual(uint8_t{0x01}, buffer[5]);
+        Assert::AreEqual(uint8_t{0x23}, buffer[6]);
+        Assert::AreEqual(uint8_t{0x45}, buffer[7]);
+    }
+
+    TEST_METHOD(write_restart_marker) // NOLINT
+    {
+        array<uint8_t, 2> buffer{};
+        jpeg_stream_writer writer({buffer.data(), buffer.size()});
+
+        writer.write_restart_marker(7);
+
+        Assert::AreEqual(buffer.size(), writer.bytes_written());
+        Assert::AreEqual(uint8_t{0xFF}, buffer[0]);
+        Assert::AreEqual(uint8_t{0xD7}, buffer[1]); // RST7
+    }
+
     TEST_METHOD(rewind) // NOLINT
     {
         array<uint8_t, 10> buffer{};
@@ -8,6 +8,7 @@
 #include <charls/charls.h>
 
 #include <array>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -70,6 +71,37 @@ TEST_CLASS(jpegls_decoder_test)
         assert_expect_exception(jpegls_errc::invalid_operation, [&decoder, &source] { decoder.source(source); });
     }
 
+    TEST_METHOD(reset_allows_to_set_new_source) // NOLINT
+    {
+        jpegls_decoder decoder;
+
+        const vector<uint8_t> source(2000);
+        decoder.source(source);
+        decoder.reset();
+        decoder.source(source);
+        assert_expect_exception(jpegls_errc::invalid_operation, [&decoder, &source] { decoder.source(source); });
+    }
+
+    TEST_METHOD(decode_sequence_of_images_with_reset) // NOLINT
+    {
+        // The same image is decoded twice to reuse the internal buffers, the other images have a different shape.
+        jpegls_decoder decoder;
+        for (const char* filename : {"DataFiles/t8c0e0.jls", "DataFiles/t8c0e0.jls", "DataFiles/t8c1e0.jls",
+                                     "DataFiles/t8c2e0.jls", "DataFiles/t8c1e0.jls"})
+        {
+            const vector<uint8_t> source{read_file(filename)};
+            decoder.reset();
+            decoder.source(source).read_header();
+
+            vector<uint8_t> destination(decoder.destination_size());
+            decoder.decode(destination);
+
+            portable_anymap_file reference_file{
+                read_anymap_reference_file("DataFiles/test8.ppm", decoder.interleave_mode(), decoder.frame_info())};
+            Assert::IsTrue(reference_file.image_data() == destination);
+        }
+    }
+
     TEST_METHOD(read_spiff_header_without_source_throws) // NOLINT
     {
         jpegls_decoder decoder;
@@ -1012,6 +1044,505 @@ TEST_CLASS(jpegls_decoder_test)
         decoder.decode(data, size);
     }
 
+    TEST_METHOD(decode_interleave_none_with_multiple_threads) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/t8c0e0.jls")};
+        jpegls_decoder decoder{source, true};
+        decoder.thread_count(3);
+
+        vector<uint8_t> destination(decoder.destination_size());
+        decoder.decode(destination);
+
+        portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", decoder.interleave_mode(), decoder.frame_info())};
+
+        const auto& reference_image_data{reference_file.image_data()};
+        for (size_t i{}; i != destination.size(); ++i)
+        {
+            Assert::AreEqual(reference_image_data[i], destination[i]);
+        }
+    }
+
+    TEST_METHOD(decode_with_default_pc_parameters_before_each_sos_with_multiple_threads) // NOLINT
+    {
+        vector<uint8_t> source{read_file("DataFiles/t8c0e0.jls")};
+        insert_pc_parameters_segments(source, 3);
+
+        jpegls_decoder decoder{source, true};
+        decoder.thread_count(0);
+
+        vector<uint8_t> destination(decoder.destination_size());
+        decoder.decode(destination);
+
+        portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", decoder.interleave_mode(), decoder.frame_info())};
+
+        const auto& reference_image_data{reference_file.image_data()};
+        for (size_t i{}; i != destination.size(); ++i)
+        {
+            Assert::AreEqual(reference_image_data[i], destination[i]);
+        }
+    }
+
+    TEST_METHOD(decode_with_restart_markers_and_multiple_threads) // NOLINT
+    {
+        vector<uint8_t> source{read_file("DataFiles/test8_ilv_none_rm_7.jls")};
+
+        // Add additional 0xFF marker begin bytes, these should not be seen as the end of the scan.
+        auto it{find_scan_header(source.begin(), source.end())};
+        it = find_first_restart_marker(it + 1, source.end());
+        const array<uint8_t, 3> extra_begin_bytes{0xFF, 0xFF, 0xFF};
+        source.insert(it, extra_begin_bytes.cbegin(), extra_begin_bytes.cend());
+
+        jpegls_decoder decoder{source, true};
+        decoder.thread_count(3);
+
+        vector<uint8_t> destination(decoder.destination_size());
+        decoder.decode(destination);
+
+        portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", decoder.interleave_mode(), decoder.frame_info())};
+
+        const auto& reference_image_data{reference_file.image_data()};
+        for (size_t i{}; i != destination.size(); ++i)
+        {
+            Assert::AreEqual(reference_image_data[i], destination[i]);
+        }
+    }
+
+    TEST_METHOD(decode_interleave_sample_with_restart_markers_and_multiple_threads) // NOLINT
+    {
+        decode_with_multiple_threads_and_compare("DataFiles/test8_ilv_sample_rm_7.jls");
+        decode_with_multiple_threads_and_compare("DataFiles/test8_ilv_sample_rm_300.jls");
+    }
+
+    TEST_METHOD(decode_interleave_line_with_restart_markers_and_multiple_threads) // NOLINT
+    {
+        decode_with_multiple_threads_and_compare("DataFiles/test8_ilv_line_rm_7.jls");
+    }
+
+    TEST_METHOD(decode_16_bit_with_restart_markers_and_multiple_threads) // NOLINT
+    {
+        decode_with_multiple_threads_and_compare("DataFiles/test16_rm_5.jls");
+    }
+
+    TEST_METHOD(decode_interleaved_scan_with_multiple_threads) // NOLINT
+    {
+        decode_with_multiple_threads_and_compare("DataFiles/t8c1e0.jls");
+        decode_with_multiple_threads_and_compare("DataFiles/t8c2e0.jls");
+        decode_with_multiple_threads_and_compare("DataFiles/t8c1e3.jls");
+    }
+
+    TEST_METHOD(decode_interleaved_scan_with_executor_that_rejects_tasks) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/t8c2e0.jls")};
+        const auto expected{jpegls_decoder{source, true}.decode<vector<uint8_t>>()};
+
+        deferred_executor rejecting_executor;
+        rejecting_executor.reject = true;
+        const charls_executor c_executor{rejecting_executor.c_executor()};
+        const auto decoder{charls_jpegls_decoder_create()};
+        Assert::AreEqual(jpegls_errc::success, charls_jpegls_decoder_set_source_buffer(decoder, source.data(), source.size()));
+        Assert::AreEqual(jpegls_errc::success, charls_jpegls_decoder_read_header(decoder));
+        Assert::AreEqual(jpegls_errc::success, charls_jpegls_decoder_set_thread_count(decoder, 2));
+        Assert::AreEqual(jpegls_errc::success, charls_jpegls_decoder_set_executor(decoder, &c_executor));
+
+        vector<uint8_t> destination(expected.size());
+        const auto error{charls_jpegls_decoder_decode_to_buffer(decoder, destination.data(), destination.size(), 0)};
+        charls_jpegls_decoder_destroy(decoder);
+
+        Assert::AreEqual(jpegls_errc::success, error);
+        Assert::IsTrue(expected == destination);
+    }
+
+    TEST_METHOD(decode_file_with_missing_restart_marker_with_multiple_threads_throws) // NOLINT
+    {
+        vector<uint8_t> source{read_file("DataFiles/t8c0e0.jls")};
+
+        // Insert a DRI marker segment to trigger that restart markers are used.
+        jpeg_test_stream_writer stream_writer;
+        stream_writer.write_define_restart_interval(10, 3);
+        const auto it{source.begin() + 2};
+        source.insert(it, stream_writer.buffer.cbegin(), stream_writer.buffer.cend());
+
+        jpegls_decoder decoder{source, true};
+        decoder.thread_count(2);
+        vector<uint8_t> destination(decoder.destination_size());
+
+        assert_expect_exception(jpegls_errc::restart_marker_not_found,
+                                [&decoder, &destination] { decoder.decode(destination); });
+    }
+
+    TEST_METHOD(decode_file_with_incorrect_restart_marker_with_multiple_threads_throws) // NOLINT
+    {
+        vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+
+        // Change the first restart marker to the second.
+        auto it{find_scan_header(source.begin(), source.end())};
+        it = find_first_restart_marker(it + 1, source.end());
+        ++it;
+        *it = 0xD1;
+
+        jpegls_decoder decoder{source, true};
+        decoder.thread_count(2);
+        vector<uint8_t> destination(decoder.destination_size());
+
+        assert_expect_exception(jpegls_errc::restart_marker_not_found,
+                                [&decoder, &destination] { decoder.decode(destination); });
+    }
+
+    TEST_METHOD(decode_file_that_ends_after_restart_marker_with_multiple_threads_throws) // NOLINT
+    {
+        vector<uint8_t> source{read_file("DataFiles/test8_ilv_none_rm_7.jls")};
+
+        auto it{find_scan_header(source.begin(), source.end())};
+        it = find_first_restart_marker(it + 1, source.end());
+        const vector<uint8_t> too_small_source(source.begin(), it);
+
+        jpegls_decoder decoder{too_small_source, true};
+        decoder.thread_count(3);
+        vector<uint8_t> destination(decoder.destination_size());
+
+        assert_expect_exception(jpegls_errc::source_buffer_too_small,
+                                [&decoder, &destination] { decoder.decode(destination); });
+    }
+
+    TEST_METHOD(decode_batch) // NOLINT
+    {
+        const array<const char*, 5> filenames{"DataFiles/t8c0e0.jls", "DataFiles/t8c1e0.jls", "DataFiles/t8c2e3.jls",
+                                              "DataFiles/t16e3.jls", "DataFiles/test8_ilv_none_rm_7.jls"};
+        vector<vector<uint8_t>> sources;
+        vector<vector<uint8_t>> expected_destinations;
+        for (const auto* filename : filenames)
+        {
+            sources.push_back(read_file(filename));
+            expected_destinations.push_back(jpegls_decoder{sources.back(), true}.decode<vector<uint8_t>>());
+        }
+
+        vector<vector<uint8_t>> destinations(sources.size());
+        vector<decode_batch_item> items(sources.size());
+        for (size_t i{}; i != items.size(); ++i)
+        {
+            destinations[i].resize(expected_destinations[i].size());
+            items[i] = {sources[i].data(), sources[i].size(), destinations[i].data(), destinations[i].size(), 0,
+                        jpegls_errc::invalid_operation};
+        }
+
+        jpegls_decoder::decode_batch(items, 3);
+
+        for (size_t i{}; i != items.size(); ++i)
+        {
+            Assert::AreEqual(jpegls_errc::success, items[i].result);
+            Assert::IsTrue(expected_destinations[i] == destinations[i]);
+        }
+    }
+
+    TEST_METHOD(decode_batch_reports_result_per_item) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/t8c0e0.jls")};
+        const auto expected{jpegls_decoder{source, true}.decode<vector<uint8_t>>()};
+        const array<uint8_t, 4> invalid_source{0xFF, 0xD8, 0xFF, 0xFF};
+
+        vector<uint8_t> destination1(expected.size());
+        vector<uint8_t> destination2(expected.size());
+        vector<uint8_t> destination3(expected.size() - 1);
+        array<decode_batch_item, 3> items{
+            {{source.data(), source.size(), destination1.data(), destination1.size(), 0, jpegls_errc::success},
+             {invalid_source.data(), invalid_source.size(), destination2.data(), destination2.size(), 0,
+              jpegls_errc::success},
+             {source.data(), source.size(), destination3.data(), destination3.size(), 0, jpegls_errc::success}}};
+
+        jpegls_decoder::decode_batch(items);
+
+        Assert::AreEqual(jpegls_errc::success, items[0].result);
+        Assert::IsTrue(expected == destination1);
+        Assert::AreNotEqual(jpegls_errc::success, items[1].result);
+        Assert::AreEqual(jpegls_errc::destination_buffer_too_small, items[2].result);
+    }
+
+    TEST_METHOD(decode_batch_with_executor) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/t8c0e0.jls")};
+        const auto expected{jpegls_decoder{source, true}.decode<vector<uint8_t>>()};
+
+        vector<vector<uint8_t>> destinations(4, vector<uint8_t>(expected.size()));
+        vector<decode_batch_item> items;
+        for (auto& destination : destinations)
+        {
+            items.push_back(
+                {source.data(), source.size(), destination.data(), destination.size(), 0, jpegls_errc::invalid_operation});
+        }
+
+        thread_per_task_executor executor;
+        jpegls_decoder::decode_batch(items, 3, executor);
+
+        Assert::AreEqual(2, executor.submit_count.load());
+        for (size_t i{}; i != items.size(); ++i)
+        {
+            Assert::AreEqual(jpegls_errc::success, items[i].result);
+            Assert::IsTrue(expected == destinations[i]);
+        }
+    }
+
+    TEST_METHOD(decode_with_restart_markers_and_executor) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+        const auto expected{jpegls_decoder{source, true}.decode<vector<uint8_t>>()};
+
+        thread_per_task_executor executor;
+        jpegls_decoder decoder{source, true};
+        decoder.thread_count(4).executor(executor);
+        const auto destination{decoder.decode<vector<uint8_t>>()};
+
+        Assert::AreEqual(3, executor.submit_count.load());
+        Assert::IsTrue(expected == destination);
+    }
+
+    TEST_METHOD(decode_with_single_restart_interval_and_executor) // NOLINT
+    {
+        // The restart interval (300 lines) is larger than the image: the scan is decoded on the calling thread and only
+        // the conversion of the decoded lines runs on an additional thread.
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_300.jls")};
+        const auto expected{jpegls_decoder{source, true}.decode<vector<uint8_t>>()};
+
+        thread_per_task_executor executor;
+        jpegls_decoder decoder{source, true};
+        decoder.thread_count(4).executor(executor);
+        const auto destination{decoder.decode<vector<uint8_t>>()};
+
+        Assert::AreEqual(1, executor.submit_count.load());
+        Assert::IsTrue(expected == destination);
+    }
+
+    TEST_METHOD(decode_restart_intervals_on_multiple_threads) // NOLINT
+    {
+        decode_restart_intervals_on_multiple_threads("DataFiles/test8_ilv_none_rm_7.jls");
+        decode_restart_intervals_on_multiple_threads("DataFiles/test8_ilv_line_rm_7.jls");
+        decode_restart_intervals_on_multiple_threads("DataFiles/test8_ilv_sample_rm_7.jls");
+    }
+
+    TEST_METHOD(decode_restart_intervals_without_restart_markers) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/t8c0e0.jls")};
+        const auto expected{jpegls_decoder{source, true}.decode<vector<uint8_t>>()};
+
+        jpegls_decoder decoder{source, true};
+        Assert::AreEqual(size_t{3}, decoder.read_restart_intervals());
+
+        vector<uint8_t> destination(expected.size());
+        const size_t bytes_per_plane{expected.size() / 3};
+        for (size_t i{}; i != 3; ++i)
+        {
+            const auto info{decoder.restart_interval_info(i)};
+            Assert::AreEqual(static_cast<uint32_t>(i), info.scan_index);
+            Assert::AreEqual(0U, info.first_line);
+            Assert::AreEqual(decoder.frame_info().height, info.line_count);
+            Assert::AreEqual(1, info.component_count);
+
+            decoder.decode_restart_interval(i, destination.data() + i * bytes_per_plane, bytes_per_plane);
+        }
+
+        Assert::IsTrue(expected == destination);
+    }
+
+    TEST_METHOD(restart_interval_info_describes_entropy_coded_data) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+
+        jpegls_decoder decoder{source, true};
+        const size_t count{decoder.read_restart_intervals()};
+
+        Assert::AreEqual(size_t{(decoder.frame_info().height + 6) / 7}, count);
+        for (size_t i{}; i != count; ++i)
+        {
+            const auto info{decoder.restart_interval_info(i)};
+            Assert::AreEqual(0U, info.scan_index);
+            Assert::AreEqual(static_cast<uint32_t>(i * 7), info.first_line);
+            Assert::AreEqual(std::min(7U, decoder.frame_info().height - info.first_line), info.line_count);
+            Assert::AreEqual(3, info.component_count);
+
+            // Every interval is followed by the next restart marker or by the end of image marker.
+            const size_t end{info.source_offset + info.source_size_bytes};
+            Assert::AreEqual(uint8_t{0xFF}, source[end]);
+            Assert::AreEqual(i + 1 == count ? uint8_t{0xD9} : static_cast<uint8_t>(0xD0 + i % 8), source[end + 1]);
+        }
+    }
+
+    TEST_METHOD(decode_restart_interval_before_read_restart_intervals_throws) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+        const jpegls_decoder decoder{source, true};
+        vector<uint8_t> destination(decoder.destination_size());
+
+        assert_expect_exception(jpegls_errc::invalid_operation,
+                                [&decoder, &destination] { decoder.decode_restart_interval(0, destination); });
+        assert_expect_exception(jpegls_errc::invalid_operation,
+                                [&decoder] { std::ignore = decoder.restart_interval_info(0); });
+    }
+
+    TEST_METHOD(decode_restart_interval_with_invalid_index_throws) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+        jpegls_decoder decoder{source, true};
+        const size_t count{decoder.read_restart_intervals()};
+        vector<uint8_t> destination(decoder.destination_size());
+
+        assert_expect_exception(jpegls_errc::invalid_argument,
+                                [&decoder, &destination, count] { decoder.decode_restart_interval(count, destination); });
+        assert_expect_exception(jpegls_errc::invalid_argument,
+                                [&decoder, count] { std::ignore = decoder.restart_interval_info(count); });
+    }
+
+    TEST_METHOD(decode_restart_interval_with_too_small_destination_throws) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+        jpegls_decoder decoder{source, true};
+        std::ignore = decoder.read_restart_intervals();
+        const auto info{decoder.restart_interval_info(0)};
+        vector<uint8_t> destination(static_cast<size_t>(info.line_count) * decoder.frame_info().width * 3 - 1);
+
+        assert_expect_exception(jpegls_errc::destination_buffer_too_small,
+                                [&decoder, &destination] { decoder.decode_restart_interval(0, destination); });
+    }
+
+    TEST_METHOD(decode_after_read_restart_intervals_throws) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+        jpegls_decoder decoder{source, true};
+        vector<uint8_t> destination(decoder.destination_size());
+        std::ignore = decoder.read_restart_intervals();
+
+        assert_expect_exception(jpegls_errc::invalid_operation, [&decoder, &destination] { decoder.decode(destination); });
+    }
+
+    TEST_METHOD(decode_region) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+
+        decode_region_and_compare(source, {0, 0, 256, 1});
+        decode_region_and_compare(source, {10, 20, 100, 30});
+        decode_region_and_compare(source, {200, 250, 56, 6});
+        decode_region_and_compare(source, {0, 0, 256, 256});
+    }
+
+    TEST_METHOD(decode_region_of_image_with_multiple_scans) // NOLINT
+    {
+        decode_region_and_compare(read_file("DataFiles/test8_ilv_none_rm_7.jls"), {5, 60, 20, 30});
+        decode_region_and_compare(read_file("DataFiles/t8c0e0.jls"), {100, 0, 10, 10});
+        decode_region_and_compare(read_file("DataFiles/test16_rm_5.jls"), {0, 10, 10, 10});
+    }
+
+    TEST_METHOD(decode_region_of_image_with_multiple_scans_and_restart_marker_index) // NOLINT
+    {
+        const charls_test::portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", interleave_mode::none)};
+        jpegls_encoder encoder;
+        encoder
+            .frame_info({static_cast<uint32_t>(reference_file.width()), static_cast<uint32_t>(reference_file.height()),
+                         reference_file.bits_per_sample(), reference_file.component_count()})
+            .restart_interval(8)
+            .encoding_options(encoding_options::include_restart_marker_index);
+        vector<uint8_t> source(encoder.estimated_destination_size());
+        encoder.destination(source);
+        source.resize(encoder.encode(reference_file.image_data()));
+
+        decode_region_and_compare(source, {0, 30, 256, 40});
+        decode_region_and_compare(source, {128, 255, 1, 1});
+    }
+
+    TEST_METHOD(decode_region_with_multiple_threads) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_none_rm_7.jls")};
+        const charls::region region{20, 100, 30, 50};
+        const auto expected{jpegls_decoder{source, true}.decode_region<vector<uint8_t>>(region)};
+
+        jpegls_decoder decoder{source, true};
+        decoder.thread_count(4);
+        const auto destination{decoder.decode_region<vector<uint8_t>>(region)};
+
+        Assert::IsTrue(expected == destination);
+    }
+
+    TEST_METHOD(decode_region_stops_after_last_line) // NOLINT
+    {
+        vector<uint8_t> source{read_file("DataFiles/t8c1e0.jls")};
+
+        // Remove the end of the encoded data: the region above it should still be decodable.
+        source.resize(source.size() / 2);
+        const jpegls_decoder decoder{source, true};
+        const auto destination{decoder.decode_region<vector<uint8_t>>({0, 0, decoder.frame_info().width, 10})};
+
+        Assert::AreEqual(static_cast<size_t>(decoder.frame_info().width) * 10 * 3, destination.size());
+        assert_expect_exception(jpegls_errc::invalid_encoded_data,
+                                [&source] { std::ignore = jpegls_decoder{source, true}.decode<vector<uint8_t>>(); });
+    }
+
+    TEST_METHOD(decode_region_with_stride) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_none_rm_7.jls")};
+        const auto expected{jpegls_decoder{source, true}.decode_region<vector<uint8_t>>({1, 2, 3, 4})};
+
+        const jpegls_decoder decoder{source, true};
+        constexpr uint32_t stride{5};
+        vector<uint8_t> destination(decoder.destination_size({1, 2, 3, 4}, stride));
+        decoder.decode_region({1, 2, 3, 4}, destination, stride);
+
+        Assert::AreEqual(size_t{3 * 4 * stride - 2}, destination.size());
+        for (size_t plane{}; plane != 3; ++plane)
+        {
+            for (size_t line{}; line != 4; ++line)
+            {
+                for (size_t column{}; column != 3; ++column)
+                {
+                    Assert::AreEqual(expected[(plane * 4 + line) * 3 + column],
+                                     destination[(plane * 4 + line) * stride + column]);
+                }
+            }
+        }
+    }
+
+    TEST_METHOD(decode_region_outside_image_throws) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+        const jpegls_decoder decoder{source, true};
+        vector<uint8_t> destination(decoder.destination_size());
+
+        assert_expect_exception(jpegls_errc::invalid_argument,
+                                [&decoder, &destination] { decoder.decode_region({0, 0, 0, 1}, destination); });
+        assert_expect_exception(jpegls_errc::invalid_argument,
+                                [&decoder, &destination] { decoder.decode_region({0, 0, 1, 0}, destination); });
+        assert_expect_exception(jpegls_errc::invalid_argument,
+                                [&decoder, &destination] { decoder.decode_region({200, 0, 57, 1}, destination); });
+        assert_expect_exception(jpegls_errc::invalid_argument,
+                                [&decoder, &destination] { decoder.decode_region({0, 256, 1, 1}, destination); });
+        assert_expect_exception(jpegls_errc::invalid_argument, [&decoder] { std::ignore = decoder.destination_size({0, 255, 1, 2}); });
+    }
+
+    TEST_METHOD(decode_region_before_read_header_throws) // NOLINT
+    {
+        const vector<uint8_t> source{read_file("DataFiles/test8_ilv_sample_rm_7.jls")};
+        jpegls_decoder decoder;
+        decoder.source(source);
+        vector<uint8_t> destination(100);
+
+        assert_expect_exception(jpegls_errc::invalid_operation,
+                                [&decoder, &destination] { decoder.decode_region({0, 0, 1, 1}, destination); });
+    }
+
+    TEST_METHOD(decode_batch_with_negative_thread_count_throws) // NOLINT
+    {
+        vector<decode_batch_item> items;
+
+        assert_expect_exception(jpegls_errc::invalid_argument, [&items] { jpegls_decoder::decode_batch(items, -1); });
+    }
+
+    TEST_METHOD(thread_count_with_negative_value_throws) // NOLINT
+    {
+        jpegls_decoder decoder;
+
+        assert_expect_exception(jpegls_errc::invalid_argument, [&decoder] { decoder.thread_count(-1); });
+    }
+
 private:
     static vector<uint8_t>::iterator find_scan_header(const vector<uint8_t>::iterator begin,
                                                       const vector<uint8_t>::iterator end) noexcept
@@ -1071,6 +1602,82 @@ TEST_CLASS(jpegls_decoder_test)
         }
     }
 
+    static void decode_with_multiple_threads_and_compare(const char* filename)
+    {
+        const vector<uint8_t> source{read_file(filename)};
+        const jpegls_decoder decoder{source, true};
+        const auto expected{decoder.decode<vector<uint8_t>>()};
+
+        jpegls_decoder parallel_decoder{source, true};
+        parallel_decoder.thread_count(4);
+        const auto destination{parallel_decoder.decode<vector<uint8_t>>()};
+
+        Assert::IsTrue(expected == destination);
+    }
+
+    static void decode_region_and_compare(const vector<uint8_t>& source, const charls::region& region)
+    {
+        const jpegls_decoder decoder{source, true};
+        const auto& frame_info{decoder.frame_info()};
+        const auto image{decoder.decode<vector<uint8_t>>()};
+
+        const jpegls_decoder region_decoder{source, true};
+        const auto destination{region_decoder.decode_region<vector<uint8_t>>(region)};
+
+        const size_t plane_count{decoder.interleave_mode() == interleave_mode::none
+                                     ? static_cast<size_t>(frame_info.component_count)
+                                     : 1};
+        const size_t pixel_size{(decoder.interleave_mode() == interleave_mode::none ? 1 : frame_info.component_count) *
+                                static_cast<size_t>(frame_info.bits_per_sample > 8 ? 2 : 1)};
+        const size_t stride{frame_info.width * pixel_size};
+        const size_t region_stride{region.width * pixel_size};
+        Assert::AreEqual(region_stride * region.height * plane_count, destination.size());
+
+        for (size_t plane{}; plane != plane_count; ++plane)
+        {
+            for (size_t line{}; line != region.height; ++line)
+            {
+                const auto expected{image.cbegin() +
+                                    static_cast<ptrdiff_t>((plane * frame_info.height + region.y + line) * stride +
+                                                           region.x * pixel_size)};
+                Assert::IsTrue(std::equal(expected, expected + static_cast<ptrdiff_t>(region_stride),
+                                          destination.cbegin() +
+                                              static_cast<ptrdiff_t>((plane * region.height + line) * region_stride)));
+            }
+        }
+    }
+
+    static void decode_restart_intervals_on_multiple_threads(const char* filename)
+    {
+        const vector<uint8_t> source{read_file(filename)};
+        const auto expected{jpegls_decoder{source, true}.decode<vector<uint8_t>>()};
+
+        jpegls_decoder decoder{source, true};
+        const size_t count{decoder.read_restart_intervals()};
+        const auto& frame_info{decoder.frame_info()};
+
+        vector<uint8_t> destination(expected.size());
+        const size_t bytes_per_plane{expected.size() / (decoder.restart_interval_info(count - 1).scan_index + 1)};
+        vector<std::thread> threads;
+        for (size_t i{}; i != count; ++i)
+        {
+            const auto info{decoder.restart_interval_info(i)};
+            const size_t stride{static_cast<size_t>(frame_info.width) * static_cast<size_t>(info.component_count)};
+            uint8_t* interval_destination{destination.data() + info.scan_index * bytes_per_plane + info.first_line * stride};
+            const size_t interval_size{info.line_count * stride};
+            threads.emplace_back([&decoder, i, interval_destination, interval_size] {
+                decoder.decode_restart_interval(i, interval_destination, interval_size);
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        Assert::IsTrue(expected == destination);
+    }
+
     static void oversize_image_dimension_bad_segment_size_throws(const uint32_t number_of_bytes)
     {
         jpeg_test_stream_writer writer;
@@ -11,6 +11,7 @@
 
 #include <array>
 #include <limits>
+#include <random>
 #include <tuple>
 #include <vector>
 
@@ -1369,6 +1370,49 @@ TEST_CLASS(jpegls_encoder_test)
         test_by_decoding(destination, frame_info, source.data(), source.size(), interleave_mode::none);
     }
 
+    TEST_METHOD(reset_and_encode_to_new_destination) // NOLINT
+    {
+        const array<uint8_t, 6> source{0, 1, 2, 3, 4, 5};
+        constexpr frame_info frame_info{3, 1, 16, 1};
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info);
+
+        vector<uint8_t> destination1(encoder.estimated_destination_size());
+        encoder.destination(destination1);
+        destination1.resize(encoder.encode(source));
+
+        encoder.reset();
+        vector<uint8_t> destination2(encoder.estimated_destination_size());
+        encoder.destination(destination2);
+        destination2.resize(encoder.encode(source));
+
+        Assert::IsTrue(destination1 == destination2);
+        test_by_decoding(destination2, frame_info, source.data(), source.size(), interleave_mode::none);
+    }
+
+    TEST_METHOD(reset_and_encode_image_with_other_frame_info) // NOLINT
+    {
+        const array<uint8_t, 6> source{0, 1, 2, 3, 4, 5};
+        constexpr frame_info frame_info1{3, 1, 16, 1};
+        constexpr frame_info frame_info2{2, 3, 8, 1};
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info1);
+        vector<uint8_t> destination1(encoder.estimated_destination_size());
+        encoder.destination(destination1);
+        destination1.resize(encoder.encode(source));
+
+        encoder.reset();
+        encoder.frame_info(frame_info2);
+        vector<uint8_t> destination2(encoder.estimated_destination_size());
+        encoder.destination(destination2);
+        destination2.resize(encoder.encode(source));
+
+        test_by_decoding(destination1, frame_info1, source.data(), source.size(), interleave_mode::none);
+        test_by_decoding(destination2, frame_info2, source.data(), source.size(), interleave_mode::none);
+    }
+
     TEST_METHOD(encode_image_odd_size) // NOLINT
     {
         constexpr frame_info frame_info{512, 512, 8, 1};
@@ -1487,7 +1531,76 @@ TEST_CLASS(jpegls_encoder_test)
         jpegls_encoder encoder;
 
         assert_expect_exception(jpegls_errc::invalid_argument_encoding_options,
-                                [&encoder] { encoder.encoding_options(static_cast<encoding_options>(8)); });
+                                [&encoder] { encoder.encoding_options(static_cast<encoding_options>(32)); });
+    }
+
+    TEST_METHOD(encode_with_validate_sample_values_and_out_of_range_sample_throws) // NOLINT
+    {
+        constexpr frame_info frame_info{100, 2, 12, 1};
+        vector<uint16_t> source(static_cast<size_t>(frame_info.width) * frame_info.height, 4095);
+        source[150] = 4096;
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).encoding_options(encoding_options::validate_sample_values);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+
+        assert_expect_exception(jpegls_errc::invalid_argument_sample_value,
+                                [&encoder, &source] { ignore = encoder.encode(source); });
+    }
+
+    TEST_METHOD(encode_with_validate_sample_values_and_valid_samples) // NOLINT
+    {
+        constexpr frame_info frame_info{100, 2, 10, 1};
+        vector<uint16_t> source(static_cast<size_t>(frame_info.width) * frame_info.height);
+        for (size_t i{}; i != source.size(); ++i)
+        {
+            source[i] = static_cast<uint16_t>(i * 5 % 1024);
+        }
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).encoding_options(encoding_options::validate_sample_values);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(source));
+
+        test_by_decoding(destination, frame_info, source.data(), source.size() * sizeof(uint16_t),
+                         interleave_mode::none);
+    }
+
+    TEST_METHOD(encode_without_validate_sample_values_masks_out_of_range_sample) // NOLINT
+    {
+        constexpr frame_info frame_info{100, 2, 12, 1};
+        vector<uint16_t> source(static_cast<size_t>(frame_info.width) * frame_info.height, 4095);
+        source[150] = 4096 + 7;
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(source));
+
+        source[150] = 7;
+        test_by_decoding(destination, frame_info, source.data(), source.size() * sizeof(uint16_t),
+                         interleave_mode::none);
+    }
+
+    TEST_METHOD(encode_interleaved_with_validate_sample_values_and_out_of_range_sample_throws) // NOLINT
+    {
+        constexpr frame_info frame_info{50, 2, 10, 3};
+        vector<uint16_t> source(static_cast<size_t>(frame_info.width) * frame_info.height * frame_info.component_count,
+                                1023);
+        source[200] = 1024;
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info)
+            .interleave_mode(interleave_mode::line)
+            .encoding_options(encoding_options::validate_sample_values);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+
+        assert_expect_exception(jpegls_errc::invalid_argument_sample_value,
+                                [&encoder, &source] { ignore = encoder.encode(source); });
     }
 
     TEST_METHOD(large_image_contains_lse_for_oversize_image_dimension) // NOLINT
@@ -1621,7 +1734,364 @@ TEST_CLASS(jpegls_encoder_test)
         ignore = encoder.encode(data2, size2);
     }
 
+    TEST_METHOD(encode_interleave_none_with_multiple_threads) // NOLINT
+    {
+        const charls_test::portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", interleave_mode::none)};
+        const frame_info frame_info{static_cast<uint32_t>(reference_file.width()),
+                                    static_cast<uint32_t>(reference_file.height()), reference_file.bits_per_sample(),
+                                    reference_file.component_count()};
+
+        const vector<uint8_t> expected{
+            jpegls_encoder::encode(reference_file.image_data(), frame_info, interleave_mode::none)};
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).thread_count(3);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(reference_file.image_data()));
+
+        Assert::IsTrue(expected == destination);
+        test_by_decoding(destination, frame_info, reference_file.image_data().data(), reference_file.image_data().size(),
+                         interleave_mode::none);
+    }
+
+    TEST_METHOD(encode_interleave_none_noise_image_with_multiple_threads) // NOLINT
+    {
+        // Noise images cannot be compressed: the encoded scans are larger than their pixel data.
+        constexpr frame_info frame_info{256, 256, 8, 4};
+        const vector<uint8_t> source{create_noise_image_8_bit(static_cast<size_t>(frame_info.width) * frame_info.height *
+                                                              frame_info.component_count)};
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info);
+        vector<uint8_t> expected(encoder.estimated_destination_size() * 2);
+        encoder.destination(expected);
+        expected.resize(encoder.encode(source));
+
+        jpegls_encoder parallel_encoder;
+        parallel_encoder.frame_info(frame_info).thread_count(0);
+        vector<uint8_t> destination(expected.size());
+        parallel_encoder.destination(destination);
+        Assert::AreEqual(expected.size(), parallel_encoder.encode(source));
+
+        Assert::IsTrue(expected == destination);
+    }
+
+    TEST_METHOD(encode_interleave_none_with_multiple_threads_to_too_small_buffer_throws) // NOLINT
+    {
+        constexpr frame_info frame_info{256, 256, 8, 3};
+        const vector<uint8_t> source{create_noise_image_8_bit(static_cast<size_t>(frame_info.width) * frame_info.height *
+                                                              frame_info.component_count)};
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).thread_count(3);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+
+        assert_expect_exception(jpegls_errc::destination_buffer_too_small,
+                                [&encoder, &source] { ignore = encoder.encode(source); });
+    }
+
+    TEST_METHOD(encode_interleaved_scan_with_multiple_threads) // NOLINT
+    {
+        encode_with_multiple_threads_and_compare(interleave_mode::line, color_transformation::none);
+        encode_with_multiple_threads_and_compare(interleave_mode::sample, color_transformation::none);
+        encode_with_multiple_threads_and_compare(interleave_mode::line, color_transformation::hp1);
+        encode_with_multiple_threads_and_compare(interleave_mode::sample, color_transformation::hp3);
+    }
+
+    TEST_METHOD(encode_with_restart_interval) // NOLINT
+    {
+        encode_with_restart_interval_and_compare(interleave_mode::none, 7);
+        encode_with_restart_interval_and_compare(interleave_mode::line, 7);
+        encode_with_restart_interval_and_compare(interleave_mode::sample, 300);
+        encode_with_restart_interval_and_compare(interleave_mode::sample, 1);
+    }
+
+    TEST_METHOD(encode_with_restart_interval_writes_restart_markers) // NOLINT
+    {
+        constexpr frame_info frame_info{4, 20, 8, 1};
+        const vector<uint8_t> source(static_cast<size_t>(frame_info.width) * frame_info.height, 5);
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).restart_interval(2);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(source));
+
+        // 20 lines with 2 lines per restart interval: 9 restart markers, RST0..RST7 followed by RST0.
+        const auto start_of_scan{find_marker(destination.cbegin(), destination.cend(), 0xDA)};
+        Assert::IsTrue(start_of_scan != destination.cend());
+        auto marker{start_of_scan};
+        for (int i{}; i != 9; ++i)
+        {
+            marker = find_marker(marker + 2, destination.cend(), 0xD0 + i % 8);
+            Assert::IsTrue(marker != destination.cend());
+        }
+
+        Assert::IsTrue(find_marker(destination.cbegin(), start_of_scan, 0xDD) != start_of_scan); // DRI
+    }
+
+    TEST_METHOD(encode_noise_with_restart_interval_fits_estimated_destination_size) // NOLINT
+    {
+        // The coding contexts are reset at every restart interval, which makes the intervals of noise larger than their
+        // pixel data.
+        constexpr frame_info frame_info{9, 100, 8, 4};
+        const vector<uint8_t> source{create_noise_image_8_bit(static_cast<size_t>(frame_info.width) * frame_info.height *
+                                                              frame_info.component_count)};
+
+        for (const auto interleave_mode : {interleave_mode::none, interleave_mode::line, interleave_mode::sample})
+        {
+            jpegls_encoder encoder;
+            encoder.frame_info(frame_info).interleave_mode(interleave_mode).restart_interval(3);
+            vector<uint8_t> destination(encoder.estimated_destination_size());
+            encoder.destination(destination);
+            destination.resize(encoder.encode(source));
+
+            test_by_decoding(destination, frame_info, source.data(), source.size(), interleave_mode);
+        }
+    }
+
+    TEST_METHOD(encode_with_restart_marker_index_writes_offsets_of_restart_markers) // NOLINT
+    {
+        constexpr frame_info frame_info{4, 20, 8, 1};
+        const vector<uint8_t> source(create_noise_image_8_bit(static_cast<size_t>(frame_info.width) * frame_info.height));
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).restart_interval(2).encoding_options(encoding_options::include_restart_marker_index);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(source));
+
+        // The APP9 segment should be located before the SOS segment and contain the offsets of the 9 restart markers.
+        const auto start_of_scan{find_marker(destination.cbegin(), destination.cend(), 0xDA)};
+        const auto index_segment{find_marker(destination.cbegin(), start_of_scan, 0xE9)};
+        Assert::IsTrue(index_segment != start_of_scan);
+        Assert::AreEqual(2 + 4 + (9 * 4), (index_segment[2] << 8) | index_segment[3]);
+        Assert::IsTrue(std::equal(index_segment + 4, index_segment + 8, "rsti"));
+
+        const auto scan_data{start_of_scan + 2 + 8};
+        for (int i{}; i != 9; ++i)
+        {
+            const auto entry{index_segment + 8 + static_cast<ptrdiff_t>(i) * 4};
+            const auto offset{(entry[0] << 24) | (entry[1] << 16) | (entry[2] << 8) | entry[3]};
+            Assert::AreEqual(0xFF, static_cast<int>(scan_data[offset]));
+            Assert::AreEqual(0xD0 + i % 8, static_cast<int>(scan_data[offset + 1]));
+        }
+
+        test_by_decoding(destination, frame_info, source.data(), source.size(), interleave_mode::none);
+    }
+
+    TEST_METHOD(encode_with_restart_marker_index_and_multiple_threads) // NOLINT
+    {
+        const charls_test::portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", interleave_mode::none)};
+        const frame_info frame_info{static_cast<uint32_t>(reference_file.width()),
+                                    static_cast<uint32_t>(reference_file.height()), reference_file.bits_per_sample(),
+                                    reference_file.component_count()};
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).restart_interval(7).encoding_options(encoding_options::include_restart_marker_index);
+        vector<uint8_t> expected(encoder.estimated_destination_size());
+        encoder.destination(expected);
+        expected.resize(encoder.encode(reference_file.image_data()));
+
+        jpegls_encoder parallel_encoder;
+        parallel_encoder.frame_info(frame_info)
+            .restart_interval(7)
+            .encoding_options(encoding_options::include_restart_marker_index)
+            .thread_count(4);
+        vector<uint8_t> destination(parallel_encoder.estimated_destination_size());
+        parallel_encoder.destination(destination);
+        destination.resize(parallel_encoder.encode(reference_file.image_data()));
+
+        Assert::IsTrue(expected == destination);
+        test_by_decoding(destination, frame_info, reference_file.image_data().data(), reference_file.image_data().size(),
+                         interleave_mode::none);
+    }
+
+    TEST_METHOD(encode_with_restart_marker_index_without_restart_interval) // NOLINT
+    {
+        constexpr frame_info frame_info{4, 20, 8, 1};
+        const vector<uint8_t> source(static_cast<size_t>(frame_info.width) * frame_info.height, 5);
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).encoding_options(encoding_options::include_restart_marker_index);
+        vector<uint8_t> destination(encoder.estimated_destination_size());
+        encoder.destination(destination);
+        destination.resize(encoder.encode(source));
+
+        Assert::IsTrue(find_marker(destination.cbegin(), destination.cend(), 0xE9) == destination.cend());
+    }
+
+    TEST_METHOD(encode_16_bit_with_restart_interval_and_multiple_threads) // NOLINT
+    {
+        constexpr frame_info frame_info{64, 61, 12, 1};
+        vector<uint8_t> source(static_cast<size_t>(frame_info.width) * frame_info.height * 2);
+        const vector<uint8_t> noise{create_noise_image_8_bit(source.size())};
+        for (size_t i{}; i < source.size(); i += 2)
+        {
+            source[i] = noise[i];
+            source[i + 1] = noise[i + 1] & 0xF;
+        }
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).restart_interval(5);
+        vector<uint8_t> expected(encoder.estimated_destination_size());
+        encoder.destination(expected);
+        expected.resize(encoder.encode(source));
+
+        jpegls_encoder parallel_encoder;
+        parallel_encoder.frame_info(frame_info).restart_interval(5).thread_count(4);
+        vector<uint8_t> destination(parallel_encoder.estimated_destination_size());
+        parallel_encoder.destination(destination);
+        destination.resize(parallel_encoder.encode(source));
+
+        Assert::IsTrue(expected == destination);
+        test_by_decoding(destination, frame_info, source.data(), source.size(), interleave_mode::none);
+    }
+
+    TEST_METHOD(encode_batch) // NOLINT
+    {
+        const charls_test::portable_anymap_file color_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", interleave_mode::sample)};
+        const charls_test::portable_anymap_file monochrome_file{
+            read_anymap_reference_file("DataFiles/test16.pgm", interleave_mode::none)};
+        const array<const charls_test::portable_anymap_file*, 4> files{&color_file, &monochrome_file, &color_file,
+                                                                        &monochrome_file};
+        const array<charls::interleave_mode, 4> interleave_modes{interleave_mode::sample, interleave_mode::none,
+                                                                 interleave_mode::line, interleave_mode::none};
+
+        vector<vector<uint8_t>> destinations(files.size());
+        vector<encode_batch_item> items(files.size());
+        for (size_t i{}; i != items.size(); ++i)
+        {
+            const auto& file{*files[i]};
+            const frame_info frame_info{static_cast<uint32_t>(file.width()), static_cast<uint32_t>(file.height()),
+                                        file.bits_per_sample(), file.component_count()};
+            destinations[i].resize(file.image_data().size() + 1024);
+            items[i] = {file.image_data().data(),
+                        file.image_data().size(),
+                        0,
+                        frame_info,
+                        interleave_modes[i],
+                        static_cast<int32_t>(i % 2),
+                        destinations[i].data(),
+                        destinations[i].size(),
+                        0,
+                        jpegls_errc::invalid_operation};
+        }
+
+        jpegls_encoder::encode_batch(items, 3);
+
+        for (size_t i{}; i != items.size(); ++i)
+        {
+            Assert::AreEqual(jpegls_errc::success, items[i].result);
+
+            jpegls_encoder encoder;
+            encoder.frame_info(items[i].frame_info)
+                .interleave_mode(items[i].interleave_mode)
+                .near_lossless(items[i].near_lossless)
+                .encoding_options(encoding_options::include_pc_parameters_jai);
+            vector<uint8_t> expected(encoder.estimated_destination_size());
+            encoder.destination(expected);
+            expected.resize(encoder.encode(files[i]->image_data()));
+
+            destinations[i].resize(items[i].bytes_written);
+            Assert::IsTrue(expected == destinations[i]);
+        }
+    }
+
+    TEST_METHOD(encode_batch_reports_result_per_item) // NOLINT
+    {
+        constexpr frame_info frame_info{256, 256, 8, 1};
+        const vector<uint8_t> source{create_noise_image_8_bit(static_cast<size_t>(frame_info.width) * frame_info.height)};
+
+        vector<uint8_t> destination1(source.size() * 2);
+        vector<uint8_t> destination2(100);
+        array<encode_batch_item, 2> items{
+            {{source.data(), source.size(), 0, frame_info, interleave_mode::none, 0, destination1.data(),
+              destination1.size(), 0, jpegls_errc::invalid_operation},
+             {source.data(), source.size(), 0, frame_info, interleave_mode::none, 0, destination2.data(),
+              destination2.size(), 0, jpegls_errc::invalid_operation}}};
+
+        jpegls_encoder::encode_batch(items);
+
+        Assert::AreEqual(jpegls_errc::success, items[0].result);
+        Assert::AreNotEqual(size_t{}, items[0].bytes_written);
+        Assert::AreEqual(jpegls_errc::destination_buffer_too_small, items[1].result);
+        Assert::AreEqual(size_t{}, items[1].bytes_written);
+    }
+
+    TEST_METHOD(encode_with_restart_interval_and_executor) // NOLINT
+    {
+        const charls_test::portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", interleave_mode::line)};
+        const frame_info frame_info{static_cast<uint32_t>(reference_file.width()),
+                                    static_cast<uint32_t>(reference_file.height()), reference_file.bits_per_sample(),
+                                    reference_file.component_count()};
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).interleave_mode(interleave_mode::line).restart_interval(16);
+        vector<uint8_t> expected(encoder.estimated_destination_size());
+        encoder.destination(expected);
+        expected.resize(encoder.encode(reference_file.image_data()));
+
+        thread_per_task_executor executor;
+        jpegls_encoder parallel_encoder;
+        parallel_encoder.frame_info(frame_info)
+            .interleave_mode(interleave_mode::line)
+            .restart_interval(16)
+            .thread_count(2)
+            .executor(executor);
+        vector<uint8_t> destination(parallel_encoder.estimated_destination_size());
+        parallel_encoder.destination(destination);
+        destination.resize(parallel_encoder.encode(reference_file.image_data()));
+
+        Assert::AreEqual(1, executor.submit_count.load());
+        Assert::IsTrue(expected == destination);
+    }
+
+    TEST_METHOD(thread_count_with_negative_value_throws) // NOLINT
+    {
+        jpegls_encoder encoder;
+
+        assert_expect_exception(jpegls_errc::invalid_argument, [&encoder] { encoder.thread_count(-1); });
+    }
+
 private:
+    static void encode_with_multiple_threads_and_compare(const charls::interleave_mode interleave_mode,
+                                                         const color_transformation color_transformation)
+    {
+        const charls_test::portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", interleave_mode)};
+        const frame_info frame_info{static_cast<uint32_t>(reference_file.width()),
+                                    static_cast<uint32_t>(reference_file.height()), reference_file.bits_per_sample(),
+                                    reference_file.component_count()};
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).interleave_mode(interleave_mode).color_transformation(color_transformation);
+        vector<uint8_t> expected(encoder.estimated_destination_size());
+        encoder.destination(expected);
+        expected.resize(encoder.encode(reference_file.image_data()));
+
+        jpegls_encoder parallel_encoder;
+        parallel_encoder.frame_info(frame_info)
+            .interleave_mode(interleave_mode)
+            .color_transformation(color_transformation)
+            .thread_count(2);
+        vector<uint8_t> destination(parallel_encoder.estimated_destination_size());
+        parallel_encoder.destination(destination);
+        destination.resize(parallel_encoder.encode(reference_file.image_data()));
+
+        Assert::IsTrue(expected == destination);
+
+        jpegls_decoder decoder{destination, true};
+        decoder.thread_count(2);
+        Assert::IsTrue(reference_file.image_data() == decoder.decode<vector<uint8_t>>());
+    }
+
     static void test_by_decoding(const vector<uint8_t>& encoded_source, const frame_info& source_frame_info,
                                  const void* expected_destination, const size_t expected_destination_size,
                                  const charls::interleave_mode interleave_mode,
@@ -1676,6 +2146,62 @@ TEST_CLASS(jpegls_encoder_test)
         test_by_decoding(destination, frame_info, source.data(), source.size(), interleave_mode::none);
     }
 
+    static void encode_with_restart_interval_and_compare(const charls::interleave_mode interleave_mode,
+                                                         const uint32_t restart_interval)
+    {
+        const charls_test::portable_anymap_file reference_file{
+            read_anymap_reference_file("DataFiles/test8.ppm", interleave_mode)};
+        const frame_info frame_info{static_cast<uint32_t>(reference_file.width()),
+                                    static_cast<uint32_t>(reference_file.height()), reference_file.bits_per_sample(),
+                                    reference_file.component_count()};
+
+        jpegls_encoder encoder;
+        encoder.frame_info(frame_info).interleave_mode(interleave_mode).restart_interval(restart_interval);
+        vector<uint8_t> expected(encoder.estimated_destination_size());
+        encoder.destination(expected);
+        expected.resize(encoder.encode(reference_file.image_data()));
+
+        test_by_decoding(expected, frame_info, reference_file.image_data().data(), reference_file.image_data().size(),
+                         interleave_mode);
+
+        jpegls_encoder parallel_encoder;
+        parallel_encoder.frame_info(frame_info)
+            .interleave_mode(interleave_mode)
+            .restart_interval(restart_interval)
+            .thread_count(4);
+        vector<uint8_t> destination(parallel_encoder.estimated_destination_size());
+        parallel_encoder.destination(destination);
+        destination.resize(parallel_encoder.encode(reference_file.image_data()));
+
+        Assert::IsTrue(expected == destination);
+    }
+
+    static vector<uint8_t>::const_iterator find_marker(const vector<uint8_t>::const_iterator begin,
+                                                       const vector<uint8_t>::const_iterator end, const int marker_code)
+    {
+        for (auto it{begin}; it + 1 < end; ++it)
+        {
+            if (*it == 0xFF && *(it + 1) == marker_code)
+                return it;
+        }
+
+        return end;
+    }
+
+    static vector<uint8_t> create_noise_image_8_bit(const size_t size)
+    {
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<uint32_t> distribution(0, 255);
+
+        vector<uint8_t> buffer(size);
+        for (auto& value : buffer)
+        {
+            value = static_cast<uint8_t>(distribution(generator));
+        }
+
+        return buffer;
+    }
+
     static vector<uint8_t>::const_iterator find_first_lse_segment(const vector<uint8_t>::const_iterator begin,
                                                                   const vector<uint8_t>::const_iterator end) noexcept
     {
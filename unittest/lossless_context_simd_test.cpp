@@ -0,0 +1,151 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.h"
+
+#include "../src/cpu_features.h"
+#include "../src/jpegls_preset_coding_parameters.h"
+#include "../src/lossless_context_simd.h"
+#include "../src/scan.h"
+
+#include <random>
+#include <vector>
+
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using std::vector;
+
+namespace charls { namespace test {
+
+namespace {
+
+// The pixel count is not a multiple of the block size: the kernels only process the complete blocks.
+constexpr size_t pixel_count{100};
+
+using select_kernel_function = lossless_context_kernel (*)(size_t);
+
+vector<select_kernel_function> supported_kernel_selectors()
+{
+    vector<select_kernel_function> selectors;
+    if (cpu_supports_sse41())
+    {
+        selectors.push_back(&select_lossless_context_kernel_sse41);
+    }
+    if (cpu_supports_avx2())
+    {
+        selectors.push_back(&select_lossless_context_kernel_avx2);
+    }
+    return selectors;
+}
+
+
+int32_t quantize_gradient(const int32_t di, const jpegls_pc_parameters& presets) noexcept
+{
+    if (di <= -presets.threshold3)
+        return -4;
+    if (di <= -presets.threshold2)
+        return -3;
+    if (di <= -presets.threshold1)
+        return -2;
+    if (di < 0)
+        return -1;
+    if (di == 0)
+        return 0;
+    if (di < presets.threshold1)
+        return 1;
+    if (di < presets.threshold2)
+        return 2;
+    if (di < presets.threshold3)
+        return 3;
+
+    return 4;
+}
+
+
+template<typename SampleType>
+void check_kernels(const int32_t bits_per_sample, const uint32_t seed)
+{
+    const int32_t maximum_sample_value{(1 << bits_per_sample) - 1};
+    const jpegls_pc_parameters presets{compute_default(maximum_sample_value, 0)};
+
+    // Lines with small and large gradients: all quantized values are used.
+    std::mt19937 generator(seed);
+    MSVC_WARNING_SUPPRESS_NEXT_LINE(26496) // cannot be marked as const as operator() is not always defined const.
+    std::uniform_int_distribution<int32_t> distribution(0, maximum_sample_value);
+    vector<SampleType> previous_line(pixel_count + 2);
+    vector<SampleType> current_line(pixel_count + 1);
+    for (size_t i{}; i != previous_line.size(); ++i)
+    {
+        previous_line[i] = static_cast<SampleType>(i % 4 == 0 ? distribution(generator) : (i * 3) & maximum_sample_value);
+    }
+    for (size_t i{}; i != current_line.size(); ++i)
+    {
+        current_line[i] = static_cast<SampleType>(i % 3 == 0 ? distribution(generator) : previous_line[i]);
+    }
+
+    for (const auto select_kernel : supported_kernel_selectors())
+    {
+        vector<int16_t> context_ids(pixel_count);
+        vector<SampleType> predicted_values(pixel_count);
+        const size_t computed{select_kernel(sizeof(SampleType))(
+            &previous_line[1], &current_line[1], pixel_count, presets.threshold1, presets.threshold2,
+            presets.threshold3, context_ids.data(), predicted_values.data())};
+
+        Assert::IsTrue(computed > 0 && computed <= pixel_count);
+        for (size_t i{}; i != computed; ++i)
+        {
+            const int32_t ra{current_line[i]};
+            const int32_t rc{previous_line[i]};
+            const int32_t rb{previous_line[i + 1]};
+            const int32_t rd{previous_line[i + 2]};
+
+            Assert::AreEqual(compute_context_id(quantize_gradient(rd - rb, presets), quantize_gradient(rb - rc, presets),
+                                                quantize_gradient(rc - ra, presets)),
+                             static_cast<int32_t>(context_ids[i]));
+            Assert::AreEqual(get_predicted_value(ra, rb, rc), static_cast<int32_t>(predicted_values[i]));
+        }
+    }
+}
+
+} // namespace
+
+
+TEST_CLASS(lossless_context_simd_test)
+{
+public:
+    TEST_METHOD(kernels_8_bit_match_scalar_implementation) // NOLINT
+    {
+        check_kernels<uint8_t>(8, 1);
+        check_kernels<uint8_t>(8, 2);
+    }
+
+    TEST_METHOD(kernels_16_bit_match_scalar_implementation) // NOLINT
+    {
+        check_kernels<uint16_t>(10, 3);
+        check_kernels<uint16_t>(12, 4);
+        check_kernels<uint16_t>(16, 5);
+    }
+
+    TEST_METHOD(kernels_are_instruction_set_specific) // NOLINT
+    {
+        // The SSE4.1 and AVX2 kernels are compiled from the same templates, but must not share their instantiations.
+        for (const size_t bytes_per_sample : {size_t{1}, size_t{2}})
+        {
+            const auto sse41_kernel{select_lossless_context_kernel_sse41(bytes_per_sample)};
+            const auto avx2_kernel{select_lossless_context_kernel_avx2(bytes_per_sample)};
+            if (sse41_kernel && avx2_kernel)
+            {
+                Assert::IsTrue(sse41_kernel != avx2_kernel);
+            }
+        }
+    }
+
+    TEST_METHOD(no_kernel_for_unsupported_sample_size) // NOLINT
+    {
+        for (const auto select_kernel : supported_kernel_selectors())
+        {
+            Assert::IsTrue(select_kernel(4) == nullptr);
+        }
+    }
+};
+
+}} // namespace charls::test
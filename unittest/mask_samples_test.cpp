@@ -0,0 +1,123 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.h"
+
+#include "../src/cpu_features.h"
+#include "../src/mask_samples.h"
+
+#include <cstring>
+#include <vector>
+
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using std::vector;
+
+namespace charls { namespace test {
+
+namespace {
+
+// The sample count is not a multiple of the block size: the kernels only process the complete blocks.
+constexpr size_t sample_count{301};
+
+vector<mask_samples_kernel> supported_kernels()
+{
+    vector<mask_samples_kernel> kernels;
+    if (cpu_supports_sse41())
+    {
+        kernels.push_back(get_mask_samples_kernel_sse41());
+    }
+    if (cpu_supports_avx2())
+    {
+        kernels.push_back(get_mask_samples_kernel_avx2());
+    }
+    return kernels;
+}
+
+
+template<typename SampleType>
+vector<SampleType> create_samples(const uint32_t mask)
+{
+    vector<SampleType> samples(sample_count);
+    for (size_t i{}; i != samples.size(); ++i)
+    {
+        samples[i] = static_cast<SampleType>((i * 7919) & mask);
+    }
+    return samples;
+}
+
+
+template<typename SampleType>
+void check_mask_samples(const uint32_t mask)
+{
+    auto source{create_samples<SampleType>(mask)};
+    vector<SampleType> destination(sample_count);
+
+    Assert::AreEqual(0U, mask_samples(source.data(), destination.data(), sample_count, mask) & ~mask);
+    Assert::IsTrue(source == destination);
+
+    // Out of range samples are masked and reported, at the start, in the middle and at the end (scalar tail).
+    for (const size_t index : {size_t{0}, sample_count / 2, sample_count - 1})
+    {
+        source = create_samples<SampleType>(mask);
+        const auto expected{source};
+        source[index] = static_cast<SampleType>(source[index] | (mask + 1));
+
+        const uint32_t source_bits{mask_samples(source.data(), destination.data(), sample_count, mask)};
+
+        Assert::AreEqual(mask + 1, source_bits & ~mask);
+        Assert::IsTrue(expected == destination);
+    }
+}
+
+
+template<typename SampleType>
+void check_kernels(const uint32_t mask, const uint32_t mask_pattern)
+{
+    const auto expected{create_samples<SampleType>(mask)};
+    auto source{expected};
+    source[3] = static_cast<SampleType>(source[3] | (mask + 1));
+
+    for (const auto kernel : supported_kernels())
+    {
+        vector<SampleType> destination(sample_count);
+        uint32_t source_pattern{};
+        const size_t byte_count{
+            kernel(source.data(), destination.data(), sample_count * sizeof(SampleType), mask_pattern, source_pattern)};
+
+        Assert::IsTrue(byte_count > 0 && byte_count <= sample_count * sizeof(SampleType));
+        Assert::AreEqual(size_t{}, byte_count % sizeof(SampleType));
+        Assert::AreEqual(0, memcmp(expected.data(), destination.data(), byte_count));
+        Assert::AreNotEqual(0U, source_pattern & ~mask_pattern);
+    }
+}
+
+} // namespace
+
+
+TEST_CLASS(mask_samples_test)
+{
+public:
+    TEST_METHOD(mask_samples_8_bit) // NOLINT
+    {
+        check_mask_samples<uint8_t>(0x7F);
+        check_mask_samples<uint8_t>(0x0F);
+    }
+
+    TEST_METHOD(mask_samples_16_bit) // NOLINT
+    {
+        check_mask_samples<uint16_t>(0x3FF);
+        check_mask_samples<uint16_t>(0xFFF);
+    }
+
+    TEST_METHOD(kernels_8_bit) // NOLINT
+    {
+        check_kernels<uint8_t>(0x7F, 0x7F7F7F7F);
+    }
+
+    TEST_METHOD(kernels_16_bit) // NOLINT
+    {
+        check_kernels<uint16_t>(0xFFF, 0x0FFF0FFF);
+    }
+};
+
+}} // namespace charls::test
@@ -0,0 +1,127 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.h"
+
+#include "../src/parallel_for.h"
+#include "../src/thread_pool.h"
+
+#include "util.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using std::atomic;
+using std::vector;
+
+namespace charls { namespace test {
+
+namespace {
+
+void CHARLS_API_CALLING_CONVENTION increment(void* task_context) noexcept
+{
+    ++*static_cast<atomic<int>*>(task_context);
+}
+
+} // namespace
+
+
+TEST_CLASS(parallel_for_test)
+{
+public:
+    TEST_METHOD(executes_all_tasks_with_built_in_thread_pool) // NOLINT
+    {
+        vector<atomic<int>> counters(100);
+
+        parallel_for(counters.size(), 0, charls_executor{}, [&counters](const size_t index) { ++counters[index]; });
+
+        for (const auto& counter : counters)
+        {
+            Assert::AreEqual(1, counter.load());
+        }
+    }
+
+    TEST_METHOD(requests_threads_from_executor) // NOLINT
+    {
+        thread_per_task_executor executor;
+        vector<atomic<int>> counters(100);
+
+        parallel_for(counters.size(), 4, executor.c_executor(), [&counters](const size_t index) { ++counters[index]; });
+
+        Assert::AreEqual(3, executor.submit_count.load());
+        for (const auto& counter : counters)
+        {
+            Assert::AreEqual(1, counter.load());
+        }
+    }
+
+    TEST_METHOD(rejected_tasks_are_executed_by_calling_thread) // NOLINT
+    {
+        deferred_executor executor;
+        executor.reject = true;
+        const auto calling_thread_id{std::this_thread::get_id()};
+        vector<int> counters(10);
+
+        parallel_for(counters.size(), 4, executor.c_executor(), [&counters, calling_thread_id](const size_t index) {
+            Assert::IsTrue(calling_thread_id == std::this_thread::get_id());
+            ++counters[index];
+        });
+
+        for (const auto counter : counters)
+        {
+            Assert::AreEqual(1, counter);
+        }
+    }
+
+    TEST_METHOD(late_tasks_return_directly) // NOLINT
+    {
+        deferred_executor executor;
+        vector<int> counters(10);
+
+        parallel_for(counters.size(), 4, executor.c_executor(), [&counters](const size_t index) { ++counters[index]; });
+
+        Assert::AreEqual(size_t{3}, executor.tasks.size());
+        executor.execute_tasks(); // The tasks start after parallel_for has completed all work: they should do nothing.
+
+        for (const auto counter : counters)
+        {
+            Assert::AreEqual(1, counter);
+        }
+    }
+
+    TEST_METHOD(first_exception_is_rethrown) // NOLINT
+    {
+        assert_expect_exception(jpegls_errc::invalid_operation, [] {
+            parallel_for(10, 4, charls_executor{}, [](const size_t index) {
+                if (index == 3)
+                    impl::throw_jpegls_error(jpegls_errc::invalid_operation);
+            });
+        });
+    }
+
+    TEST_METHOD(thread_pool_executes_all_submitted_tasks) // NOLINT
+    {
+        atomic<int> counter{};
+        {
+            thread_pool pool{2};
+            for (int i{}; i != 100; ++i)
+            {
+                Assert::IsTrue(pool.submit(&increment, &counter));
+            }
+        }
+
+        Assert::AreEqual(100, counter.load());
+    }
+
+    TEST_METHOD(thread_pool_without_threads_rejects_tasks) // NOLINT
+    {
+        thread_pool pool{0};
+        atomic<int> counter{};
+
+        Assert::IsFalse(pool.submit(&increment, &counter));
+    }
+};
+
+}} // namespace charls::test
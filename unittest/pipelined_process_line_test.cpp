@@ -0,0 +1,222 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.h"
+
+#include "../src/pipelined_process_line.h"
+
+#include "util.h"
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using std::make_unique;
+using std::vector;
+
+namespace charls { namespace test {
+
+namespace {
+
+constexpr size_t width{4};
+constexpr size_t stride{width + 4};
+
+// Records the decoded lines and provides lines with the value line index + component index when encoding.
+class line_recorder final : public process_line
+{
+public:
+    line_recorder(vector<vector<uint8_t>>& lines, const size_t component_count,
+                  const size_t failing_line = std::numeric_limits<size_t>::max()) noexcept :
+        lines_{lines}, component_count_{component_count}, failing_line_{failing_line}
+    {
+    }
+
+    void new_line_decoded(const void* source, const size_t pixel_count, const size_t source_stride) override
+    {
+        if (lines_.size() == failing_line_)
+            impl::throw_jpegls_error(jpegls_errc::invalid_operation);
+
+        const auto* pixels{static_cast<const uint8_t*>(source)};
+        vector<uint8_t> line;
+        for (size_t component{}; component != component_count_; ++component)
+        {
+            line.insert(line.end(), pixels + component * source_stride, pixels + component * source_stride + pixel_count);
+        }
+        lines_.push_back(line);
+    }
+
+    void new_line_requested(void* destination, const size_t pixel_count, const size_t destination_stride) override
+    {
+        if (lines_.size() == failing_line_)
+            impl::throw_jpegls_error(jpegls_errc::invalid_operation);
+
+        for (size_t component{}; component != component_count_; ++component)
+        {
+            memset(static_cast<uint8_t*>(destination) + component * destination_stride,
+                   static_cast<uint8_t>(lines_.size() + component), pixel_count);
+        }
+        lines_.emplace_back();
+    }
+
+private:
+    vector<vector<uint8_t>>& lines_;
+    size_t component_count_;
+    size_t failing_line_;
+};
+
+
+vector<uint8_t> expected_line(const size_t line, const size_t component_count)
+{
+    vector<uint8_t> pixels;
+    for (size_t component{}; component != component_count; ++component)
+    {
+        pixels.insert(pixels.end(), width, static_cast<uint8_t>(line + component));
+    }
+    return pixels;
+}
+
+
+void decode_lines(pipelined_process_line& pipeline, const size_t line_count, const size_t component_count)
+{
+    for (size_t line{}; line != line_count; ++line)
+    {
+        // The edge pixels between the components should not be passed to the wrapped process_line.
+        vector<uint8_t> source(component_count * stride, 0xFF);
+        for (size_t component{}; component != component_count; ++component)
+        {
+            memset(source.data() + component * stride, static_cast<uint8_t>(line + component), width);
+        }
+
+        pipeline.new_line_decoded(source.data(), width, stride);
+    }
+}
+
+
+void check_decoded_lines(const vector<vector<uint8_t>>& lines, const size_t line_count, const size_t component_count)
+{
+    Assert::AreEqual(line_count, lines.size());
+    for (size_t line{}; line != line_count; ++line)
+    {
+        Assert::IsTrue(expected_line(line, component_count) == lines[line]);
+    }
+}
+
+} // namespace
+
+
+TEST_CLASS(pipelined_process_line_test)
+{
+public:
+    TEST_METHOD(decoded_lines_are_processed_in_order) // NOLINT
+    {
+        vector<vector<uint8_t>> lines;
+        pipelined_process_line pipeline{make_unique<line_recorder>(lines, 1), {width, 100, 8, 1}, interleave_mode::none,
+                                        charls_executor{}};
+
+        decode_lines(pipeline, 100, 1);
+        pipeline.complete();
+
+        check_decoded_lines(lines, 100, 1);
+    }
+
+    TEST_METHOD(decoded_line_interleaved_lines_are_processed_in_order) // NOLINT
+    {
+        vector<vector<uint8_t>> lines;
+        thread_per_task_executor executor;
+        pipelined_process_line pipeline{make_unique<line_recorder>(lines, 3), {width, 50, 8, 3}, interleave_mode::line,
+                                        executor.c_executor()};
+
+        decode_lines(pipeline, 50, 3);
+        pipeline.complete();
+
+        Assert::AreEqual(1, executor.submit_count.load());
+        check_decoded_lines(lines, 50, 3);
+    }
+
+    TEST_METHOD(decoded_lines_are_processed_when_executor_rejects_task) // NOLINT
+    {
+        vector<vector<uint8_t>> lines;
+        deferred_executor executor;
+        executor.reject = true;
+        pipelined_process_line pipeline{make_unique<line_recorder>(lines, 1), {width, 40, 8, 1}, interleave_mode::none,
+                                        executor.c_executor()};
+
+        decode_lines(pipeline, 40, 1);
+        pipeline.complete();
+
+        check_decoded_lines(lines, 40, 1);
+    }
+
+    TEST_METHOD(late_task_returns_directly) // NOLINT
+    {
+        vector<vector<uint8_t>> lines;
+        deferred_executor executor;
+        {
+            pipelined_process_line pipeline{make_unique<line_recorder>(lines, 1), {width, 40, 8, 1},
+                                            interleave_mode::none, executor.c_executor()};
+            decode_lines(pipeline, 40, 1);
+            pipeline.complete();
+        }
+
+        Assert::AreEqual(size_t{1}, executor.tasks.size());
+        executor.execute_tasks(); // The task starts after the pipeline has been destroyed: it should do nothing.
+
+        check_decoded_lines(lines, 40, 1);
+    }
+
+    TEST_METHOD(requested_lines_are_provided_in_order) // NOLINT
+    {
+        vector<vector<uint8_t>> lines;
+        thread_per_task_executor executor;
+        pipelined_process_line pipeline{make_unique<line_recorder>(lines, 3), {width, 60, 8, 3}, interleave_mode::line,
+                                        executor.c_executor()};
+
+        for (size_t line{}; line != 60; ++line)
+        {
+            vector<uint8_t> destination(3 * stride);
+            pipeline.new_line_requested(destination.data(), width, stride);
+
+            for (size_t component{}; component != 3; ++component)
+            {
+                for (size_t i{}; i != width; ++i)
+                {
+                    Assert::AreEqual(static_cast<uint8_t>(line + component), destination[component * stride + i]);
+                }
+            }
+        }
+        pipeline.complete();
+
+        Assert::AreEqual(size_t{60}, lines.size());
+    }
+
+    TEST_METHOD(exception_of_decoding_process_line_is_rethrown) // NOLINT
+    {
+        vector<vector<uint8_t>> lines;
+        pipelined_process_line pipeline{make_unique<line_recorder>(lines, 1, 5), {width, 10, 8, 1}, interleave_mode::none,
+                                        charls_executor{}};
+
+        assert_expect_exception(jpegls_errc::invalid_operation, [&pipeline] {
+            decode_lines(pipeline, 10, 1);
+            pipeline.complete();
+        });
+    }
+
+    TEST_METHOD(exception_of_encoding_process_line_is_rethrown) // NOLINT
+    {
+        vector<vector<uint8_t>> lines;
+        pipelined_process_line pipeline{make_unique<line_recorder>(lines, 1, 5), {width, 10, 8, 1}, interleave_mode::none,
+                                        charls_executor{}};
+
+        assert_expect_exception(jpegls_errc::invalid_operation, [&pipeline] {
+            vector<uint8_t> destination(stride);
+            for (size_t line{}; line != 10; ++line)
+            {
+                pipeline.new_line_requested(destination.data(), width, stride);
+            }
+        });
+    }
+};
+
+}} // namespace charls::test
@@ -0,0 +1,138 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.h"
+
+#include "../src/jpegls_preset_coding_parameters.h"
+#include "../src/pixel_context.h"
+
+#include <random>
+#include <vector>
+
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using std::vector;
+
+namespace charls { namespace test {
+
+namespace {
+
+constexpr size_t pixel_count{64};
+
+int8_t quantize_gradient(const int32_t di, const jpegls_pc_parameters& presets, const int32_t near_lossless) noexcept
+{
+    if (di <= -presets.threshold3)
+        return -4;
+    if (di <= -presets.threshold2)
+        return -3;
+    if (di <= -presets.threshold1)
+        return -2;
+    if (di < -near_lossless)
+        return -1;
+    if (di <= near_lossless)
+        return 0;
+    if (di < presets.threshold1)
+        return 1;
+    if (di < presets.threshold2)
+        return 2;
+    if (di < presets.threshold3)
+        return 3;
+
+    return 4;
+}
+
+
+template<typename Pixel>
+vector<Pixel> create_line(const int32_t maximum_sample_value, std::mt19937& generator)
+{
+    // Mix random pixels with equal neighbours: both run mode and regular mode contexts are computed.
+    MSVC_WARNING_SUPPRESS_NEXT_LINE(26496) // cannot be marked as const as operator() is not always defined const.
+    std::uniform_int_distribution<int32_t> distribution(0, maximum_sample_value);
+
+    // 1 extra pixel before and 2 after the pixels: rc of the first pixel, rd of the last pixel and the padding.
+    vector<Pixel> line(pixel_count + 3);
+    for (size_t i{}; i != line.size(); ++i)
+    {
+        auto* samples{&line[i].v1};
+        for (size_t component{}; component != sizeof(Pixel) / sizeof(*samples); ++component)
+        {
+            samples[component] = static_cast<std::remove_pointer_t<decltype(samples)>>(
+                i % 4 == 0 ? distribution(generator) : maximum_sample_value / 2);
+        }
+    }
+    return line;
+}
+
+
+template<typename Pixel>
+void check_pixel_context(const int32_t maximum_sample_value, const int32_t near_lossless)
+{
+    const jpegls_pc_parameters presets{compute_default(maximum_sample_value, near_lossless)};
+    vector<int8_t> quantization_lut(static_cast<size_t>(maximum_sample_value + 1) * 2);
+    for (size_t i{}; i != quantization_lut.size(); ++i)
+    {
+        quantization_lut[i] =
+            quantize_gradient(static_cast<int32_t>(i) - (maximum_sample_value + 1), presets, near_lossless);
+    }
+
+    std::mt19937 generator(static_cast<uint32_t>(maximum_sample_value + near_lossless));
+    const auto previous_line{create_line<Pixel>(maximum_sample_value, generator)};
+    const auto current_line{create_line<Pixel>(maximum_sample_value, generator)};
+
+    pixel_context_scalar expected{&quantization_lut[static_cast<size_t>(maximum_sample_value) + 1]};
+#ifdef CHARLS_SSE2
+    pixel_context_sse2<std::remove_reference_t<decltype(previous_line[0].v1)>> actual{
+        presets.threshold1, presets.threshold2, presets.threshold3, near_lossless};
+#endif
+
+    size_t run_mode_count{};
+    for (size_t i{}; i != pixel_count; ++i)
+    {
+        const bool run_mode{expected.compute(&current_line[i], &previous_line[i])};
+        run_mode_count += run_mode ? 1 : 0;
+
+#ifdef CHARLS_SSE2
+        Assert::AreEqual(run_mode, actual.compute(&current_line[i], &previous_line[i]));
+        for (size_t component{}; component != sizeof(Pixel) / sizeof(previous_line[0].v1); ++component)
+        {
+            Assert::AreEqual(expected.context_id(component), actual.context_id(component));
+        }
+#endif
+    }
+
+    Assert::IsTrue(run_mode_count > 0);
+}
+
+} // namespace
+
+
+TEST_CLASS(pixel_context_test)
+{
+public:
+    TEST_METHOD(sse2_matches_scalar_8_bit) // NOLINT
+    {
+        check_pixel_context<triplet<uint8_t>>(255, 0);
+        check_pixel_context<quad<uint8_t>>(255, 0);
+        check_pixel_context<triplet<uint8_t>>(255, 3);
+        check_pixel_context<quad<uint8_t>>(255, 3);
+    }
+
+    TEST_METHOD(sse2_matches_scalar_16_bit) // NOLINT
+    {
+        check_pixel_context<triplet<uint16_t>>(4095, 0);
+        check_pixel_context<quad<uint16_t>>(65535, 0);
+        check_pixel_context<triplet<uint16_t>>(65535, 2);
+        check_pixel_context<quad<uint16_t>>(1023, 1);
+    }
+
+    TEST_METHOD(scalar_context_of_equal_neighbours_is_zero) // NOLINT
+    {
+        const vector<int8_t> quantization_lut(3);
+        const vector<triplet<uint8_t>> line(3, triplet<uint8_t>{1, 2, 3});
+        pixel_context_scalar context{&quantization_lut[1]};
+
+        Assert::IsTrue(context.compute(line.data(), line.data()));
+        Assert::AreEqual(0, context.context_id(0));
+    }
+};
+
+}} // namespace charls::test
@@ -0,0 +1,116 @@
+// Copyright (c) Team CharLS.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pch.h"
+
+#include "../src/quantization_lut_cache.h"
+
+#include <array>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+using std::array;
+using std::ignore;
+using std::shared_ptr;
+using std::thread;
+using std::vector;
+
+namespace charls { namespace test {
+
+TEST_CLASS(quantization_lut_cache_test)
+{
+public:
+    TEST_METHOD(get_same_parameters_returns_same_table) // NOLINT
+    {
+        const auto table1{get_quantization_lut(3, 7, 21, 2, 8)};
+        const auto table2{get_quantization_lut(3, 7, 21, 2, 8)};
+
+        Assert::IsTrue(table1 == table2);
+    }
+
+    TEST_METHOD(get_other_parameters_returns_other_table) // NOLINT
+    {
+        const auto table{get_quantization_lut(3, 7, 21, 2, 8)};
+
+        Assert::IsFalse(table == get_quantization_lut(4, 7, 21, 2, 8));
+        Assert::IsFalse(table == get_quantization_lut(3, 8, 21, 2, 8));
+        Assert::IsFalse(table == get_quantization_lut(3, 7, 22, 2, 8));
+        Assert::IsFalse(table == get_quantization_lut(3, 7, 21, 1, 8));
+        Assert::IsFalse(table == get_quantization_lut(3, 7, 21, 2, 10));
+    }
+
+    TEST_METHOD(table_contains_quantized_gradients) // NOLINT
+    {
+        const auto table{get_quantization_lut(3, 7, 21, 1, 8)};
+        const int8_t* quantization{table->center()};
+
+        Assert::AreEqual(int8_t{-4}, quantization[-256]);
+        Assert::AreEqual(int8_t{-4}, quantization[-21]);
+        Assert::AreEqual(int8_t{-3}, quantization[-20]);
+        Assert::AreEqual(int8_t{-3}, quantization[-7]);
+        Assert::AreEqual(int8_t{-2}, quantization[-6]);
+        Assert::AreEqual(int8_t{-2}, quantization[-3]);
+        Assert::AreEqual(int8_t{-1}, quantization[-2]);
+        Assert::AreEqual(int8_t{0}, quantization[-1]);
+        Assert::AreEqual(int8_t{0}, quantization[0]);
+        Assert::AreEqual(int8_t{0}, quantization[1]);
+        Assert::AreEqual(int8_t{1}, quantization[2]);
+        Assert::AreEqual(int8_t{2}, quantization[3]);
+        Assert::AreEqual(int8_t{2}, quantization[6]);
+        Assert::AreEqual(int8_t{3}, quantization[7]);
+        Assert::AreEqual(int8_t{3}, quantization[20]);
+        Assert::AreEqual(int8_t{4}, quantization[21]);
+        Assert::AreEqual(int8_t{4}, quantization[255]);
+    }
+
+    TEST_METHOD(least_recently_used_table_is_removed_when_cache_is_full) // NOLINT
+    {
+        const auto table{get_quantization_lut(5, 9, 25, 0, 4)};
+        for (int32_t i{}; i != static_cast<int32_t>(quantization_lut_cache_capacity); ++i)
+        {
+            ignore = get_quantization_lut(5, 9, 26 + i, 0, 4);
+        }
+
+        const auto new_table{get_quantization_lut(5, 9, 25, 0, 4)};
+
+        // The removed table remains valid while it is referenced.
+        Assert::IsFalse(table == new_table);
+        Assert::AreEqual(int8_t{3}, table->center()[15]);
+    }
+
+    TEST_METHOD(recently_used_table_is_kept_when_cache_is_full) // NOLINT
+    {
+        const auto table{get_quantization_lut(6, 10, 30, 0, 4)};
+        for (int32_t i{}; i != static_cast<int32_t>(quantization_lut_cache_capacity); ++i)
+        {
+            ignore = get_quantization_lut(6, 10, 31 + i, 0, 4);
+            ignore = get_quantization_lut(6, 10, 30, 0, 4);
+        }
+
+        Assert::IsTrue(table == get_quantization_lut(6, 10, 30, 0, 4));
+    }
+
+    TEST_METHOD(get_from_multiple_threads_returns_same_table) // NOLINT
+    {
+        array<shared_ptr<const quantization_lut>, 8> tables;
+        vector<thread> threads;
+
+        for (auto& table : tables)
+        {
+            threads.emplace_back([&table] { table = get_quantization_lut(7, 11, 33, 3, 12); });
+        }
+        for (auto& worker : threads)
+        {
+            worker.join();
+        }
+
+        for (const auto& table : tables)
+        {
+            Assert::IsTrue(table == tables[0]);
+        }
+    }
+};
+
+}} // namespace charls::test
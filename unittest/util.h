@@ -9,6 +9,9 @@
 
 #include <CppUnitTest.h>
 
+#include <atomic>
+#include <thread>
+#include <utility>
 #include <vector>
 
 
@@ -91,6 +94,74 @@ void assert_expect_exception(const jpegls_errc error_value, Functor functor)
 }
 
 
+/// <summary>
+/// Executor that executes every submitted task on a new thread and counts the submitted tasks.
+/// </summary>
+class thread_per_task_executor final : public executor
+{
+public:
+    thread_per_task_executor() = default;
+
+    ~thread_per_task_executor() override
+    {
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    thread_per_task_executor(const thread_per_task_executor&) = delete;
+    thread_per_task_executor(thread_per_task_executor&&) = delete;
+    thread_per_task_executor& operator=(const thread_per_task_executor&) = delete;
+    thread_per_task_executor& operator=(thread_per_task_executor&&) = delete;
+
+    void submit(const executor_task task, void* task_context) override
+    {
+        ++submit_count;
+        threads_.emplace_back(task, task_context);
+    }
+
+    std::atomic<int> submit_count{};
+
+private:
+    std::vector<std::thread> threads_;
+};
+
+
+/// <summary>
+/// Executor that stores the submitted tasks, the test decides when they are executed.
+/// </summary>
+struct deferred_executor final
+{
+    static int32_t CHARLS_API_CALLING_CONVENTION submit(const charls_executor_task task, void* task_context,
+                                                        void* user_context) noexcept
+    {
+        auto* self{static_cast<deferred_executor*>(user_context)};
+        if (self->reject)
+            return 1;
+
+        self->tasks.emplace_back(task, task_context);
+        return 0;
+    }
+
+    void execute_tasks() const
+    {
+        for (const auto& task : tasks)
+        {
+            task.first(task.second);
+        }
+    }
+
+    charls_executor c_executor() noexcept
+    {
+        return {&submit, this};
+    }
+
+    std::vector<std::pair<charls_executor_task, void*>> tasks;
+    bool reject{};
+};
+
+
 }} // namespace charls::test
 
 // ReSharper disable CppInconsistentNaming